@@ -0,0 +1,172 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+benchHarness.cpp implements option parsing and result output for
+the benchmark programs (see benchHarness.h), and counts heap
+allocations by replacing the global operator new
+//============================================================*/
+
+#include "benchHarness.h"
+#include <sstream>
+#include <iomanip>
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+
+using namespace std;
+
+static atomic<long long> allocationCount(0);
+
+// every plain, array, nothrow and sized form of new and delete is replaced, so all allocations are counted and
+// each is freed by the matching free() (std::stable_sort, for one, takes its buffer with nothrow new)
+static void *countedAlloc(size_t n)
+{
+	allocationCount++;
+	return malloc(n > 0 ? n : 1);
+}
+
+void *operator new(size_t n)
+{
+	void *p = countedAlloc(n);
+	if (p == NULL) { throw bad_alloc(); }
+	return p;
+}
+
+void *operator new[](size_t n)
+{
+	void *p = countedAlloc(n);
+	if (p == NULL) { throw bad_alloc(); }
+	return p;
+}
+
+void *operator new(size_t n, const nothrow_t &) noexcept
+{
+	return countedAlloc(n);
+}
+
+void *operator new[](size_t n, const nothrow_t &) noexcept
+{
+	return countedAlloc(n);
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+void operator delete(void *p, const nothrow_t &) noexcept { free(p); }
+void operator delete[](void *p, const nothrow_t &) noexcept { free(p); }
+
+long long benchAllocationCount()
+{
+	return allocationCount;
+}
+
+benchOptions parseBenchOptions(int argc, char **argv)
+{
+	benchOptions opts;
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		bool hasValue = (i + 1 < argc);
+		if (arg == "--quick") { opts.quick = true; opts.layers = 3; }
+		else if (arg == "--reps" && hasValue) { opts.reps = atoi(argv[++i]); }
+		else if (arg == "--seconds" && hasValue) { opts.maxSeconds = atof(argv[++i]); }
+		else if (arg == "--layers" && hasValue) { opts.layers = atoi(argv[++i]); }
+		else if (arg == "--filter" && hasValue) { opts.filter = argv[++i]; }
+		else if (arg == "--work" && hasValue) { opts.workFolder = argv[++i]; }
+		else if (arg == "--out" && hasValue) { opts.outFile = argv[++i]; }
+		else if (arg == "--compare" && hasValue) { opts.compareFile = argv[++i]; }
+		else { cerr << "Ignoring unknown argument " << arg << endl; }
+	}
+	return opts;
+}
+
+// read a result file written by benchReporter; comment lines are skipped
+static vector<benchResult> readBenchResults(const string &fn)
+{
+	vector<benchResult> results;
+	ifstream is(fn.c_str());
+	string line;
+	while (getline(is, line))
+	{
+		if (line.empty() || line[0] == '#') { continue; }
+		istringstream ss(line);
+		benchResult r;
+		double nsPerItem;
+		if (getline(ss, r.suite, '\t') && getline(ss, r.benchmark, '\t') && getline(ss, r.caseName, '\t') &&
+			(ss >> r.items >> r.reps >> r.min_ms >> r.median_ms >> r.mean_ms >> nsPerItem))
+		{
+			results.push_back(r);
+		}
+	}
+	return results;
+}
+
+benchReporter::benchReporter(const benchOptions &opts, const string &suite) : options(opts), suiteName(suite)
+{
+	ostringstream hdr;
+	hdr << "# " << benchFormatVersion << "\n";
+	hdr << "# suite=" << suite << " quick=" << opts.quick << " reps=" << opts.reps << " seconds=" << opts.maxSeconds << " layers=" << opts.layers << "\n";
+	hdr << "# suite\tbenchmark\tcase\titems\treps\tmin_ms\tmedian_ms\tmean_ms\tns_per_item" << (opts.compareFile != "" ? "\tvs_baseline" : "") << "\n";
+	cout << hdr.str();
+	if (opts.outFile != "")
+	{
+		// append, so that benchLayer and benchScan can share one result file
+		out.open(opts.outFile.c_str(), ios::out | ios::app);
+		if (!out.is_open()) { cerr << "Could not open " << opts.outFile << " for writing" << endl; }
+		out << hdr.str();
+	}
+	if (opts.compareFile != "") { baseline = readBenchResults(opts.compareFile); }
+}
+
+bool benchReporter::selected(const string &benchmark, const string &caseName) const
+{
+	return options.filter == "" || (benchmark + "/" + caseName).find(options.filter) != string::npos;
+}
+
+void benchReporter::add(const benchResult &r)
+{
+	ostringstream line;
+	line << fixed << setprecision(4);
+	line << r.suite << "\t" << r.benchmark << "\t" << r.caseName << "\t" << r.items << "\t" << r.reps << "\t"
+		<< r.min_ms << "\t" << r.median_ms << "\t" << r.mean_ms << "\t" << setprecision(1) << (r.items > 0 ? r.median_ms * 1.0e6 / r.items : 0.0);
+	string record = line.str();
+	if (options.compareFile != "")
+	{
+		// ratio of this median to the baseline median; <1 is faster
+		string ratio = "-";
+		for (size_t i = 0; i < baseline.size(); i++)
+		{
+			if (baseline[i].suite == r.suite && baseline[i].benchmark == r.benchmark && baseline[i].caseName == r.caseName && baseline[i].median_ms > 0)
+			{
+				ostringstream rs;
+				rs << fixed << setprecision(3) << r.median_ms / baseline[i].median_ms;
+				ratio = rs.str();
+			}
+		}
+		cout << record << "\t" << ratio << endl;
+	}
+	else
+	{
+		cout << record << endl;
+	}
+	if (out.is_open()) { out << record << "\n"; out.flush(); }
+}
+
+void benchReporter::note(const string &text)
+{
+	cout << "# " << text << endl;
+	if (out.is_open()) { out << "# " << text << "\n"; out.flush(); }
+}
@@ -0,0 +1,129 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+benchHarness.h defines the command-line options, timing loop and
+result format shared by the benchmark programs.
+
+Results are written one per line, tab-separated, in a fixed order:
+	suite  benchmark  case  items  reps  min_ms  median_ms  mean_ms  ns_per_item
+Lines starting with # are comments (format version, options, memory
+and allocation figures).  Two
+result files from different runs can be compared with --compare
+//============================================================*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+
+using namespace std;
+
+// format identifier written at the top of every result file.  Change it if the columns change
+static const string benchFormatVersion = "oasis-bench 1";
+
+// number of heap allocations (operator new calls) made so far by the benchmark program.  benchHarness.cpp
+// replaces the global operator new to count them
+long long benchAllocationCount();
+
+// heap allocations made by one call of fn
+template <typename F>
+long long countAllocations(F fn)
+{
+	long long before = benchAllocationCount();
+	fn();
+	return benchAllocationCount() - before;
+}
+
+// command-line options common to benchLayer and benchScan
+struct benchOptions
+{
+	bool quick = false;				// --quick: small cases and fewer layers only
+	int reps = 5;					// --reps N: maximum repetitions of each micro benchmark
+	double maxSeconds = 2.0;		// --seconds S: stop repeating a benchmark once this much time has been spent (at least one rep is always run)
+	int layers = 10;				// --layers N: layers processed by the macro (whole pipeline) benchmarks
+	string filter = "";				// --filter S: only run benchmarks whose "benchmark/case" name contains S
+	string workFolder = "bench_work";	// --work DIR: folder for generated STL/SVG/XML files, shared by benchLayer and benchScan
+	string outFile = "";			// --out FILE: also write the results to FILE
+	string compareFile = "";		// --compare FILE: print the median time relative to a previous result file
+};
+
+// parse the options above; unknown arguments are reported and ignored
+benchOptions parseBenchOptions(int argc, char **argv);
+
+// timing summary for one benchmark on one case
+struct benchResult
+{
+	string suite;		// program that produced the result (benchLayer, benchScan)
+	string benchmark;	// function or pipeline being timed
+	string caseName;	// benchCase::name()
+	long long items;	// work items per repetition (triangles, edges, layers...), used for ns_per_item
+	int reps;
+	double min_ms;
+	double median_ms;
+	double mean_ms;
+};
+
+// Prints results as they are produced and optionally writes them to a file
+class benchReporter
+{
+public:
+	benchReporter(const benchOptions &opts, const string &suite);
+	// true if the benchmark should run under the current --filter
+	bool selected(const string &benchmark, const string &caseName) const;
+	// time fn (up to opts.reps times, within opts.maxSeconds) and report it.  items is the work done by one call of fn
+	template <typename F>
+	void run(const string &benchmark, const string &caseName, long long items, F fn, int maxReps = -1);
+	// report a result timed elsewhere
+	void add(const benchResult &r);
+	// print a # comment line (e.g. a memory figure) and write it to the result file; --compare ignores it
+	void note(const string &text);
+private:
+	benchOptions options;
+	string suiteName;
+	ofstream out;
+	vector<benchResult> baseline;
+};
+
+template <typename F>
+void benchReporter::run(const string &benchmark, const string &caseName, long long items, F fn, int maxReps)
+{
+	if (!selected(benchmark, caseName)) { return; }
+	if (maxReps < 0) { maxReps = options.reps; }
+	vector<double> samples;
+	double spent = 0;
+	while ((int)samples.size() < max(1, maxReps) && (samples.empty() || spent < options.maxSeconds * 1000.0))
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		fn();
+		double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+		samples.push_back(ms);
+		spent += ms;
+	}
+	sort(samples.begin(), samples.end());
+	benchResult r;
+	r.suite = suiteName;
+	r.benchmark = benchmark;
+	r.caseName = caseName;
+	r.items = items;
+	r.reps = (int)samples.size();
+	r.min_ms = samples.front();
+	r.median_ms = samples[samples.size() / 2];
+	r.mean_ms = spent / samples.size();
+	add(r);
+}
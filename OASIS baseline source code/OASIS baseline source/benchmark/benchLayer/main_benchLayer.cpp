@@ -0,0 +1,310 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+main_benchLayer.cpp benchmarks the layer-generation code of genLayer
+on the synthetic parts from benchShapes, without Slic3r: each case is
+written as binary and ASCII STLs and as a Slic3r-style SVG slice stack.
+
+Micro benchmarks (one call, on the middle layer of each case):
+	findBoundary, findBoundaryASCII, readFile, refineLayer, writeLayer
+	simplifyLayer - simplifying the outlines to 5 um, after splitting
+	each edge into 8 nearly collinear pieces as a finely sliced
+	outline has; a comment line gives the edges before and after
+	refineLayerDense, refineLayerSimplified - refineLayer on the split
+	outlines, and after simplifying them
+	instancedPlate - stampLayer for 25 instances of the layer on a grid
+	vertexMemory - build and copy a layer of 1M vertices; the heap used
+	per vertex is printed as a # comment line
+	allocations - heap allocations made by one call of readFile,
+	stampLayer, refineLayer and writeLayer (# comment line)
+Macro benchmark:
+	layerPipeline - readFile, stampLayer, refineLayer and
+	writeLayer for --layers layers, as in genLayer step 6.  The layer
+	XML files are left in <work>\<case>\LayerFiles\XMLdir, where
+	benchScan picks them up for its end-to-end scanPipeline benchmark.
+	layerPipeline + scanPipeline is the end-to-end layer->scan time
+
+Usage: benchLayer [--quick] [--reps N] [--seconds S] [--layers N]
+		[--filter S] [--work DIR] [--out FILE] [--compare FILE]
+//============================================================*/
+
+#include "SliceFuns.h"
+#include "writeLayerXML.h"
+#include "platform.h"
+#include <iomanip>
+
+#include "constants.h"
+#include "memoryBudget.h"
+#include "benchShapes.h"
+#include "benchHarness.h"
+
+using namespace std;
+
+// layer thickness used to slice the benchmark parts, mm
+static const double benchLayerThickness = 0.03;
+
+// tolerance for simplifyLayer, um.  Its input splits each edge into benchDenseSplits pieces whose inner ends are moved
+// up to benchDenseWobble_um to either side, as the nearly collinear points of a finely sliced outline are
+static const double benchSimplifyTolerance_um = 5.0;
+static const int benchDenseSplits = 8;
+static const double benchDenseWobble_um = 1.0;
+
+// copies of a part on the plate for instancedPlate (a 5x5 grid)
+static const int benchPlateInstances = 25;
+
+// vertexMemory layer: benchMemoryLoops loops of benchMemoryLoopVertices vertices (1M vertices)
+static const int benchMemoryLoops = 1000;
+static const int benchMemoryLoopVertices = 1000;
+
+// layer file name used by genLayer and genScan: layer_ plus the layer number padded to the width of the layer count
+static string layerFileName(int layerNum, int numLayers)
+{
+	string zs;
+	for (int k = 0; k < (int)(to_string(numLayers)).size() - (int)(to_string(layerNum)).size(); k++) { zs = zs + "0"; }
+	return "layer_" + zs + to_string(layerNum) + ".xml";
+}
+
+// clear a genLayer layer structure before re-use
+static void clearLayer(layer &L)
+{
+	L.isEmpty = 1;
+	L.vList.clear();
+	L.us.lpList.clear();
+	L.us.rList.clear();
+	L.ls.lpList.clear();
+	L.ls.rList.clear();
+}
+
+// heap bytes held by the loops of a layer's upper slice (vertex lists, loop records and their strings)
+static size_t layerLoopBytes(const layer &L)
+{
+	size_t bytes = L.us.lpList.capacity() * sizeof(loop);
+	for (size_t i = 0; i < L.us.lpList.size(); i++)
+	{
+		const loop &lp = L.us.lpList[i];
+		bytes += lp.vList.capacity() * sizeof(vertex);
+		if (lp.type.capacity() >= sizeof(string)) { bytes += lp.type.capacity() + 1; }	// short strings are stored in the string object
+		if (lp.tag.capacity() >= sizeof(string)) { bytes += lp.tag.capacity() + 1; }
+	}
+	return bytes;
+}
+
+// copy of a layer's loops with each edge split into benchDenseSplits pieces.  The inner ends of the pieces are moved
+// across the edge by up to benchDenseWobble_um, alternately to each side
+static layer denseLayer(const layer &L)
+{
+	layer Ld = L;
+	double wobble = benchDenseWobble_um / 1000.0;
+	for (size_t i = 0; i < Ld.us.lpList.size(); i++)
+	{
+		const vector<vertex> &vList = L.us.lpList[i].vList;
+		vector<vertex> &dense = Ld.us.lpList[i].vList;
+		dense.clear();
+		dense.reserve(vList.size() * benchDenseSplits);
+		for (size_t k = 0; k < vList.size(); k++)
+		{
+			const vertex &a = vList[k], &b = vList[(k + 1) % vList.size()];
+			double len = sqrt((b.x - a.x)*(b.x - a.x) + (b.y - a.y)*(b.y - a.y));
+			double nx = (len > 0) ? -(b.y - a.y) / len : 0.0, ny = (len > 0) ? (b.x - a.x) / len : 0.0;
+			dense.push_back(a);
+			for (int p = 1; p < benchDenseSplits; p++)
+			{
+				double t = (double)p / benchDenseSplits, w = ((p % 2) ? wobble : -wobble) * ((p % 3) + 1) / 3.0;
+				vertex v;
+				v.x = a.x + t*(b.x - a.x) + w*nx;
+				v.y = a.y + t*(b.y - a.y) + w*ny;
+				v.z = a.z;
+				dense.push_back(v);
+			}
+		}
+	}
+	return Ld;
+}
+
+int main(int argc, char **argv)
+{
+	benchOptions opts = parseBenchOptions(argc, argv);
+	benchReporter reporter(opts, "benchLayer");
+	fs::create_directories(opts.workFolder);
+
+	HRESULT hr = CoInitialize(NULL);	// writeLayer uses the MSXML DOM
+	if (!SUCCEEDED(hr))
+	{
+		cerr << "Could not initialize COM; the XML writer cannot be benchmarked" << endl;
+		return 1;
+	}
+
+	// vertexMemory: a layer of benchMemoryLoops x benchMemoryLoopVertices vertices, stamped from one circular loop
+	// and then copied, as refineLayer copies the slice.  Run first so the resident set is not inflated by the other benchmarks
+	if (reporter.selected("vertexMemory", "1M"))
+	{
+		layer Lsrc;
+		Lsrc.isEmpty = 0;
+		Lsrc.zHeight = benchLayerThickness;
+		Lsrc.us.lpList.resize(1);
+		Lsrc.us.lpList[0].type = "outer";
+		for (int k = 0; k < benchMemoryLoopVertices; k++)
+		{
+			vertex v;
+			v.x = 5.0 * cos(2.0 * benchPi * k / benchMemoryLoopVertices);
+			v.y = 5.0 * sin(2.0 * benchPi * k / benchMemoryLoopVertices);
+			v.z = 0.0;
+			Lsrc.us.lpList[0].vList.push_back(v);
+		}
+		long long numVertices = (long long)benchMemoryLoops * benchMemoryLoopVertices;
+		double rssBeforeMB = workingSetMB();
+		layer Lbig, Lcopy;
+		reporter.run("vertexMemory", "1M", numVertices, [&]() {
+			clearLayer(Lbig);
+			Lbig.us.lpList.shrink_to_fit();
+			for (int n = 0; n < benchMemoryLoops; n++)
+			{
+				stampLayer(&Lbig, Lsrc, "bench", 1, 2, 1.0, (n % 40) * 12.0, (n / 40) * 12.0);
+			}
+			Lcopy = Lbig;
+		});
+		double rssMB = workingSetMB() - rssBeforeMB;	// both copies are still held
+		ostringstream memNote;
+		memNote << fixed << setprecision(1) << "vertexMemory/1M: sizeof(vertex) " << sizeof(vertex) << " bytes, "
+			<< (double)layerLoopBytes(Lbig) / numVertices << " heap bytes per vertex, layer " << layerLoopBytes(Lbig) / 1048576.0
+			<< " MB, resident set +" << rssMB << " MB for the layer and its copy";
+		reporter.note(memNote.str());
+	}
+
+	vector<benchCase> cases = benchCases(opts.quick);
+	for (size_t c = 0; c < cases.size(); c++)
+	{
+		benchCase &bc = cases[c];
+		string caseFolder = opts.workFolder + pathSep + bc.name();
+		string xmlFolder = caseFolder + pathSep + "LayerFiles" + pathSep + "XMLdir";
+		fs::create_directories(xmlFolder);
+
+		// generate the inputs: binary and ASCII STLs for findBoundary and a Slic3r-style SVG for readFile
+		int numLayers = (int)(bc.height_mm / benchLayerThickness);
+		string stlFile = caseFolder + pathSep + bc.name() + ".stl";
+		string asciiStlFile = caseFolder + pathSep + bc.name() + "_ascii.stl";
+		string svgFile = caseFolder + pathSep + bc.name() + ".svg";
+		vector<benchTriangle> mesh = benchMesh(bc);
+		if (!writeBinarySTL(stlFile, mesh) || !writeASCIISTL(asciiStlFile, mesh) || !writeSlic3rSVG(svgFile, bc, benchLayerThickness, numLayers))
+		{
+			cerr << "Could not write the inputs for " << bc.name() << " in " << caseFolder << endl;
+			continue;
+		}
+		int midLayer = numLayers / 2;	// readFile numbers layers from 0
+
+		// findBoundary: bounding box of the STL
+		reporter.run("findBoundary", bc.name(), (long long)mesh.size(), [&]() {
+			vector<vertex> vv = findBoundary(stlFile);
+		});
+		reporter.run("findBoundaryASCII", bc.name(), (long long)mesh.size(), [&]() {
+			vector<vertex> vv = findBoundary(asciiStlFile);
+		});
+
+		// readFile: extract one layer from the SVG slice stack
+		layer L;
+		reporter.run("readFile", bc.name(), (long long)benchPointCount(benchSlice(bc, (midLayer + 0.5) * benchLayerThickness)), [&]() {
+			clearLayer(L);
+			readFile(svgFile, midLayer, &L, "bench", "R", 1, 2);
+		});
+		L.isEmpty = 0;
+		size_t numPoints = 0;
+		for (size_t i = 0; i < L.us.lpList.size(); i++) { numPoints += L.us.lpList[i].vList.size(); }
+
+		// instancedPlate: place benchPlateInstances copies of the layer on a grid, as genLayer step 6a does for instances of a part
+		layer Lplate;
+		reporter.run("instancedPlate", bc.name(), benchPlateInstances, [&]() {
+			clearLayer(Lplate);
+			for (int n = 0; n < benchPlateInstances; n++)
+			{
+				stampLayer(&Lplate, L, "bench", n + 1, n + 1, 1.0, (n % 5) * bc.extent_mm, (n / 5) * bc.extent_mm);
+			}
+		});
+
+		// refineLayer: build the shared vertex list and region edges.  Each rep starts from a copy of the layer as read
+		layer Lr;
+		reporter.run("refineLayer", bc.name(), (long long)numPoints, [&]() {
+			Lr = L;
+			refineLayer(&Lr);
+		});
+		Lr.thickness = benchLayerThickness;
+
+		// simplifyLayer: Douglas-Peucker at benchSimplifyTolerance_um on a densified copy of the layer, which stands in for
+		// Slic3r's output at fine resolution, then refineLayer before and after simplifying
+		layer Ld = denseLayer(L), Ls;
+		size_t densePoints = 0;
+		for (size_t i = 0; i < Ld.us.lpList.size(); i++) { densePoints += Ld.us.lpList[i].vList.size(); }
+		reporter.run("simplifyLayer", bc.name(), (long long)densePoints, [&]() {
+			Ls = Ld;
+			simplifyLayer(&Ls, benchSimplifyTolerance_um / 1000.0);
+		});
+		size_t simplifiedPoints = 0;
+		for (size_t i = 0; i < Ls.us.lpList.size(); i++) { simplifiedPoints += Ls.us.lpList[i].vList.size(); }
+		layer Lrs;
+		reporter.run("refineLayerDense", bc.name(), (long long)densePoints, [&]() {
+			Lrs = Ld;
+			refineLayer(&Lrs);
+		});
+		reporter.run("refineLayerSimplified", bc.name(), (long long)simplifiedPoints, [&]() {
+			Lrs = Ls;
+			refineLayer(&Lrs);
+		});
+		if (reporter.selected("simplifyLayer", bc.name()))
+		{
+			reporter.note("simplifyLayer/" + bc.name() + ": " + to_string(numPoints) + " edges as read, " + to_string(densePoints) + " densified, "
+				+ to_string(simplifiedPoints) + " after simplifying to " + to_string(benchSimplifyTolerance_um) + " um");
+		}
+
+		// writeLayer: the layer XML writer
+		size_t numEdges = 0;
+		for (size_t r = 0; r < Lr.us.rList.size(); r++) { numEdges += Lr.us.rList[r].eList.size(); }
+		string benchXML = caseFolder + pathSep + "layer_bench.xml";
+		reporter.run("writeLayer", bc.name(), (long long)numEdges, [&]() {
+			writeLayer(benchXML, Lr);
+		});
+
+		// allocations: operator new calls for one layer through each stage of the pipeline
+		if (reporter.selected("allocations", bc.name()))
+		{
+			layer La, Lb;
+			long long readAllocs = countAllocations([&]() { readFile(svgFile, midLayer, &La, "bench", "R", 1, 2); });
+			long long stampAllocs = countAllocations([&]() { stampLayer(&Lb, La, "bench", 1, 2, 1.0, 0.0, 0.0); });
+			long long refineAllocs = countAllocations([&]() { refineLayer(&Lb); });
+			Lb.thickness = benchLayerThickness;
+			long long writeAllocs = countAllocations([&]() { writeLayer(benchXML, Lb); });
+			reporter.note("allocations/" + bc.name() + ": readFile " + to_string(readAllocs) + ", stampLayer " + to_string(stampAllocs)
+				+ ", refineLayer " + to_string(refineAllocs) + ", writeLayer " + to_string(writeAllocs)
+				+ ", " + to_string(readAllocs + stampAllocs + refineAllocs + writeAllocs) + " per layer");
+		}
+
+		// layerPipeline: genLayer step 6 for the first --layers layers, leaving XML files for benchScan
+		int pipelineLayers = min(opts.layers, numLayers);
+		reporter.run("layerPipeline", bc.name(), pipelineLayers, [&]() {
+			layer Lp, Lc;
+			for (int i = 1; i <= pipelineLayers; i++)
+			{
+				clearLayer(Lp);
+				readFile(svgFile, i - 1, &Lp, "bench", "R", 1, 2);
+				clearLayer(Lc);
+				stampLayer(&Lc, Lp, "bench", 1, 2, 1.0, 0.0, 0.0);
+				refineLayer(&Lc);
+				Lc.thickness = benchLayerThickness;
+				writeLayer(xmlFolder + pathSep + layerFileName(i, pipelineLayers), Lc);
+			}
+		}, 1);
+	}
+
+	CoUninitialize();
+	return 0;
+}
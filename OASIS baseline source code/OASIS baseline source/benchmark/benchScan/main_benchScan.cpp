@@ -0,0 +1,699 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+main_benchScan.cpp benchmarks the scanpath-generation code of
+genScan on the synthetic parts from benchShapes, using a built-in
+region profile (two contours plus hatching, as in the example
+builds) in place of an Excel configuration file.
+
+Micro benchmarks (one call, on the middle layer of each case):
+	edgeOffset, contour, hatch, hatchOPT, createSCANxmlFile, and
+	traverseDOM when benchLayer has written the case's layer files
+	hatchOPTrefined - hatchOPT with the island tour refined, with a
+	comment line comparing its mark and jump lengths to hatchOPT's
+	hatchFull, hatchClip - hatch and hatchClip over the full extent
+	of the part, with a comment line comparing their marks
+	hatchIslands - island (chessboard) hatching of the part in
+	islands of the default size, with a comment line comparing its
+	marks to hatchClip's
+	hatchStripes - stripe hatching of the part in stripes of the
+	default width, with a comment line giving its marks and the
+	longest of them
+	scan2SVG - the SVG preview of the layer's scanpaths, per segment,
+	with the file size and number of marks as a comment line
+	scanTime - the scan time estimate for the layer's scanpaths,
+	per segment, with the estimate as a comment line
+	laserSchedule - sharing each region's contours and hatch, as the
+	paths of one concurrent trajectory, between two lasers whose
+	fields overlap across the middle of the part; items are paths.
+	A comment line gives the layer estimate on one laser and after
+	scheduling
+	orderTour - ordering the layer's outer contour rings, and choosing
+	where each is entered, to shorten the jumps between them; items
+	are rings.  A comment line gives the jump length before and after
+	findHatchBoundary, hatchBoundary - the hatch-line range for each
+	region of the layer hatched on its own: projecting the whole
+	layer for every region, as genScan did, against one
+	hatchBoundaryCache for the layer; items are regions.  A comment
+	line gives the hatch lines crossed with each range and whether
+	hatch draws the same marks
+	identifyTrajectories - grouping the regions of the middle layer,
+	copied benchTrajectoryCopies times as parts with trajectories of
+	their own, by trajectory, type and tag; items are regions
+	orderPathGroups - ordering the contour and hatch groups of
+	benchGroupTags tagged copies of the layer in one trajectory,
+	starting on a hatch; items are groups.  A comment line gives the
+	jump length before and after and whether any tag's hatch came
+	ahead of its contours, which makes benchScan exit with an error
+	findIntersection, findIntersections - the hatch offset edges
+	against every hatch line across the layer, one edge per call
+	and with the batch kernel; items are edge/line tests.  A comment
+	line reports whether both found the same intersections
+	allocations - heap allocations made by one call of traverseDOM,
+	trajectory grouping with contour and hatch generation, and
+	createSCANxmlFile (# comment line)
+Macro benchmark:
+	scanPipeline - loadDOM, traverseDOM, trajectory grouping, contour
+	and hatch generation and createSCANxmlFile for each layer file
+	written by benchLayer's layerPipeline (run benchLayer first with
+	the same --work folder).  Cases without layer files are skipped
+
+Usage: benchScan [--quick] [--reps N] [--seconds S] [--layers N]
+		[--filter S] [--work DIR] [--out FILE] [--compare FILE]
+//============================================================*/
+
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include "ScanPath.h"
+#include "readLayerXML.h"
+#include "writeScanXML.h"
+#include "scanTime.h"
+#include "laserSchedule.h"
+#include "pathOrder.h"
+#include "islandHatch.h"
+#include "platform.h"
+
+#include "constants.h"
+#include "benchShapes.h"
+#include "benchHarness.h"
+
+using namespace std;
+
+//MSXML objects to read LAYER and write SCAN files
+IXMLDOMDocument *pXMLDomLayer = NULL;
+IXMLDOMDocument *pXMLDomScan = NULL;
+
+// layer thickness used for the benchmark parts, mm.  Must match benchLayer
+static const double benchLayerThickness = 0.03;
+static const int benchTrajectoryCopies = 40;	// copies of the middle layer's regions, each a part with its own trajectories, for identifyTrajectories
+static const int benchGroupTags = 4;			// tagged copies of the middle layer's regions sharing one trajectory, for orderPathGroups
+
+// configuration equivalent to a single "Main" region profile from the example builds
+static AMconfig benchConfig()
+{
+	AMconfig config;
+	config.layerThickness_mm = benchLayerThickness;
+	config.outputIntegerIDs = true;
+
+	velocityProfile vp;
+	vp.ID = "jump"; vp.integerID = 1; vp.velocity = 5000; vp.laserOnDelay = 500;
+	config.VPlist.push_back(vp);
+	vp = velocityProfile();
+	vp.ID = "hatch"; vp.integerID = 2; vp.velocity = 500; vp.laserOnDelay = 250; vp.jumpDelay = 400; vp.markDelay = 300;
+	config.VPlist.push_back(vp);
+	vp = velocityProfile();
+	vp.ID = "contour"; vp.integerID = 3; vp.velocity = 250; vp.mode = "Auto";
+	config.VPlist.push_back(vp);
+
+	segmentStyle ss;
+	ss.ID = "Contour1"; ss.integerID = 1; ss.vpID = "contour"; ss.vpIntID = 3; ss.laserMode = "Independent";
+	ss.leadLaser.travelerID = "1"; ss.leadLaser.power = 250;
+	config.segmentStyleList.push_back(ss);
+	ss.ID = "Hatch1"; ss.integerID = 2; ss.vpID = "hatch"; ss.vpIntID = 2;
+	ss.leadLaser.power = 300;
+	config.segmentStyleList.push_back(ss);
+	ss = segmentStyle();
+	ss.ID = "Auto-generated3"; ss.integerID = 3; ss.vpID = "jump"; ss.vpIntID = 1;	// jump style, as created by readRegionProfiles
+	config.segmentStyleList.push_back(ss);
+
+	regionProfile rp;
+	rp.Tag = "bench";
+	rp.vIDJump = "jump"; rp.jumpStyleID = "Auto-generated3"; rp.jumpStyleIntID = 3;
+	rp.contourStyleID = "Contour1"; rp.contourStyleIntID = 1; rp.numCntr = 2; rp.offCntr = 0.0; rp.resCntr = 0.1;
+	rp.hatchStyleID = "Hatch1"; rp.hatchStyleIntID = 2; rp.offHatch = 0.05; rp.resHatch = 0.1; rp.scHatch = 1;
+	rp.layer1hatchAngle = 0.0; rp.hatchLayerRotation = 67.0;
+	config.regionProfileList.push_back(rp);
+
+	trajectoryProc tp;
+	tp.trajectoryNum = 1;	// contours
+	config.trajProcList.push_back(tp);
+	tp.trajectoryNum = 2;	// hatches
+	config.trajProcList.push_back(tp);
+	return config;
+}
+
+// convert a cross-section into the genScan layer structure, as traverseDOM would produce it
+static layer scanLayerFromLoops(const vector<benchLoop> &loops)
+{
+	layer L;
+	L.thickness = benchLayerThickness;
+	for (size_t i = 0; i < loops.size(); i++)
+	{
+		region r;
+		r.type = loops[i].isOuter ? "Outer" : "Inner";
+		r.tag = "bench";
+		r.contourTraj = 1;
+		r.hatchTraj = 2;
+		size_t n = loops[i].pts.size();
+		for (size_t p = 0; p < n; p++)
+		{
+			edge e;
+			e.s.x = loops[i].pts[p].x;				e.s.y = loops[i].pts[p].y;
+			e.f.x = loops[i].pts[(p + 1) % n].x;	e.f.y = loops[i].pts[(p + 1) % n].y;
+			r.eList.push_back(e);
+			L.vList.push_back(e.s);
+		}
+		L.s.rList.push_back(r);
+	}
+	return L;
+}
+
+// hatch angle for a layer, as computed in genScan
+static double layerHatchAngle(const regionProfile &rp, int layerNum)
+{
+	return fmod(fmod(rp.layer1hatchAngle + (layerNum - 1)*rp.hatchLayerRotation, 360.0) + 360.0, 360.0);
+}
+
+// Range of hatch-line intercepts spanned by the vertices of layer L at hatchAngle (the a_min/a_max expected by hatch()),
+// taken from the vertices directly so that the hatch benchmarks cover the whole part
+static void hatchRange(const layer &L, double hatchAngle, double *a_min, double *a_max, double *hatchFunctionValue)
+{
+	double hatchAngle_rads = hatchAngle * 3.14159265358979323846 / 180;
+	bool yIntercept = ((((int)hatchAngle + 315) % 180) > 90);
+	*hatchFunctionValue = yIntercept ? tan(hatchAngle_rads) : cos(hatchAngle_rads) / sin(hatchAngle_rads);
+	*a_min = 1e300;
+	*a_max = -1e300;
+	for (const vertex &v : L.vList)
+	{
+		double a = yIntercept ? (v.y - v.x * (*hatchFunctionValue)) : (v.x - v.y * (*hatchFunctionValue));
+		*a_min = min(*a_min, a);
+		*a_max = max(*a_max, a);
+	}
+}
+
+// Intercepts of all hatch lines across layer L at hatchAngle, spaced as hatch() spaces them
+static vector<double> hatchIntercepts(const layer &L, const regionProfile &rp, double hatchAngle, double *hatchFunctionValue)
+{
+	double hatchAngle_rads = hatchAngle * 3.14159265358979323846 / 180;
+	bool yIntercept = ((((int)hatchAngle + 315) % 180) > 90);
+	double hSpace = fabs(rp.resHatch / (yIntercept ? cos(hatchAngle_rads) : sin(hatchAngle_rads)));
+	double a_min, a_max;
+	hatchRange(L, hatchAngle, &a_min, &a_max, hatchFunctionValue);
+	vector<double> intercepts;
+	for (double a = a_min + hSpace; a < a_max; a += hSpace) { intercepts.push_back(a); }
+	return intercepts;
+}
+
+// Number of marks and their total length in mm
+static void markTotals(const path &p, size_t *numMarks, double *markLength)
+{
+	*numMarks = 0;
+	*markLength = 0.0;
+	for (const segment &sg : p.vecSg)
+	{
+		if (sg.isMark == 1) { (*numMarks)++; *markLength += sqrt(pow(sg.end.x - sg.start.x, 2) + pow(sg.end.y - sg.start.y, 2)); }
+	}
+}
+
+// Generate the scan paths for a layer the way genScan does: group the regions of each trajectory by type and tag,
+// then contour or hatch each group
+static vector<trajectory> scanLayer(AMconfig &config, layer &L, int layerNum)
+{
+	vector<vertex> BB = getBB(L);
+	hatchBoundaryCache hatchBoundaries;
+	vector<trajectory> tl = identifyTrajectories(config, L, layerNum);
+	sort(tl.begin(), tl.end(), [](const trajectory &a, const trajectory &b) { return a.trajectoryNum < b.trajectoryNum; });
+	for (size_t t = 0; t < tl.size(); t++)
+	{
+		for (size_t g = 0; g < tl[t].regionGroups.size(); g++)
+		{
+			const regionGroup &group = tl[t].regionGroups[g];
+			const vector<int> &regionsWithinPath = group.regions;
+			regionProfile &rp = config.regionProfileList[0];	// the benchmark uses a single region profile
+			path tempPath;
+			if (group.type == regionType::contour && rp.contourStyleID != "" && rp.numCntr > 0)
+			{
+				for (int n = 0; n < rp.numCntr; n++)
+				{
+					tempPath = contour(L, regionsWithinPath, rp, n*rp.resCntr + rp.offCntr, BB, config.outputIntegerIDs);
+					if (tempPath.vecSg.size() > 0) { tl[t].vecPath.push_back(move(tempPath)); }
+				}
+			}
+			if (group.type == regionType::hatch && rp.hatchStyleID != "" && rp.resHatch > 0)
+			{
+				double hatchAngle = layerHatchAngle(rp, layerNum), a_min = 0.0, a_max = 0.0;
+				double fullHatchOffset = rp.offHatch + rp.offCntr + (max(0, rp.numCntr - 1)*rp.resCntr);
+				hatchBoundaries.hatchBoundary(L, regionsWithinPath, hatchAngle, rp.resHatch, fullHatchOffset, &a_min, &a_max);
+				if ((rp.scHatch == 1) || (rp.scHatch == 3)) { tempPath = hatchOPT(L, regionsWithinPath, rp, fullHatchOffset, hatchAngle, a_min, a_max, config.outputIntegerIDs, BB, rp.scHatch == 3); }
+				else if (rp.scHatch == 2) { tempPath = hatchClip(L, regionsWithinPath, rp, fullHatchOffset, hatchAngle, a_min, a_max, config.outputIntegerIDs, BB); }
+				else if (rp.scHatch == 4) { tempPath = hatchIslands(L, regionsWithinPath, rp, fullHatchOffset, hatchAngle, layerNum, config.outputIntegerIDs); }
+				else if (rp.scHatch == 5) { tempPath = hatchStripes(L, regionsWithinPath, rp, fullHatchOffset, hatchAngle, config.outputIntegerIDs); }
+				else { tempPath = hatch(L, regionsWithinPath, rp, fullHatchOffset, hatchAngle, a_min, a_max, config.outputIntegerIDs, BB); }
+				if (tempPath.vecSg.size() > 0) { tl[t].vecPath.push_back(move(tempPath)); }
+			}
+		}
+	}
+	return tl;
+}
+
+// load a layer XML file into L.  Returns false if the file could not be loaded
+static bool readLayerFile(const string &fn, layer &L)
+{
+	wstring wfn(fn.begin(), fn.end());
+	if (loadDOM(wfn.c_str()) != 0) { return false; }
+	L = traverseDOM();
+	return true;
+}
+
+// layer file name used by genLayer and genScan: layer_ plus the layer number padded to the width of the layer count
+static string layerFileName(int layerNum, int numLayers)
+{
+	string zs;
+	for (int k = 0; k < (int)(to_string(numLayers)).size() - (int)(to_string(layerNum)).size(); k++) { zs = zs + "0"; }
+	return "layer_" + zs + to_string(layerNum) + ".xml";
+}
+
+int main(int argc, char **argv)
+{
+	benchOptions opts = parseBenchOptions(argc, argv);
+	benchReporter reporter(opts, "benchScan");
+	fs::create_directories(opts.workFolder);
+	AMconfig config = benchConfig();
+
+	HRESULT hr = CoInitialize(NULL);	// the layer reader and scan writer use the MSXML DOM
+	if (!SUCCEEDED(hr))
+	{
+		cerr << "Could not initialize COM; the XML reader and writer cannot be benchmarked" << endl;
+		return 1;
+	}
+
+	bool checksFailed = false;
+	vector<benchCase> cases = benchCases(opts.quick);
+	for (size_t c = 0; c < cases.size(); c++)
+	{
+		benchCase &bc = cases[c];
+		string caseFolder = opts.workFolder + pathSep + bc.name();
+		fs::create_directories(caseFolder + pathSep + "ScanFiles");
+		int numLayers = (int)(bc.height_mm / benchLayerThickness);
+		int midLayer = numLayers / 2 + 1;	// genScan numbers layers from 1
+
+		layer L = scanLayerFromLoops(benchSlice(bc, (midLayer - 0.5) * benchLayerThickness));
+		vector<int> allRegions;
+		size_t numEdges = 0;
+		for (size_t r = 0; r < L.s.rList.size(); r++) { allRegions.push_back((int)r); numEdges += L.s.rList[r].eList.size(); }
+		vector<vertex> BB = getBB(L);
+		regionProfile rp = config.regionProfileList[0];
+		double hatchAngle = layerHatchAngle(rp, midLayer), a_min = 0.0, a_max = 0.0;
+		findHatchBoundary(L.vList, hatchAngle, &a_min, &a_max);
+		double fullHatchOffset = rp.offHatch + rp.offCntr + (max(0, rp.numCntr - 1)*rp.resCntr);
+
+		reporter.run("edgeOffset", bc.name(), (long long)numEdges, [&]() {
+			vector<edge> edgeListOut;
+			vector<vector<edge>> polyVectorsOut;
+			edgeOffset(L, allRegions, edgeListOut, polyVectorsOut, fullHatchOffset, true);
+		});
+		reporter.run("contour", bc.name(), (long long)numEdges, [&]() {
+			path p = contour(L, allRegions, rp, rp.offCntr, BB, config.outputIntegerIDs);
+		});
+		reporter.run("hatch", bc.name(), (long long)numEdges, [&]() {
+			path p = hatch(L, allRegions, rp, fullHatchOffset, hatchAngle, a_min, a_max, config.outputIntegerIDs, BB);
+		});
+		reporter.run("hatchOPT", bc.name(), (long long)numEdges, [&]() {
+			path p = hatchOPT(L, allRegions, rp, fullHatchOffset, hatchAngle, a_min, a_max, config.outputIntegerIDs, BB);
+		});
+		reporter.run("hatchOPTrefined", bc.name(), (long long)numEdges, [&]() {
+			path p = hatchOPT(L, allRegions, rp, fullHatchOffset, hatchAngle, a_min, a_max, config.outputIntegerIDs, BB, true);
+		});
+		if (reporter.selected("hatchOPTrefined", bc.name()))
+		{
+			scanTimeEstimator hatchTimer(config);
+			scanTimeEstimate chained = hatchTimer.pathTime(hatchOPT(L, allRegions, rp, fullHatchOffset, hatchAngle, a_min, a_max, config.outputIntegerIDs, BB));
+			scanTimeEstimate refined = hatchTimer.pathTime(hatchOPT(L, allRegions, rp, fullHatchOffset, hatchAngle, a_min, a_max, config.outputIntegerIDs, BB, true));
+			reporter.note("hatchOPTrefined/" + bc.name() + ": hatchOPT " + to_string(chained.markLength) + " mm marks, " + to_string(chained.jumpLength)
+				+ " mm jumps; refined " + to_string(refined.markLength) + " mm marks, " + to_string(refined.jumpLength) + " mm jumps");
+		}
+
+		// hatch against hatchClip across the whole part, with the range taken from the vertices directly
+		double partMin, partMax, partFunctionValue;
+		hatchRange(L, hatchAngle, &partMin, &partMax, &partFunctionValue);
+		reporter.run("hatchClip", bc.name(), (long long)numEdges, [&]() {
+			path p = hatchClip(L, allRegions, rp, fullHatchOffset, hatchAngle, partMin, partMax, config.outputIntegerIDs, BB);
+		});
+		reporter.run("hatchFull", bc.name(), (long long)numEdges, [&]() {
+			path p = hatch(L, allRegions, rp, fullHatchOffset, hatchAngle, partMin, partMax, config.outputIntegerIDs, BB);
+		});
+		if (reporter.selected("hatchClip", bc.name()))
+		{
+			size_t hatchMarks, clipMarks;
+			double hatchLength, clipLength;
+			markTotals(hatch(L, allRegions, rp, fullHatchOffset, hatchAngle, partMin, partMax, config.outputIntegerIDs, BB), &hatchMarks, &hatchLength);
+			markTotals(hatchClip(L, allRegions, rp, fullHatchOffset, hatchAngle, partMin, partMax, config.outputIntegerIDs, BB), &clipMarks, &clipLength);
+			reporter.note("hatchClip/" + bc.name() + ": hatch " + to_string(hatchMarks) + " marks, " + to_string(hatchLength) + " mm; hatchClip "
+				+ to_string(clipMarks) + " marks, " + to_string(clipLength) + " mm");
+		}
+		reporter.run("hatchIslands", bc.name(), (long long)numEdges, [&]() {
+			path p = hatchIslands(L, allRegions, rp, fullHatchOffset, hatchAngle, midLayer, config.outputIntegerIDs);
+		});
+		if (reporter.selected("hatchIslands", bc.name()))
+		{
+			size_t clipMarks, islandMarks;
+			double clipLength, islandLength;
+			markTotals(hatchClip(L, allRegions, rp, fullHatchOffset, hatchAngle, partMin, partMax, config.outputIntegerIDs, BB), &clipMarks, &clipLength);
+			markTotals(hatchIslands(L, allRegions, rp, fullHatchOffset, hatchAngle, midLayer, config.outputIntegerIDs), &islandMarks, &islandLength);
+			reporter.note("hatchIslands/" + bc.name() + ": hatchClip " + to_string(clipMarks) + " marks, " + to_string(clipLength) + " mm; hatchIslands "
+				+ to_string(islandMarks) + " marks, " + to_string(islandLength) + " mm on up to " + to_string(max(1u, thread::hardware_concurrency())) + " threads");
+		}
+		reporter.run("hatchStripes", bc.name(), (long long)numEdges, [&]() {
+			path p = hatchStripes(L, allRegions, rp, fullHatchOffset, hatchAngle, config.outputIntegerIDs);
+		});
+		if (reporter.selected("hatchStripes", bc.name()))
+		{
+			path stripes = hatchStripes(L, allRegions, rp, fullHatchOffset, hatchAngle, config.outputIntegerIDs);
+			size_t stripeMarks;
+			double stripeLength, longestMark = 0.0;
+			markTotals(stripes, &stripeMarks, &stripeLength);
+			for (size_t g = 0; g < stripes.vecSg.size(); g++)
+			{
+				const segment &sg = stripes.vecSg[g];
+				if (sg.isMark) { longestMark = max(longestMark, sqrt((sg.end.x - sg.start.x)*(sg.end.x - sg.start.x) + (sg.end.y - sg.start.y)*(sg.end.y - sg.start.y))); }
+			}
+			reporter.note("hatchStripes/" + bc.name() + ": " + to_string(stripeMarks) + " marks, " + to_string(stripeLength) + " mm, longest "
+				+ to_string(longestMark) + " mm in stripes of " + to_string(defaultStripeWidth) + " mm");
+		}
+
+		// contour ring ordering, as contour() does it for the outer contour
+		vector<edge> unusedEdges;
+		vector<vector<edge>> rings;
+		edgeOffset(L, allRegions, unusedEdges, rings, rp.offCntr, true);
+		vector<tourStop> ringStops;
+		for (size_t r = 0; r < rings.size(); r++)
+		{
+			if (rings[r].empty()) { continue; }
+			tourStop stop;
+			stop.closed = true;
+			for (size_t e = 0; e < rings[r].size(); e++) { stop.entries.push_back(rings[r][e].s); }
+			ringStops.push_back(move(stop));
+		}
+		if (ringStops.size() > 1)
+		{
+			tourOrder ringOrder;
+			reporter.run("orderTour", bc.name(), (long long)ringStops.size(), [&]() {
+				ringOrder = orderTour(ringStops, ringStops[0].entries[0], pathOrderBudget_ms, pathOrderMaxPasses);
+			});
+			if (reporter.selected("orderTour", bc.name()))
+			{
+				reporter.note("orderTour/" + bc.name() + ": " + to_string(ringStops.size()) + " rings, jumps " + to_string(ringOrder.jumpBefore) + " mm as given, "
+					+ to_string(ringOrder.jumpAfter) + " mm ordered");
+			}
+		}
+
+		// hatch-line range for each region hatched on its own: the whole layer projected per region, as genScan did, or cached per layer
+		reporter.run("findHatchBoundary", bc.name(), (long long)L.s.rList.size(), [&]() {
+			double lo, hi;
+			for (size_t r = 0; r < L.s.rList.size(); r++) { findHatchBoundary(L.vList, hatchAngle, &lo, &hi); }
+		});
+		reporter.run("hatchBoundary", bc.name(), (long long)L.s.rList.size(), [&]() {
+			hatchBoundaryCache cache;
+			vector<int> oneRegion(1);
+			double lo, hi;
+			for (size_t r = 0; r < L.s.rList.size(); r++) { oneRegion[0] = (int)r; cache.hatchBoundary(L, oneRegion, hatchAngle, rp.resHatch, fullHatchOffset, &lo, &hi); }
+		});
+		if (reporter.selected("hatchBoundary", bc.name()))
+		{
+			hatchBoundaryCache cache;
+			double hatchAngle_rads = hatchAngle * 3.14159265358979323846 / 180;
+			double hSpace = fabs(rp.resHatch / ((((int)hatchAngle + 315) % 180) > 90 ? cos(hatchAngle_rads) : sin(hatchAngle_rads)));	// as in hatchIntercepts
+			double layerLines = 0.0, groupLines = 0.0;
+			size_t layerMarks = 0, groupMarks = 0, n;
+			double length;
+			bool same = true;
+			for (size_t r = 0; r < L.s.rList.size(); r++)
+			{
+				vector<int> oneRegion(1, (int)r);
+				double lo, hi;
+				cache.hatchBoundary(L, oneRegion, hatchAngle, rp.resHatch, fullHatchOffset, &lo, &hi);
+				layerLines += (a_max - a_min) / hSpace;
+				groupLines += (hi - lo) / hSpace;
+				path layerPath = hatch(L, oneRegion, rp, fullHatchOffset, hatchAngle, a_min, a_max, config.outputIntegerIDs, BB);
+				path groupPath = hatch(L, oneRegion, rp, fullHatchOffset, hatchAngle, lo, hi, config.outputIntegerIDs, BB);
+				markTotals(layerPath, &n, &length);
+				layerMarks += n;
+				markTotals(groupPath, &n, &length);
+				groupMarks += n;
+				same = same && (layerPath.vecSg.size() == groupPath.vecSg.size());
+				for (size_t g = 0; same && g < layerPath.vecSg.size(); g++) {
+					same = (layerPath.vecSg[g].start.x == groupPath.vecSg[g].start.x) && (layerPath.vecSg[g].start.y == groupPath.vecSg[g].start.y);
+				}
+			}
+			reporter.note("hatchBoundary/" + bc.name() + ": " + to_string(L.s.rList.size()) + " regions cross " + to_string((long long)layerLines) + " hatch lines with the layer's range, "
+				+ to_string((long long)groupLines) + " with their own; " + to_string(groupMarks) + " marks, " + (same ? "identical to" : "DIFFERENT from") + " the layer's range");
+		}
+
+		// trajectory and group identification for a plate of many parts
+		layer parts;
+		for (int copy = 0; copy < benchTrajectoryCopies; copy++)
+		{
+			for (size_t r = 0; r < L.s.rList.size(); r++)
+			{
+				parts.s.rList.push_back(L.s.rList[r]);
+				parts.s.rList.back().contourTraj = 2 * copy + 1;
+				parts.s.rList.back().hatchTraj = 2 * copy + 2;
+			}
+		}
+		reporter.run("identifyTrajectories", bc.name(), (long long)parts.s.rList.size(), [&]() {
+			vector<trajectory> tl = identifyTrajectories(config, parts, midLayer);
+		});
+
+		// region group ordering with the contours and hatch of several tags in one trajectory.  The scanner starts on the
+		// first hatch, so a tour free to choose would begin there, ahead of that tag's contours
+		layer tagged = L;
+		tagged.s.rList.clear();
+		for (int copy = 0; copy < benchGroupTags; copy++)
+		{
+			for (size_t r = 0; r < L.s.rList.size(); r++)
+			{
+				tagged.s.rList.push_back(L.s.rList[r]);
+				tagged.s.rList.back().tag = "part" + to_string(copy);
+				tagged.s.rList.back().contourTraj = 1;
+				tagged.s.rList.back().hatchTraj = 1;
+			}
+		}
+		vector<trajectory> taggedTraj = identifyTrajectories(config, tagged, midLayer);
+		vector<path> groupPaths;
+		vector<size_t> groupStarts;
+		vector<int> groupAfter;
+		map<string, int> contourGroupOf;
+		for (const regionGroup &group : taggedTraj[0].regionGroups)
+		{
+			auto contourGroup = contourGroupOf.find(group.tag);
+			groupAfter.push_back(((group.type == regionType::hatch) && (contourGroup != contourGroupOf.end())) ? contourGroup->second : -1);
+			if (group.type == regionType::contour) { contourGroupOf[group.tag] = (int)groupStarts.size(); }
+			groupStarts.push_back(groupPaths.size());
+			path p = (group.type == regionType::contour) ? contour(tagged, group.regions, rp, rp.offCntr, BB, config.outputIntegerIDs)
+				: hatch(tagged, group.regions, rp, fullHatchOffset, hatchAngle, a_min, a_max, config.outputIntegerIDs, BB);
+			p.tag = group.tag;
+			if (p.vecSg.size() > 0) { groupPaths.push_back(move(p)); }
+		}
+		vertex hatchStart;
+		for (const path &p : groupPaths) { if (p.type == "hatch") { hatchStart = p.vecSg.front().start; break; } }
+		reporter.run("orderPathGroups", bc.name(), (long long)groupStarts.size(), [&]() {
+			vector<path> paths = groupPaths;
+			orderPathGroups(paths, groupStarts, groupAfter, hatchStart, true);
+		});
+		if (reporter.selected("orderPathGroups", bc.name()))
+		{
+			vector<path> paths = groupPaths;
+			takePathOrderTotals();
+			orderPathGroups(paths, groupStarts, groupAfter, hatchStart, true);
+			pathOrderTotals jumps = takePathOrderTotals();
+			set<string> contoured;
+			bool flipped = false;
+			for (const path &p : paths)
+			{
+				if (p.type == "contour") { contoured.insert(p.tag); }
+				else if (contoured.count(p.tag) == 0) { flipped = true; }
+			}
+			checksFailed = checksFailed || flipped;
+			reporter.note("orderPathGroups/" + bc.name() + ": " + to_string(groupStarts.size()) + " groups, jumps " + to_string(jumps.jumpBefore) + " mm as given, "
+				+ to_string(jumps.jumpAfter) + " mm ordered; " + (flipped ? "a hatch was MOVED AHEAD of its contours" : "every hatch follows its contours"));
+		}
+
+		// hatch/edge intersection over every hatch line of the layer: one findIntersection call per edge against the batch kernel
+		vector<edge> offsetEdges;
+		vector<vector<edge>> unusedPolys;
+		edgeOffset(L, allRegions, offsetEdges, unusedPolys, fullHatchOffset, false);
+		double hatchFunctionValue = 0.0;
+		vector<double> intercepts = hatchIntercepts(L, rp, hatchAngle, &hatchFunctionValue);
+		long long numTests = (long long)(offsetEdges.size() * intercepts.size());
+		auto scalarPass = [&](vector<vertex> &hitsOut) {
+			for (double a : intercepts)
+				for (const edge &e : offsetEdges) {
+					vertex is;
+					if (findIntersection(&is, hatchAngle, BB, a, e, hatchFunctionValue) == 0) { hitsOut.push_back(is); }
+				}
+		};
+		auto batchPass = [&](vector<vertex> &hitsOut) {
+			edgeBlock block;
+			arenaVector<vertex> hits;
+			makeEdgeBlock(offsetEdges, block);
+			for (double a : intercepts) {
+				hits.clear();
+				findIntersections(makeHatchLine(hatchAngle, BB, a, hatchFunctionValue), block, hits);
+				hitsOut.insert(hitsOut.end(), hits.begin(), hits.end());
+			}
+		};
+		vector<vertex> scalarHits, batchHits;
+		reporter.run("findIntersection", bc.name(), numTests, [&]() { scalarHits.clear(); scalarPass(scalarHits); });
+		reporter.run("findIntersections", bc.name(), numTests, [&]() { batchHits.clear(); batchPass(batchHits); });
+		if (reporter.selected("findIntersections", bc.name()))
+		{
+			scalarHits.clear(); scalarPass(scalarHits);
+			batchHits.clear(); batchPass(batchHits);
+			bool same = (scalarHits.size() == batchHits.size());
+			for (size_t i = 0; same && i < scalarHits.size(); i++) {
+				same = (batchHits[i].x == scalarHits[i].x) && (batchHits[i].y == scalarHits[i].y);
+			}
+			reporter.note("findIntersections/" + bc.name() + ": " + to_string(intercepts.size()) + " hatch lines x " + to_string(offsetEdges.size())
+				+ " edges, " + to_string(scalarHits.size()) + " intersections, " + (same ? "identical to" : "DIFFERENT from") + " findIntersection");
+		}
+
+		// the scan XML writer, on the complete set of paths for this layer
+		vector<trajectory> trajectoryList = scanLayer(config, L, midLayer);
+		size_t numSegments = 0;
+		for (size_t t = 0; t < trajectoryList.size(); t++)
+			for (size_t p = 0; p < trajectoryList[t].vecPath.size(); p++) { numSegments += trajectoryList[t].vecPath[p].vecSg.size(); }
+		scanTimeEstimator scanTimer(config);
+		scanTimeEstimate layerEstimate;
+		reporter.run("scanTime", bc.name(), (long long)numSegments, [&]() {
+			layerEstimate = scanTimer.layerTime(trajectoryList);
+		});
+		if (reporter.selected("scanTime", bc.name()))
+		{
+			reporter.note("scanTime/" + bc.name() + ": " + scanTimeComment(midLayer, layerEstimate, midLayer, layerEstimate));
+		}
+
+		// laser scheduling: every region's paths in one concurrent trajectory, on a plate split between lasers "1" and "2"
+		if (L.vList.size() > 0)
+		{
+			double minX = L.vList[0].x, maxX = L.vList[0].x;
+			for (size_t v = 1; v < L.vList.size(); v++) { minX = min(minX, L.vList[v].x); maxX = max(maxX, L.vList[v].x); }
+			double midX = 0.5 * (minX + maxX), overlap = 0.25 * (maxX - minX);
+			AMconfig laserConfig = config;
+			laserField laser;
+			laser.laserID = "1"; laser.xMin = minX - 1.0; laser.xMax = midX + overlap;
+			laserConfig.laserList.push_back(laser);
+			laser.laserID = "2"; laser.xMin = midX - overlap; laser.xMax = maxX + 1.0;
+			laserConfig.laserList.push_back(laser);
+			laserScheduler scheduler(laserConfig);
+			scanTimeEstimator laserTimer(laserConfig);
+
+			vector<trajectory> plate(1);
+			plate[0].pathProcessingMode = "concurrent";
+			for (size_t r = 0; r < L.s.rList.size(); r++)
+			{
+				vector<int> oneRegion(1, (int)r);
+				for (int n = 0; n < rp.numCntr; n++)
+				{
+					path p = contour(L, oneRegion, rp, n*rp.resCntr + rp.offCntr, BB, config.outputIntegerIDs);
+					if (p.vecSg.size() > 0) { plate[0].vecPath.push_back(move(p)); }
+				}
+				path p = hatchOPT(L, oneRegion, rp, fullHatchOffset, hatchAngle, a_min, a_max, config.outputIntegerIDs, BB);
+				if (p.vecSg.size() > 0) { plate[0].vecPath.push_back(move(p)); }
+			}
+			scanTimeEstimate oneLaser = laserTimer.layerTime(plate);
+			string unreachable;
+			bool scheduled = true;
+			reporter.run("laserSchedule", bc.name(), (long long)plate[0].vecPath.size(), [&]() {
+				scheduled = scheduler.assignLasers(plate, laserTimer, &unreachable);
+			});
+			if (reporter.selected("laserSchedule", bc.name()))
+			{
+				scheduler.assignLasers(plate, laserTimer, &unreachable);
+				ostringstream text;
+				text << fixed << setprecision(4) << "laserSchedule/" << bc.name() << ": " << plate[0].vecPath.size() << " paths, " << oneLaser.total()
+					<< " s on one laser, " << laserTimer.layerTime(plate).total() << " s on two" << (scheduled ? "" : " (a path was out of reach)");
+				reporter.note(text.str());
+			}
+		}
+		string benchXML = caseFolder + pathSep + "scan_bench.xml";
+		reporter.run("createSCANxmlFile", bc.name(), (long long)numSegments, [&]() {
+			createSCANxmlFile(benchXML, midLayer, config, trajectoryList);
+		});
+		string benchSVG = caseFolder + pathSep + "scan_bench.svg";
+		reporter.run("scan2SVG", bc.name(), (long long)numSegments, [&]() {
+			scan2SVG(benchSVG, trajectoryList, 2000, 10.0, 0.0, 0.0);
+		});
+		if (reporter.selected("scan2SVG", bc.name()))
+		{
+			scan2SVG(benchSVG, trajectoryList, 2000, 10.0, 0.0, 0.0);
+			size_t numMarks = 0;
+			double markLength;
+			for (size_t t = 0; t < trajectoryList.size(); t++)
+			{
+				for (size_t p = 0; p < trajectoryList[t].vecPath.size(); p++)
+				{
+					size_t n;
+					markTotals(trajectoryList[t].vecPath[p], &n, &markLength);
+					numMarks += n;
+				}
+			}
+			reporter.note("scan2SVG/" + bc.name() + ": " + to_string(numMarks) + " marks in " + to_string(fs::file_size(benchSVG)) + " bytes");
+		}
+
+		// the remaining benchmarks read the layer files written by benchLayer
+		string xmlFolder = caseFolder + pathSep + "LayerFiles" + pathSep + "XMLdir" + pathSep;
+		int pipelineLayers = 0;
+		while (pipelineLayers < opts.layers && fs::exists(xmlFolder + layerFileName(pipelineLayers + 1, min(opts.layers, numLayers)))) { pipelineLayers++; }
+		if (pipelineLayers == 0)
+		{
+			if (reporter.selected("scanPipeline", bc.name()))
+			{
+				cerr << "No layer files in " << xmlFolder << "; run benchLayer with the same --work and --layers first" << endl;
+			}
+			continue;
+		}
+		string firstLayerFile = xmlFolder + layerFileName(1, min(opts.layers, numLayers));
+		layer Lx;
+		readLayerFile(firstLayerFile, Lx);
+		size_t numLayerEdges = 0;
+		for (size_t r = 0; r < Lx.s.rList.size(); r++) { numLayerEdges += Lx.s.rList[r].eList.size(); }
+		reporter.run("traverseDOM", bc.name(), (long long)numLayerEdges, [&]() {
+			readLayerFile(firstLayerFile, Lx);
+		});
+
+		// allocations: operator new calls for one layer through each stage of the pipeline
+		if (reporter.selected("allocations", bc.name()))
+		{
+			layer La;
+			vector<trajectory> ta;
+			long long readAllocs = countAllocations([&]() { readLayerFile(firstLayerFile, La); });
+			long long scanAllocs = countAllocations([&]() { ta = scanLayer(config, La, 1); });
+			long long writeAllocs = countAllocations([&]() { createSCANxmlFile(benchXML, 1, config, ta); });
+			reporter.note("allocations/" + bc.name() + ": traverseDOM " + to_string(readAllocs) + ", scanLayer " + to_string(scanAllocs)
+				+ ", createSCANxmlFile " + to_string(writeAllocs) + ", " + to_string(readAllocs + scanAllocs + writeAllocs) + " per layer");
+		}
+		reporter.run("scanPipeline", bc.name(), pipelineLayers, [&]() {
+			for (int i = 1; i <= pipelineLayers; i++)
+			{
+				layer Lp;
+				if (!readLayerFile(xmlFolder + layerFileName(i, min(opts.layers, numLayers)), Lp)) { break; }
+				vector<trajectory> tl = scanLayer(config, Lp, i);
+				createSCANxmlFile(caseFolder + pathSep + "ScanFiles" + pathSep + "scan_" + to_string(i) + ".xml", i, config, tl);
+			}
+		}, 1);
+	}
+
+	CoUninitialize();
+	if (checksFailed)
+	{
+		cerr << "A check failed; see the # comment lines" << endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,478 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+benchShapes.cpp generates the parametric benchmark geometries
+described in benchShapes.h.  Simple shapes are built from circles
+and rectangles; the lattices are implicit fields which are sliced
+with marching squares and meshed with marching tetrahedra, so the
+STL and SVG forms of a case describe the same part
+//============================================================*/
+
+#include "benchShapes.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <functional>
+#include <unordered_map>
+#include <algorithm>
+#include <math.h>
+
+using namespace std;
+
+static const int circleSegments = 64;		// segments per circle for pins and tubes
+static const double wallThickness = 0.6;	// mm, thin-wall case: two contours plus a narrow hatched core
+static const double gyroidThickness = 0.4;	// half-thickness of the gyroid sheet, in units of the gyroid function
+static const double strutRadius = 0.1;		// strut radius as a fraction of the lattice cell size
+static const int sliceSamplesPerCell = 16;	// marching-squares resolution for the lattice cross-sections
+static const int meshSamplesPerCell = 8;	// marching-tetrahedra resolution for the lattice meshes
+
+vector<benchCase> benchCases(bool quick)
+{
+	// {shape, small size, large size}; the cube's footprint follows its size, the others fill a 50 mm plate
+	const string shapes[] = { "cube", "cylinders", "walls", "plate", "gyroid", "struts" };
+	const int smallSize[] = { 10, 4, 8, 5, 3, 3 };
+	const int largeSize[] = { 50, 16, 64, 20, 10, 8 };
+	vector<benchCase> cases;
+	for (int s = 0; s < 6; s++)
+	{
+		for (int pass = 0; pass < (quick ? 1 : 2); pass++)
+		{
+			benchCase c;
+			c.shape = shapes[s];
+			c.size = (pass == 0) ? smallSize[s] : largeSize[s];
+			if (c.shape == "cube") { c.extent_mm = c.size; }
+			cases.push_back(c);
+		}
+	}
+	return cases;
+}
+
+size_t benchPointCount(const vector<benchLoop> &loops)
+{
+	size_t n = 0;
+	for (size_t i = 0; i < loops.size(); i++) { n += loops[i].pts.size(); }
+	return n;
+}
+
+//**************************
+// Cross-sections
+
+static benchLoop circleLoop(double cx, double cy, double r, bool isOuter)
+{
+	benchLoop lp;
+	lp.isOuter = isOuter;
+	for (int k = 0; k < circleSegments; k++)
+	{
+		double a = 2.0 * benchPi * k / circleSegments;
+		if (!isOuter) { a = -a; }	// holes run clockwise
+		lp.pts.push_back({ cx + r * cos(a), cy + r * sin(a) });
+	}
+	return lp;
+}
+
+static benchLoop rectLoop(double x0, double y0, double x1, double y1)
+{
+	benchLoop lp;
+	lp.isOuter = true;
+	lp.pts = { { x0, y0 },{ x1, y0 },{ x1, y1 },{ x0, y1 } };
+	return lp;
+}
+
+// gyroid sheet: solid where the field is negative
+static double gyroidField(double x, double y, double z, double cell)
+{
+	double k = 2.0 * benchPi / cell;
+	double g = sin(k*x)*cos(k*y) + sin(k*y)*cos(k*z) + sin(k*z)*cos(k*x);
+	return fabs(g) - gyroidThickness;
+}
+
+// distance from p to the segment a-b
+static double segmentDistance(const double p[3], const double a[3], const double b[3])
+{
+	double ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+	double ap[3] = { p[0] - a[0], p[1] - a[1], p[2] - a[2] };
+	double t = (ap[0] * ab[0] + ap[1] * ab[1] + ap[2] * ab[2]) / (ab[0] * ab[0] + ab[1] * ab[1] + ab[2] * ab[2]);
+	t = max(0.0, min(1.0, t));
+	double d[3] = { ap[0] - t*ab[0], ap[1] - t*ab[1], ap[2] - t*ab[2] };
+	return sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+}
+
+// body-centred-cubic strut lattice: struts from each cell centre to its eight corners.  Solid where the field is negative
+static double strutField(double x, double y, double z, double cell)
+{
+	// local coordinates within the containing cell
+	double p[3] = { x / cell - floor(x / cell), y / cell - floor(y / cell), z / cell - floor(z / cell) };
+	double c[3] = { 0.5, 0.5, 0.5 };
+	double dMin = 1.0;
+	for (int k = 0; k < 8; k++)
+	{
+		double corner[3] = { (double)(k & 1), (double)((k >> 1) & 1), (double)((k >> 2) & 1) };
+		dMin = min(dMin, segmentDistance(p, c, corner));
+	}
+	return dMin - strutRadius;
+}
+
+// implicit field for the lattice cases, bounded by the footprint and the part height
+static function<double(double, double, double)> latticeField(const benchCase &c)
+{
+	double cell = c.extent_mm / c.size;
+	bool isGyroid = (c.shape == "gyroid");
+	double extent = c.extent_mm, height = c.height_mm;
+	return [=](double x, double y, double z) {
+		if (x < 0 || y < 0 || z < 0 || x > extent || y > extent || z > height) { return 1.0; }
+		return isGyroid ? gyroidField(x, y, z, cell) : strutField(x, y, z, cell);
+	};
+}
+
+// Contour the region f(x,y) < 0 over [0,extent]^2 with marching squares.  Samples outside the square are treated as empty,
+// so every loop is closed.  Crossing points are keyed by grid edge, which lets the segments be chained without a tolerance
+static vector<benchLoop> marchingSquares(const function<double(double, double)> &f, double extent, int n)
+{
+	double step = extent / n;
+	int N = n + 3;	// one padding sample on each side
+	vector<double> v(N * N);
+	for (int j = 0; j < N; j++)
+	{
+		for (int i = 0; i < N; i++)
+		{
+			bool pad = (i == 0 || j == 0 || i == N - 1 || j == N - 1);
+			v[j*N + i] = pad ? 1.0 : f((i - 1) * step, (j - 1) * step);
+		}
+	}
+	unordered_map<long long, long long> nextKey;	// contour segment from one crossing to the next, solid on the left
+	unordered_map<long long, benchPoint> position;
+	for (int j = 0; j < N - 1; j++)
+	{
+		for (int i = 0; i < N - 1; i++)
+		{
+			// corners counter-clockwise from bottom-left, and the grid edges between them
+			int ci[4] = { i, i + 1, i + 1, i };
+			int cj[4] = { j, j, j + 1, j + 1 };
+			long long key[4] = { 2LL * (j*N + i), 2LL * (j*N + i + 1) + 1, 2LL * ((j + 1)*N + i), 2LL * (j*N + i) + 1 };
+			double cv[4];
+			for (int k = 0; k < 4; k++) { cv[k] = v[cj[k] * N + ci[k]]; }
+			// crossings in counter-clockwise order; an exit leaves the solid, an entry enters it
+			long long xKey[4];
+			bool xExit[4];
+			int numX = 0;
+			for (int k = 0; k < 4; k++)
+			{
+				int k1 = (k + 1) % 4;
+				if ((cv[k] < 0) != (cv[k1] < 0))
+				{
+					double t = cv[k] / (cv[k] - cv[k1]);
+					position[key[k]] = { (ci[k] - 1 + t * (ci[k1] - ci[k])) * step, (cj[k] - 1 + t * (cj[k1] - cj[k])) * step };
+					xKey[numX] = key[k];
+					xExit[numX] = (cv[k] < 0);
+					numX++;
+				}
+			}
+			// each exit joins the following entry, except for a saddle whose centre is empty, where it joins the preceding one
+			bool centreSolid = (cv[0] + cv[1] + cv[2] + cv[3]) < 0;
+			for (int x = 0; x < numX; x++)
+			{
+				if (!xExit[x]) { continue; }
+				int partner = (numX == 2 || centreSolid) ? (x + 1) % numX : (x + numX - 1) % numX;
+				nextKey[xKey[x]] = xKey[partner];
+			}
+		}
+	}
+	// chain the segments into loops, in a deterministic order
+	vector<long long> starts;
+	for (auto it = nextKey.begin(); it != nextKey.end(); ++it) { starts.push_back(it->first); }
+	sort(starts.begin(), starts.end());
+	unordered_map<long long, bool> used;
+	vector<benchLoop> loops;
+	for (size_t s = 0; s < starts.size(); s++)
+	{
+		if (used[starts[s]]) { continue; }
+		benchLoop lp;
+		long long k = starts[s];
+		while (!used[k] && nextKey.count(k))
+		{
+			used[k] = true;
+			lp.pts.push_back(position[k]);
+			k = nextKey[k];
+		}
+		if (lp.pts.size() < 3) { continue; }
+		double area = 0;
+		for (size_t p = 0; p < lp.pts.size(); p++)
+		{
+			const benchPoint &a = lp.pts[p], &b = lp.pts[(p + 1) % lp.pts.size()];
+			area += a.x * b.y - b.x * a.y;
+		}
+		lp.isOuter = (area > 0);
+		loops.push_back(lp);
+	}
+	return loops;
+}
+
+vector<benchLoop> benchSlice(const benchCase &c, double z)
+{
+	vector<benchLoop> loops;
+	if (z < 0 || z > c.height_mm) { return loops; }
+	double pitch = c.extent_mm / c.size;
+	if (c.shape == "cube")
+	{
+		loops.push_back(rectLoop(0, 0, c.extent_mm, c.extent_mm));
+	}
+	else if (c.shape == "cylinders")
+	{
+		for (int j = 0; j < c.size; j++)
+			for (int i = 0; i < c.size; i++)
+				loops.push_back(circleLoop((i + 0.5)*pitch, (j + 0.5)*pitch, 0.35*pitch, true));
+	}
+	else if (c.shape == "walls")
+	{
+		for (int i = 0; i < c.size; i++)
+			loops.push_back(rectLoop((i + 0.5)*pitch - 0.5*wallThickness, 0, (i + 0.5)*pitch + 0.5*wallThickness, c.extent_mm));
+	}
+	else if (c.shape == "plate")
+	{
+		for (int j = 0; j < c.size; j++)
+		{
+			for (int i = 0; i < c.size; i++)
+			{
+				loops.push_back(circleLoop((i + 0.5)*pitch, (j + 0.5)*pitch, 0.4*pitch, true));
+				loops.push_back(circleLoop((i + 0.5)*pitch, (j + 0.5)*pitch, 0.2*pitch, false));
+			}
+		}
+	}
+	else
+	{
+		function<double(double, double, double)> field = latticeField(c);
+		loops = marchingSquares([&](double x, double y) { return field(x, y, z); }, c.extent_mm, c.size * sliceSamplesPerCell);
+	}
+	return loops;
+}
+
+//**************************
+// Meshes
+
+static void addTriangle(vector<benchTriangle> &tris, const double a[3], const double b[3], const double c[3])
+{
+	benchTriangle t;
+	double u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+	double w[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+	double n[3] = { u[1] * w[2] - u[2] * w[1], u[2] * w[0] - u[0] * w[2], u[0] * w[1] - u[1] * w[0] };
+	double len = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+	for (int k = 0; k < 3; k++)
+	{
+		t.n[k] = (float)(len > 0 ? n[k] / len : 0.0);
+		t.v[0][k] = (float)a[k];
+		t.v[1][k] = (float)b[k];
+		t.v[2][k] = (float)c[k];
+	}
+	tris.push_back(t);
+}
+
+// quad a-b-c-d, counter-clockwise when seen from outside
+static void addQuad(vector<benchTriangle> &tris, const double a[3], const double b[3], const double c[3], const double d[3])
+{
+	addTriangle(tris, a, b, c);
+	addTriangle(tris, a, c, d);
+}
+
+// vertical prism over a closed loop (outer loops counter-clockwise, holes clockwise), without caps
+static void addLoopWalls(vector<benchTriangle> &tris, const benchLoop &lp, double z0, double z1)
+{
+	for (size_t k = 0; k < lp.pts.size(); k++)
+	{
+		const benchPoint &p = lp.pts[k], &q = lp.pts[(k + 1) % lp.pts.size()];
+		double a[3] = { p.x, p.y, z0 }, b[3] = { q.x, q.y, z0 }, c[3] = { q.x, q.y, z1 }, d[3] = { p.x, p.y, z1 };
+		addQuad(tris, a, b, c, d);
+	}
+}
+
+// caps for a convex outer loop, optionally with one concentric hole of the same point count (tube)
+static void addCaps(vector<benchTriangle> &tris, const benchLoop &outer, const benchLoop *hole, double z0, double z1)
+{
+	size_t n = outer.pts.size();
+	for (size_t k = 0; k < n; k++)
+	{
+		const benchPoint &p = outer.pts[k], &q = outer.pts[(k + 1) % n];
+		if (hole == NULL)
+		{
+			if (k == 0 || k == n - 1) { continue; }	// fan around the first point
+			const benchPoint &o = outer.pts[0];
+			double t0[3] = { o.x, o.y, z1 }, t1[3] = { p.x, p.y, z1 }, t2[3] = { q.x, q.y, z1 };
+			double b0[3] = { o.x, o.y, z0 }, b1[3] = { p.x, p.y, z0 }, b2[3] = { q.x, q.y, z0 };
+			addTriangle(tris, t0, t1, t2);
+			addTriangle(tris, b0, b2, b1);
+		}
+		else
+		{
+			// the hole runs clockwise, so its point n-k matches the outer point k
+			const benchPoint &hp = hole->pts[(n - k) % n], &hq = hole->pts[(n - k - 1) % n];
+			double t0[3] = { p.x, p.y, z1 }, t1[3] = { q.x, q.y, z1 }, t2[3] = { hq.x, hq.y, z1 }, t3[3] = { hp.x, hp.y, z1 };
+			double b0[3] = { p.x, p.y, z0 }, b1[3] = { q.x, q.y, z0 }, b2[3] = { hq.x, hq.y, z0 }, b3[3] = { hp.x, hp.y, z0 };
+			addQuad(tris, t0, t1, t2, t3);
+			addQuad(tris, b0, b3, b2, b1);
+		}
+	}
+}
+
+// Mesh the region f < 0 with marching tetrahedra (six tetrahedra per grid cube).  Triangles are oriented to face from the
+// solid vertices towards the empty ones
+static void marchingTetrahedra(vector<benchTriangle> &tris, const function<double(double, double, double)> &f, double extent, double height, double step)
+{
+	int nx = (int)ceil(extent / step) + 2, nz = (int)ceil(height / step) + 2;
+	auto sample = [&](int i, int j, int k) { return f((i - 1) * step, (j - 1) * step, (k - 1) * step); };
+	static const int cubeCorner[8][3] = { { 0,0,0 },{ 1,0,0 },{ 1,1,0 },{ 0,1,0 },{ 0,0,1 },{ 1,0,1 },{ 1,1,1 },{ 0,1,1 } };
+	static const int tets[6][4] = { { 0,5,1,6 },{ 0,1,2,6 },{ 0,2,3,6 },{ 0,3,7,6 },{ 0,7,4,6 },{ 0,4,5,6 } };
+	for (int k = 0; k < nz; k++)
+	{
+		for (int j = 0; j < nx; j++)
+		{
+			for (int i = 0; i < nx; i++)
+			{
+				double p[8][3], val[8];
+				bool anySolid = false, anyEmpty = false;
+				for (int c = 0; c < 8; c++)
+				{
+					int ii = i + cubeCorner[c][0], jj = j + cubeCorner[c][1], kk = k + cubeCorner[c][2];
+					p[c][0] = (ii - 1) * step; p[c][1] = (jj - 1) * step; p[c][2] = (kk - 1) * step;
+					val[c] = sample(ii, jj, kk);
+					if (val[c] < 0) { anySolid = true; } else { anyEmpty = true; }
+				}
+				if (!anySolid || !anyEmpty) { continue; }
+				for (int t = 0; t < 6; t++)
+				{
+					int in[4], out[4], numIn = 0, numOut = 0;
+					for (int c = 0; c < 4; c++)
+					{
+						int idx = tets[t][c];
+						if (val[idx] < 0) { in[numIn++] = idx; } else { out[numOut++] = idx; }
+					}
+					if (numIn == 0 || numOut == 0) { continue; }
+					// crossing point on the edge between solid corner a and empty corner b
+					auto cross = [&](int a, int b, double *q) {
+						double s = val[a] / (val[a] - val[b]);
+						for (int d = 0; d < 3; d++) { q[d] = p[a][d] + s * (p[b][d] - p[a][d]); }
+					};
+					// direction from the solid corners towards the empty corners, used to orient the triangles
+					double dir[3] = { 0, 0, 0 };
+					for (int d = 0; d < 3; d++)
+					{
+						for (int c = 0; c < numOut; c++) { dir[d] += p[out[c]][d] / numOut; }
+						for (int c = 0; c < numIn; c++) { dir[d] -= p[in[c]][d] / numIn; }
+					}
+					double q[4][3];
+					int numQ = 0;
+					if (numIn == 1) { for (int c = 0; c < 3; c++) { cross(in[0], out[c], q[numQ++]); } }
+					else if (numOut == 1) { for (int c = 0; c < 3; c++) { cross(in[c], out[0], q[numQ++]); } }
+					else { cross(in[0], out[0], q[0]); cross(in[0], out[1], q[1]); cross(in[1], out[1], q[2]); cross(in[1], out[0], q[3]); numQ = 4; }
+					for (int tri = 0; tri < numQ - 2; tri++)
+					{
+						const double *a = q[0], *b = q[tri + 1], *c = q[tri + 2];
+						double u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] }, w[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+						double n[3] = { u[1] * w[2] - u[2] * w[1], u[2] * w[0] - u[0] * w[2], u[0] * w[1] - u[1] * w[0] };
+						if (n[0] * dir[0] + n[1] * dir[1] + n[2] * dir[2] < 0) { addTriangle(tris, a, c, b); }
+						else { addTriangle(tris, a, b, c); }
+					}
+				}
+			}
+		}
+	}
+}
+
+vector<benchTriangle> benchMesh(const benchCase &c)
+{
+	vector<benchTriangle> tris;
+	double h = c.height_mm;
+	if (c.shape == "gyroid" || c.shape == "struts")
+	{
+		function<double(double, double, double)> field = latticeField(c);
+		marchingTetrahedra(tris, field, c.extent_mm, h, (c.extent_mm / c.size) / meshSamplesPerCell);
+		return tris;
+	}
+	// the remaining shapes are prisms over their cross-section
+	vector<benchLoop> loops = benchSlice(c, 0.5 * h);
+	for (size_t i = 0; i < loops.size(); i++)
+	{
+		if (!loops[i].isOuter) { continue; }
+		const benchLoop *hole = (i + 1 < loops.size() && !loops[i + 1].isOuter) ? &loops[i + 1] : NULL;
+		addLoopWalls(tris, loops[i], 0, h);
+		if (hole != NULL) { addLoopWalls(tris, *hole, 0, h); }
+		addCaps(tris, loops[i], hole, 0, h);
+	}
+	return tris;
+}
+
+bool writeBinarySTL(const string &fn, const vector<benchTriangle> &tris)
+{
+	ofstream os(fn.c_str(), ios::out | ios::binary);
+	if (!os.is_open()) { return false; }
+	char header[80] = "OASIS benchmark part";
+	os.write(header, 80);
+	unsigned int count = (unsigned int)tris.size();
+	os.write((const char *)&count, 4);
+	unsigned short attribute = 0;
+	for (size_t i = 0; i < tris.size(); i++)
+	{
+		os.write((const char *)tris[i].n, 12);
+		os.write((const char *)tris[i].v, 36);
+		os.write((const char *)&attribute, 2);
+	}
+	return os.good();
+}
+
+bool writeASCIISTL(const string &fn, const vector<benchTriangle> &tris)
+{
+	ofstream os(fn.c_str());
+	if (!os.is_open()) { return false; }
+	os << "solid OASIS benchmark part\n" << scientific << setprecision(6);
+	for (size_t i = 0; i < tris.size(); i++)
+	{
+		os << "  facet normal " << tris[i].n[0] << " " << tris[i].n[1] << " " << tris[i].n[2] << "\n    outer loop\n";
+		for (int k = 0; k < 3; k++)
+		{
+			os << "      vertex " << tris[i].v[k][0] << " " << tris[i].v[k][1] << " " << tris[i].v[k][2] << "\n";
+		}
+		os << "    endloop\n  endfacet\n";
+	}
+	os << "endsolid OASIS benchmark part\n";
+	return os.good();
+}
+
+bool writeSlic3rSVG(const string &fn, const benchCase &c, double layerThickness_mm, int numLayers)
+{
+	ofstream os(fn.c_str());
+	if (!os.is_open()) { return false; }
+	os << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n";
+	os << "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.0//EN\" \"http://www.w3.org/TR/2001/REC-SVG-20010904/DTD/svg10.dtd\">\n";
+	os << "<svg width=\"" << c.extent_mm << "\" height=\"" << c.extent_mm << "\" xmlns=\"http://www.w3.org/2000/svg\" xmlns:svg=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" xmlns:slic3r=\"http://slic3r.org/namespaces/slic3r\">\n";
+	os << "  <!-- \n  Generated by the OASIS benchmark shape generator\n   -->\n";
+	os << fixed << setprecision(4);
+	for (int n = 0; n < numLayers; n++)
+	{
+		double z = (n + 0.5) * layerThickness_mm;
+		os << "  <g id=\"layer" << n << "\" slic3r:z=\"" << z << "\">\n";
+		vector<benchLoop> loops = benchSlice(c, z);
+		for (size_t i = 0; i < loops.size(); i++)
+		{
+			// readFile locates the point list by its distance from the end of the line, so the trailing style must match Slic3r's
+			os << "    <polygon slic3r:type=\"" << (loops[i].isOuter ? "contour" : "hole") << "\" points=\"";
+			for (size_t p = 0; p < loops[i].pts.size(); p++)
+			{
+				os << (p ? " " : "") << loops[i].pts[p].x << "," << loops[i].pts[p].y;
+			}
+			os << "\" style=\"fill: " << (loops[i].isOuter ? "white" : "black") << "\" />\n";
+		}
+		os << "  </g>\n";
+	}
+	os << "</svg>\n";
+	return os.good();
+}
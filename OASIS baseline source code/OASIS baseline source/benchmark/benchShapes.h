@@ -0,0 +1,94 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+benchShapes.h defines parametric test geometries for the benchmark
+programs (benchLayer, benchScan).  Each benchmark case can be
+written as a binary STL file, as a Slic3r-style SVG slice stack
+(the input format read by genLayer's readFile) or returned one
+cross-section at a time as closed loops
+
+Shapes:
+	cube		a single block, size = edge length in mm
+	cylinders	size x size array of round pins
+	walls		size parallel thin walls (0.6 mm thick)
+	plate		size x size array of small tubes (a many-part plate; each
+				cross-section is an outer loop plus one hole)
+	gyroid		gyroid sheet lattice, size = unit cells across the footprint
+	struts		body-centred-cubic strut lattice, size = unit cells across
+
+These types are deliberately independent of the genLayer and genScan
+vertex/layer structures, which share names and cannot be linked into
+one program
+//============================================================*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static const double benchPi = 3.14159265358979323846;
+
+// a point in a cross-section, in mm
+struct benchPoint
+{
+	double x;
+	double y;
+};
+
+// a closed loop in a cross-section.  Outer loops run counter-clockwise and holes clockwise, as in Slic3r output
+struct benchLoop
+{
+	vector<benchPoint> pts;	// the last point connects back to the first; it is not repeated
+	bool isOuter;
+};
+
+// a facet in the layout of a binary STL record (normal, three vertices)
+struct benchTriangle
+{
+	float n[3];
+	float v[3][3];
+};
+
+// one benchmark geometry
+struct benchCase
+{
+	string shape;				// cube, cylinders, walls, plate, gyroid or struts
+	int size;					// shape-specific size parameter (see above)
+	double extent_mm = 50.0;	// edge length of the square footprint
+	double height_mm = 5.0;		// height of the part
+	string name() const { return shape + to_string(size); }
+};
+
+// the standard list of benchmark cases.  quick=true returns the smaller size of each shape only
+vector<benchCase> benchCases(bool quick);
+
+// cross-section of a case at height z (mm above the bottom of the part)
+vector<benchLoop> benchSlice(const benchCase &c, double z);
+
+// triangulated surface of a case
+vector<benchTriangle> benchMesh(const benchCase &c);
+
+// write triangles to a binary or ASCII STL file.  Return false if the file could not be written
+bool writeBinarySTL(const string &fn, const vector<benchTriangle> &tris);
+bool writeASCIISTL(const string &fn, const vector<benchTriangle> &tris);
+
+// write numLayers cross-sections (at z = (n+0.5)*layerThickness_mm) in the SVG layout produced by Slic3r's --export-svg,
+// so the file can be read by genLayer's readFile and getNumLayer.  Returns false if the file could not be written
+bool writeSlic3rSVG(const string &fn, const benchCase &c, double layerThickness_mm, int numLayers);
+
+// total number of points in a cross-section
+size_t benchPointCount(const vector<benchLoop> &loops);
@@ -30,30 +30,46 @@ on the configuration file has already been performed)
 #include "BasicExcel.hpp"
 #include "errorChecks.h"
 #include "io_functions.h"
+#include "runReport.h"
+#include "traceEvents.h"
 
 using namespace std;
 
-int main()
+int main(int argc, char **argv)
 {
 	// createScanpaths.exe should be located in the same directory (the "executable folder") as genLayer.exe, genScan.exe and the slic3r folder.
 	// You can then create a shortcut to createScanpaths.exe and move that anywhere
-	
-	// 1a. Clean up any existing status and SVG files from prior slicing operations
-	bool returnValue = cleanupOnStart();
-	// 1b. Define variables
-	string sysCommand;
+	//
+	// Optional command-line arguments allow unattended runs, e.g. on a batch node:
+	//	createScanpaths [config.xls | --config config.xls] [--mode layer|scan|both] [--existing delete|merge] [--batch]
+	//	                [--shard id --layers first-last | --merge]
+	// Anything not given on the command line is asked of the user, as before.
+	// Several shards (on one or more machines sharing the project folder) can each generate a range of layers;
+	// createScanpaths --merge then checks their manifests and writes layer_header.xml and the .scn file
+
+	// 1a. Read the command-line options, if any
+	commandLineOptions options = parseCommandLine(argc, argv);
+	if (!options.valid) {
+		pauseForUser();
+		return 1;
+	}
+	setInteractive(!options.batch);  // in batch mode nothing waits for a key press
+	// 1b. Determine the location of the executable folder and work from there, wherever we were started from
+	string currentPath = executableFolder();
+	setCurrentDirectory(currentPath);
+	// 1c. Clean up any existing status and SVG files from prior slicing operations
+	cleanupOnStart(options.shardId);
+	// 1d. Define variables
 	string statusFilename;
 	int generationResult, finished;
-	// 1c. Determine the location of the executable folder
-	TCHAR filePath[MAX_PATH + 1] = "";
-	GetCurrentDirectory(MAX_PATH, filePath);
-	string currentPath = &filePath[0];
-
-	// 2. Ask user to select a configuration file in this or another folder
-	//	this also sets the current directory to wherever the config file is located, so we saved the executable folder in currentPath, above
-	fileData configFileData = selectConfigFile();
+
+	// 2. Use the configuration file named on the command line, or ask user to select one in this or another folder
+	//	on Windows the file dialog also sets the current directory to wherever the config file is located, so we saved the executable folder in currentPath, above
+	fileData configFileData;
+	if (options.configFile != "") { configFileData = configFileFromPath(options.configFile); }
+	else { configFileData = selectConfigFile(); }
 	if (configFileData.xlsFileSelected != true) { 
-		system("pause");  // user either cancelled the selection or chose something other than a .xls file
+		pauseForUser();  // user either cancelled the selection or chose something other than a .xls file
 		return 1;
 	}
 
@@ -63,9 +79,7 @@ int main()
 	configData.executableFolder = currentPath;  // we have separate variables for location of the executables and of the config file (and STL files)
 	//
 	// erase any error file which may be present in the config-file folder
-	string deleteErrFileCommand;
-	deleteErrFileCommand = "del \"" + configData.configPath + "\\" + errorReportFilename + "\" >nul 2>&1";
-	system(deleteErrFileCommand.c_str());
+	deleteFile(configData.configPath + pathSep + errorReportFilename);
 	//
 	// check the config file for errors
 	cout << " checking for errors...";
@@ -74,17 +88,27 @@ int main()
 	string functionWithIssue = "";
 	string errorMsg = "";
 	evaluateConfigFile(configData, errorData);  // if the config file has errors, this function will quit and write to console and error file
+
+	// If asked to merge the output of shards, do only that
+	if (options.merge) {
+		int mergeResult = mergeShardOutput(configData, options.batch);
+		if (mergeResult == 0) { cout << "Shard output merged successfully\n"; }
+		pauseForUser();
+		return mergeResult;
+	}
 	
 	// 4. Evaluate the project folder listed in the configuration file to see whether layer and/or scan xml files exist
 	//	folderStatus indicates whether layer (L) files or layer + scan (LS) files exist.  "" = neither set of files & associated folders exists
 	string folderStatus = evaluateProjectFolder(configData);
 
-	// 5. Ask user what operations to execute, based on whatever prior layer and/or scan folders exist in the project folder
-	string userChoice = getUserOption(configData, folderStatus);
+	// 5. Ask user what operations to execute (unless given on the command line), based on whatever prior layer and/or scan folders exist in the project folder
+	string userChoice;
+	if (options.mode != "") { userChoice = getCommandLineOption(options, folderStatus); }
+	else { userChoice = getUserOption(configData, folderStatus); }
 	if (userChoice == "c") {
 		// user opts to cancel
 		cout << "Scanpath generation cancelled.  Any existing files will be left untouched\n";
-		system("pause\n");
+		pauseForUser();
 		return 1;
 	}
 	
@@ -93,20 +117,24 @@ int main()
 	int folderSetupOk = setupOutputFolders(configData, userChoice);
 	if (folderSetupOk != 0) {
 		cout << "Something went wrong during output folder deletion or creation... perhaps a file is in use in the output folder\nScanpath generation cancelled\n";
-		system("pause\n");
+		pauseForUser();
 		return 1;
 	}
 	else {
 		// folder structure was set up properly
 		// delete any .zip or .scn file that might be left from prior executions
-		string deleteZipFileCommand;
-		deleteZipFileCommand = "del \"" + configData.projectFolder + "\\scanpath_files.*\" >nul 2>&1";
-		system(deleteZipFileCommand.c_str());
+		deleteFile(configData.projectFolder + pathSep + "scanpath_files.zip");
+		deleteFile(configData.projectFolder + pathSep + "scanpath_files.scn");
+		// likewise delete timing samples left by an interrupted run, so that the run report only covers this run
+		deleteFile(configData.projectFolder + pathSep + shardFilename(runSamplesFilename, options.shardId));
+#if TRACEEVENTS
+		// start a new trace file; genLayer and genScan append their events to it
+		startTraceFile(configData.projectFolder + pathSep + shardFilename(traceFilename, options.shardId), "createScanpaths");
+#endif
 		// set current directory back to the executable folder so that we can find genLayer, genScan and slic3r
-		LPCSTR executableFolder = (configData.executableFolder + "\\").c_str();
-		if (!SetCurrentDirectoryA(executableFolder)) {
+		if (!setCurrentDirectory(configData.executableFolder)) {
 			cout << "Could not set the current directory back to the executable folder!" << endl;
-			system("pause");
+			pauseForUser();
 			return -1;
 		}
 	}
@@ -116,17 +144,20 @@ int main()
 		// call layer generation
 		cout << "\nBeginning layer generation\n";
 
-		sysCommand = "\"" + configData.executableFolder + "\\" + "genLayer\" \"" + configData.configFilename + "\"";
-		statusFilename = "gl_sts.cfg";
+		vector<string> command = { configData.executableFolder + pathSep + "genLayer", configData.configFilename };
+		if (options.batch) { command.push_back("--batch"); }
+		if (options.shardId != "") { command.insert(command.end(), { "--shard", options.shardId, "--layers", options.layerRange }); }
+		statusFilename = shardFilename("gl_sts.cfg", options.shardId);
 
-		generationResult = callGenerationCode(sysCommand, statusFilename);  // calls genLayer until all layers are complete, then returns
-		// move any SVG files created by slic3r into the layer output folder
-		sysCommand = "move \"" + configData.configPath + "\\*.svg\" \"" + configData.layerOutputFolder + "\" >nul 2>&1"; // move the Slic3r-generated SVG files to layer directory
-		system(sysCommand.c_str());
+		generationResult = callGenerationCode(command, statusFilename);  // calls genLayer until all layers are complete, then returns
+		// move any SVG files created by slic3r into the layer output folder (shards write theirs to the layer folder directly)
+		if (options.shardId == "") {
+			moveFilesWithExtension(configData.configPath, ".svg", configData.layerOutputFolder); // move the Slic3r-generated SVG files to layer directory
+		}
 		//	If errors, report and halt
 		if (generationResult != 0) {
 			cout << "We encountered an error during layer generation\nSome layer files may have been created, but are not known to be valid\n";
-			system("pause\n");
+			pauseForUser();
 			return 1;
 		}
 		else {
@@ -139,22 +170,28 @@ int main()
 		// call scan generation
 		cout << "\nBeginning scan generation\n";
 
-		sysCommand = "\"" + configData.executableFolder + "\\" + "genScan\" \"" + configData.configFilename + "\"";
-		statusFilename = "gs_sts.cfg";
+		vector<string> command = { configData.executableFolder + pathSep + "genScan", configData.configFilename };
+		if (options.batch) { command.push_back("--batch"); }
+		if (options.shardId != "") { command.insert(command.end(), { "--shard", options.shardId, "--layers", options.layerRange }); }
+		statusFilename = shardFilename("gs_sts.cfg", options.shardId);
 
-		generationResult = callGenerationCode(sysCommand, statusFilename);  // calls genScan until all layers are complete, then returns
+		generationResult = callGenerationCode(command, statusFilename);  // calls genScan until all layers are complete, then returns
 		//	If errors, report and halt
 		if (generationResult != 0) {
 			cout << "We encountered an error during scan generation\nSome scan files may have been created, but are not known to be valid\n";
-			returnValue = cleanupOnFinish();
-			system("pause\n");
+			cleanupOnFinish(options.shardId);
+			pauseForUser();
 			return 1;
 		}
 		else {
 			// Successfule scan path generation!
 			cout << "Scan generation was successful!\n";
 			// if user requested a zip file containing the scan XML files, generate this in the project folder
-			if (configData.createScanZIPfile == true) {
+			// (a shard has only some of the layers, so its files are zipped by createScanpaths --merge)
+			if (options.shardId != "") {
+				cout << "Run createScanpaths --merge once all shards have finished\n";
+			}
+			else if (configData.createScanZIPfile == true) {
 				// create zip file
 				generationResult = createScanZipfile(configData);
 				// we don't check the result of zip file generation since it is handled/reported by the function, and doesn't count as a true error
@@ -162,10 +199,26 @@ int main()
 		}
 	}
 
-	// 9. Cleanup status files and other items
-	returnValue = cleanupOnFinish();
+#if STAGETIMING
+	// 9. Summarize the timing samples from genLayer, genScan and this program into the run report, then discard the raw samples
+	string samplesFile = configData.projectFolder + pathSep + shardFilename(runSamplesFilename, options.shardId);
+	string reportFile = configData.projectFolder + pathSep + shardFilename(runReportFilename, options.shardId);
+	if (writeRunReport(samplesFile, reportFile, "createScanpaths")) {
+		cout << "Run timing report written to " << reportFile << endl;
+		remove(samplesFile.c_str());
+	}
+#endif
+
+#if TRACEEVENTS
+	closeTraceFile();
+	cout << "Trace events written to " << configData.projectFolder + pathSep + shardFilename(traceFilename, options.shardId) << endl;
+#endif
+
+	// 10. Cleanup status files and other items
+	cleanupOnFinish(options.shardId);
 
-	int sysReturnValue = system("\npause\n");
+	cout << endl;
+	pauseForUser();
 
     return 0;
 }
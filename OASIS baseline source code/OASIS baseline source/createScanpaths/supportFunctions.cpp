@@ -18,23 +18,127 @@ for file, folder and executable operations.
 //============================================================*/
 
 #include "supportFunctions.h"
+#include "runReport.h"
+#include "traceEvents.h"
 
 using namespace std;
-namespace fs = std::experimental::filesystem;
 
 
+// print the command-line options accepted by createScanpaths
+static void printUsage()
+{
+	cout << "\nUsage: createScanpaths [config.xls | --config config.xls] [--mode layer|scan|both] [--existing delete|merge] [--batch]\n";
+	cout << "                       [--shard id --layers first-last | --merge]\n";
+	cout << "  --config    configuration file (.xls).  If omitted, you will be asked to select one\n";
+	cout << "  --mode      generate layer files only, scan files from existing layers, or both.  If omitted, you will be asked\n";
+	cout << "  --existing  delete or merge with existing output in the project folder.  Required if output exists and --mode is given\n";
+	cout << "  --batch     never prompt or pause (for unattended runs).  Requires a configuration file and --mode (or --merge)\n";
+	cout << "  --shard     run as one of several shards sharing the project folder, generating only the layers given by --layers.\n";
+	cout << "              Output is always merged with existing files, and each shard records what it wrote in a manifest\n";
+	cout << "  --layers    range of layers for this shard, e.g. 1-250\n";
+	cout << "  --merge     once every shard has finished, check their manifests and write layer_header.xml and the .scn file\n\n";
+}
+
+// parse the command-line arguments into commandLineOptions, reporting any problems to the console
+commandLineOptions parseCommandLine(int argc, char **argv)
+{
+	commandLineOptions options;
+	for (int a = 1; a < argc; a++)
+	{
+		string arg = argv[a];
+		if (arg == "--batch") {
+			options.batch = true;
+		}
+		else if (arg == "--help") {
+			options.valid = false;	// just print the usage below
+		}
+		else if (arg == "--merge") {
+			options.merge = true;
+		}
+		else if ((arg == "--config") | (arg == "--mode") | (arg == "--existing") | (arg == "--shard") | (arg == "--layers")) {
+			if (a + 1 >= argc) {
+				cout << "*** " << arg << " requires a value\n";
+				options.valid = false;
+				break;
+			}
+			string value = argv[++a];
+			if (arg == "--config") { options.configFile = value; }
+			else if (arg == "--shard") { options.shardId = value; }
+			else if (arg == "--layers") { options.layerRange = value; }
+			else {
+				transform(value.begin(), value.end(), value.begin(), ::tolower);
+				if (arg == "--mode") { options.mode = value; }
+				else { options.existing = value; }
+			}
+		}
+		else if ((arg.size() > 0) && (arg[0] != '-') && (options.configFile == "")) {
+			// a bare argument is the configuration file (e.g. a .xls file dropped onto createScanpaths.exe)
+			options.configFile = arg;
+		}
+		else {
+			cout << "*** Unrecognized option " << arg << endl;
+			options.valid = false;
+		}
+	}
+
+	// check the option values
+	if ((options.mode != "") & (options.mode != "layer") & (options.mode != "scan") & (options.mode != "both")) {
+		cout << "*** --mode must be layer, scan or both\n";
+		options.valid = false;
+	}
+	if ((options.existing != "") & (options.existing != "delete") & (options.existing != "merge")) {
+		cout << "*** --existing must be delete or merge\n";
+		options.valid = false;
+	}
+	if (options.batch & ((options.configFile == "") | ((options.mode == "") & !options.merge))) {
+		cout << "*** --batch requires a configuration file and --mode, since nothing can be asked of the user\n";
+		options.valid = false;
+	}
+	int firstLayer, lastLayer;
+	if ((options.shardId != "") | (options.layerRange != "")) {
+		if ((options.shardId == "") | (options.layerRange == "") | (options.mode == "")) {
+			cout << "*** --shard and --layers must be given together, along with --mode\n";
+			options.valid = false;
+		}
+		else if (options.shardId.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789") != string::npos) {
+			cout << "*** --shard must be letters and digits only, since it becomes part of filenames\n";
+			options.valid = false;
+		}
+		else if (!parseLayerRange(options.layerRange, firstLayer, lastLayer)) {
+			cout << "*** --layers must be a range such as 1-250\n";
+			options.valid = false;
+		}
+		if (options.existing == "delete") {
+			cout << "*** --existing delete cannot be used with --shard, since it would delete the output of other shards\n";
+			options.valid = false;
+		}
+	}
+	if (options.merge & ((options.mode != "") | (options.shardId != "") | (options.configFile == ""))) {
+		cout << "*** --merge takes only a configuration file (and --batch)\n";
+		options.valid = false;
+	}
+	if (options.configFile != "") {
+		// resolve a relative path now, before createScanpaths changes directory to the executable folder
+		options.configFile = fs::absolute(fs::path(options.configFile)).string();
+	}
+	if (!options.valid) { printUsage(); }
+	return options;
+}
+
 // remove any "orphan" status and output files from previous runs in the execution directory
-bool cleanupOnStart()
+bool cleanupOnStart(string shardId)
 {
-	system("cls");
+	clearConsole();
 	cout << "Starting generateScanpaths!" << endl;
-	system("del gl_sts.cfg >nul 2>&1");  // delete genLayer and genScan status files.  >nul 2>&1 avoids output if file does not exist
-	system("del gs_sts.cfg >nul 2>&1");
-	system("del vconfig.txt >nul 2>&1"); // delete the svg-scaling output created by genLayer
-	system("del *.svg >nul 2>&1");		 // delete any slic3r outputs which weren't moved to an output folder
-	string deleteErrFileCommand;
-	deleteErrFileCommand = "del \"" + errorReportFilename + "\" >nul 2>&1";  // delete error reports from previous runs
-	system(deleteErrFileCommand.c_str());
+	deleteFile(shardFilename("gl_sts.cfg", shardId));	// delete genLayer and genScan status files.  Missing files are not an error
+	deleteFile(shardFilename("gs_sts.cfg", shardId));
+	if (shardId != "") {
+		// other shards may be running from this folder, so leave everything else alone
+		return true;
+	}
+	deleteFile("vConfig.txt");	// delete the svg-scaling output created by genLayer
+	deleteFilesWithExtension(".", ".svg");	// delete any slic3r outputs which weren't moved to an output folder
+	deleteFile(errorReportFilename);	// delete error reports from previous runs
 	return true;
 }
 
@@ -44,6 +148,7 @@ fileData selectConfigFile()
 	cout << "\nPlease select an AmericaMakes configuration file in the same folder as your STL files\n";
 
 	fileData userFile;
+#ifdef _WIN32
 	LPSTR filename[MAX_PATH];
 	ZeroMemory(&filename, sizeof(filename));
 	filename[0] = '\0';
@@ -78,28 +183,8 @@ fileData selectConfigFile()
 
 	if (GetOpenFileNameA(&ofn))
 	{
-		// User selected a file.  Convert items in wchar_t format to string via this process:
-		char DefChar1 = ' ';
-		//WideCharToMultiByte(CP_ACP, 0, ofn.lpstrFile, -1, ch1, 260, &DefChar1, NULL);
-		string fullFilePath = ofn.lpstrFile;
-		size_t periodPos = fullFilePath.find_last_of(".");
-		size_t slashPos = fullFilePath.find_last_of("\\");
-
-		userFile.extension = fullFilePath.substr(periodPos + 1);
-		userFile.filename = fullFilePath.substr(slashPos + 1);
-		userFile.filenamePlusPath = fullFilePath;
-		userFile.path = fullFilePath.substr(0, slashPos);
-
-		if (userFile.extension != "xls") {
-			// not the right kind of file for configuration
-			userFile.xlsFileSelected = false;
-			cout << "\n***You selected something which is not a .xls file***\nThis is not an AmericaMakes configuration file ... cancelling execution\n";
-		}
-		else {
-			// .xls file selected
-			userFile.xlsFileSelected = true;
-			cout << "Configuration file selected: " << fullFilePath << endl;
-		}	
+		// User selected a file
+		userFile = configFileFromPath(ofn.lpstrFile);
 	}
 	else
 	{
@@ -129,10 +214,57 @@ fileData selectConfigFile()
 			case FNERR_SUBCLASSFAILURE: std::cout << "FNERR_SUBCLASSFAILURE\n"; break;
 		}
 	}
+#else
+	// no file dialog on this platform, so ask for the path instead
+	cout << "Enter the path to the configuration file (.xls) and press Enter: ";
+	string fullFilePath;
+	getline(cin, fullFilePath);
+	if ((fullFilePath.size() > 1) && (fullFilePath.front() == '"') && (fullFilePath.back() == '"')) {
+		fullFilePath = fullFilePath.substr(1, fullFilePath.size() - 2);  // remove quotes around a pasted path
+	}
+	if (fullFilePath == "") {
+		cout << "\nFile selection cancelled\n";
+		userFile.xlsFileSelected = false;
+	}
+	else {
+		userFile = configFileFromPath(fullFilePath);
+	}
+#endif
 
 	return userFile;  // success
 }
 
+// fill in fileData for a configuration file named on the command line (or typed in by the user)
+fileData configFileFromPath(string fullFilePath)
+{
+	fileData userFile;
+	// use the full path, since createScanpaths works from the executable folder
+	fullFilePath = fs::absolute(fs::path(fullFilePath)).string();
+	size_t periodPos = fullFilePath.find_last_of(".");
+	size_t slashPos = fullFilePath.find_last_of(pathSeparators);
+
+	userFile.extension = fullFilePath.substr(periodPos + 1);
+	userFile.filename = fullFilePath.substr(slashPos + 1);
+	userFile.filenamePlusPath = fullFilePath;
+	userFile.path = fullFilePath.substr(0, slashPos);
+
+	if (userFile.extension != "xls") {
+		// not the right kind of file for configuration
+		userFile.xlsFileSelected = false;
+		cout << "\n***You selected something which is not a .xls file***\nThis is not an AmericaMakes configuration file ... cancelling execution\n";
+	}
+	else if (!fileExists(fullFilePath)) {
+		userFile.xlsFileSelected = false;
+		cout << "\n***The configuration file " << fullFilePath << " cannot be found***\nCancelling execution\n";
+	}
+	else {
+		// .xls file selected
+		userFile.xlsFileSelected = true;
+		cout << "Configuration file selected: " << fullFilePath << endl;
+	}
+	return userFile;
+}
+
 // assess folder structure at/below the project folder indicated in config file
 string evaluateProjectFolder(AMconfig &configData)
 {
@@ -142,7 +274,7 @@ string evaluateProjectFolder(AMconfig &configData)
 	// "LS" = project folder, layer subfolder and scan subfolder exist, and both layer_xxx.xml and scan_xxx.xml files are present
 
 	// 1. check if layer XML folder exists
-	string layerXMLFolder = configData.layerOutputFolder + "\\XMLdir";
+	string layerXMLFolder = configData.layerOutputFolder + pathSep + "XMLdir";
 	if (!dirExists(layerXMLFolder)) {
 		// layer xml folder doesn't exist, so there are no layer files and we'll assume no scan files either
 		return "";
@@ -160,7 +292,7 @@ string evaluateProjectFolder(AMconfig &configData)
 	// layer xml folder exists and contains xml files
 	//
 	// 3. see if the scan xml folder exists
-	string scanXMLFolder = configData.scanOutputFolder + "\\XMLdir";
+	string scanXMLFolder = configData.scanOutputFolder + pathSep + "XMLdir";
 	if (!dirExists(scanXMLFolder)) {
 		// indicate that there are layer files, but no scan folder or files
 		return "L";
@@ -298,6 +430,34 @@ string getUserOption(AMconfig &configData, string folderStatus)
 	return returnVal;
 }
 
+// convert --mode and --existing into the same choice codes returned by getUserOption
+string getCommandLineOption(const commandLineOptions &options, string folderStatus)
+{
+	// options.mode has already been checked to be "layer", "scan" or "both", so its first letter is the choice code
+	string returnVal = options.mode.substr(0, 1);
+	if ((returnVal == "s") & (folderStatus == "")) {
+		cout << "\nThe project folder has no existing layer files, so scan files cannot be generated.  Use --mode layer or --mode both\n";
+		return "c";
+	}
+	if (options.shardId != "") {
+		// shards always merge, since the project folder holds the output of the other shards too
+		return returnVal + "m";
+	}
+
+	if ((folderStatus == "") | ((folderStatus == "L") & (returnVal == "s"))) {
+		// no existing output is affected, so --existing is not needed (matches getUserOption)
+		return returnVal;
+	}
+	if (options.existing == "merge") {
+		returnVal += "m";
+	}
+	else if (options.existing != "delete") {
+		cout << "\nThe project folder contains existing output.  Use --existing delete or --existing merge to say what to do with it\n";
+		return "c";
+	}
+	return returnVal;
+}
+
 // set up folder structure for output
 int setupOutputFolders(AMconfig &configData, string userChoice)
 {
@@ -309,14 +469,24 @@ int setupOutputFolders(AMconfig &configData, string userChoice)
 	//	"b"  = Delete the layer and scan folders, if they exist.  Set up a new layer and scan folders
 	//	"bm" = do nothing - layer and scan folders already exist and new output will be merged with existing
 	//
-	// To simplify this, if the character "m" is appended to userChoice, we can quit this routine immediately
+	// To simplify this, if the character "m" is appended to userChoice, we only create any folders which are missing
+	// (the first shard to start creates them for the rest)
 	//
 	// return value = 0 if all is well, 1 if error
 
 	if (userChoice.size() == 2) {
 		if (userChoice[1] == 'm') {
-			// merge new and old output.  folders already exist, so no further action required
-			return 0;
+			// merge new and old output.  createFolder leaves existing folders and their contents alone
+			bool created = true;
+			if ((userChoice[0] == 'l') | (userChoice[0] == 'b')) {
+				created &= createFolder(configData.layerOutputFolder + pathSep + "XMLdir");
+				if (configData.createLayerSVG == true) { created &= createFolder(configData.layerOutputFolder + pathSep + "SVGdir"); }
+			}
+			if ((userChoice[0] == 's') | (userChoice[0] == 'b')) {
+				created &= createFolder(configData.scanOutputFolder + pathSep + "XMLdir");
+				if (configData.createScanSVG == true) { created &= createFolder(configData.scanOutputFolder + pathSep + "SVGdir"); }
+			}
+			return created ? 0 : 1;
 		}
 	}
 	
@@ -328,7 +498,6 @@ int setupOutputFolders(AMconfig &configData, string userChoice)
 	bool scanFolderExists = false;
 
 	try {
-		string mdir, rdir; // used to generate system command strings (mdir to make directories, rdir to remove them)
 		if (dirExists(configData.projectFolder)) {
 			projectFolderExists = true;
 			if (dirExists(configData.layerOutputFolder)) {
@@ -342,45 +511,34 @@ int setupOutputFolders(AMconfig &configData, string userChoice)
 		// If the project folder itself does not exist, create it
 		if (!projectFolderExists) {
 			cout << "Creating project folder " << configData.projectFolder << endl;
-			mdir = "mkdir \"" + configData.projectFolder + "\" >nul 2>&1";
-			system(mdir.c_str());
+			if (!createFolder(configData.projectFolder)) { return 1; }
 		}
 
 		// Delete the scan folder, if it exists, in all cases
 		// this is because we do not want to retain scan outputs which are potentially incompatible with new layer outputs
 		if (scanFolderExists) {
-			rdir = "rmdir \"" + configData.scanOutputFolder + "\" /s /q >nul 2>&1";
-			system(rdir.c_str());
+			if (!deleteFolder(configData.scanOutputFolder)) { return 1; }
 		}
 
 		// Delete/recreate the layer folder, if userChoice is "l" or "b"
 		if (userChoice == "l" | userChoice == "b") {
 			// delete the layer folder, if it exists
 			if (layerFolderExists) {
-				rdir = "rmdir \"" + configData.layerOutputFolder + "\" /s /q >nul 2>&1";
-				system(rdir.c_str());
+				if (!deleteFolder(configData.layerOutputFolder)) { return 1; }
 			}
 			cout << "Creating layer folder " << configData.layerOutputFolder << endl;
-			mdir = "mkdir \"" + configData.layerOutputFolder + "\" >nul 2>&1";
-			system(mdir.c_str());
-			mdir = "mkdir \"" + configData.layerOutputFolder + "\\XMLdir\" >nul 2>&1";
-			system(mdir.c_str());
+			if (!createFolder(configData.layerOutputFolder + pathSep + "XMLdir")) { return 1; }
 			if (configData.createLayerSVG == true) {
-				mdir = "mkdir \"" + configData.layerOutputFolder + "\\SVGdir\" >nul 2>&1";
-				system(mdir.c_str());
+				if (!createFolder(configData.layerOutputFolder + pathSep + "SVGdir")) { return 1; }
 			}
 		}
 
 		// Recreate the scan folder, if userChoice is "s" or "b"
 		if (userChoice == "s" | userChoice == "b") {
 			cout << "Creating scan folder " << configData.scanOutputFolder << endl;
-			mdir = "mkdir \"" + configData.scanOutputFolder + "\" >nul 2>&1";
-			system(mdir.c_str());
-			mdir = "mkdir \"" + configData.scanOutputFolder + "\\XMLdir\" >nul 2>&1";
-			system(mdir.c_str());
+			if (!createFolder(configData.scanOutputFolder + pathSep + "XMLdir")) { return 1; }
 			if (configData.createLayerSVG == true) {
-				mdir = "mkdir \"" + configData.scanOutputFolder + "\\SVGdir\" >nul 2>&1";
-				system(mdir.c_str());
+				if (!createFolder(configData.scanOutputFolder + pathSep + "SVGdir")) { return 1; }
 			}
 		}
 		return 0;  // folder structure is properly set up
@@ -392,57 +550,31 @@ int setupOutputFolders(AMconfig &configData, string userChoice)
 }
 
 // run layer or scan generation
-int callGenerationCode(string sysCommand, string statusFilename)
+int callGenerationCode(vector<string> command, string statusFilename)
 {
-	// sysCommand should include either genLayer or genScan plus full path to the configuration file
+	// command should hold the full path to either genLayer or genScan, followed by the full path to the configuration file
 	// statusFilename should be either the executable folder path plus \gl_sts.cfg or \gs_sts.cfg
-	LPSTR cmdLine = _strdup(sysCommand.c_str());
+	string commandText = "\"" + command[0] + "\"";
+	for (size_t a = 1; a < command.size(); a++) { commandText += " \"" + command[a] + "\""; }
 
 	int finished = 0;
 	sts cst;  // status structure; initialized to started=false, lastLayer=0, finished=0, dn="NULL"
-	STARTUPINFOA si;
-	PROCESS_INFORMATION pi;
-	// set the size of the structures
-	ZeroMemory(&si, sizeof(si));
-	si.cb = sizeof(si);
-	ZeroMemory(&pi, sizeof(pi));
-	DWORD exit_code;
+	int exit_code = 0;
 
 	// iterate until finished or error encountered
 	while (!finished)
 	{
-		if (!CreateProcessA(
-			NULL,		// lpApplicationName
-			cmdLine,    // Command line (needs to include app path as first argument)
-			NULL,       // Process handle not inheritable
-			NULL,       // Thread handle not inheritable
-			FALSE,      // Set handle inheritance to FALSE
-			0,		    // Opens file in a same window
-			NULL,       // Use parent's environment block
-			NULL,       // starting directory - doesn't work as a parameter, so we need to specify the starting directory before calling CreateProcess
-			&si,        // Pointer to STARTUPINFO structure
-			&pi         // Pointer to PROCESS_INFORMATION structure
-		)
-			) {
-			cout << "*** Unable to start a new process via\n" << sysCommand << endl;
-			system("pause\n");
+#if TRACEEVENTS
+		// one span per child process launch, each of which processes a batch of layers
+		traceScope launchTrace("child process", "createScanpaths");
+		launchTrace.addArg("command", commandText);
+#endif
+		// launch the child process and wait until it exits
+		if (!runProcess(command, exit_code)) {
+			cout << "*** Unable to start a new process via\n" << commandText << endl;
+			pauseForUser();
 			return -1;
 		}
-		// Wait until child process exits
-		WaitForSingleObject(pi.hProcess, INFINITE);
-		// check return code from the executable
-		if (FALSE == GetExitCodeProcess(pi.hProcess, &exit_code))
-		{
-			std::cerr << "GetExitCodeProcess() failure: " <<
-				GetLastError() << "\n";
-		}
-		else if (STILL_ACTIVE == exit_code)
-		{
-			std::cout << "Still running\n";
-		}
-		// Close process and thread handles
-		CloseHandle(pi.hProcess);
-		CloseHandle(pi.hThread);
 
 		if (exit_code != 0) {
 			// generation returned an error; don't process additional layers
@@ -452,6 +584,9 @@ int callGenerationCode(string sysCommand, string statusFilename)
 			// no error; see what the generation routine sent back as status
 			cst = readStatus(statusFilename);
 			finished = cst.finished;
+#if TRACEEVENTS
+			launchTrace.addArg("lastLayer", to_string(cst.lastLayer));
+#endif
 		}
 	}
 
@@ -459,21 +594,29 @@ int callGenerationCode(string sysCommand, string statusFilename)
 }
 
 // perform final cleanup after layer or scan generation
-bool cleanupOnFinish()
+bool cleanupOnFinish(string shardId)
 {
 	// we should be working in the executable folder
-	system("del gl_sts.cfg >nul 2>&1");	 // delete the temporary status file created by genLayer
-	system("del gs_sts.cfg >nul 2>&1");	 // delete the temporary status file created by genScan
-	system("del vconfig.txt >nul 2>&1"); // delete the svg-dimension file (which should have been moved to the layer folder)
-	system("del *.svg >nul 2>&1");		 // delete any stray svg files (which should have been moved to the layer folder)
+	deleteFile(shardFilename("gl_sts.cfg", shardId));	// delete the temporary status file created by genLayer
+	deleteFile(shardFilename("gs_sts.cfg", shardId));	// delete the temporary status file created by genScan
+	if (shardId != "") { return true; }	// leave shared files to the other shards
+	deleteFile("vConfig.txt");	// delete the svg-dimension file (which should have been moved to the layer folder)
+	deleteFilesWithExtension(".", ".svg");	// delete any stray svg files (which should have been moved to the layer folder)
 	return true;
 }
 
 // create a zip file containing the scan XML files
 bool createScanZipfile(AMconfig &configData) {
+	TIME_STAGE("createScanZipfile");
 	// try/catch in case of error
 	try {
 		cout << "Creating a .scn (zip) file containing the scan output files\n";
+		string scanXMLfolder = configData.scanOutputFolder + pathSep + "XMLdir" + pathSep;
+		string fname, pname;
+		int xmlCount = 0;  // number of XML files found and added to zip
+		consoleProgress progress;  // rewrites the "Adding" line for each file
+
+#ifdef _WIN32
 		// create a zip file in the executable folder.  If everything goes smoothly, we'll later change its extension to .scn
 		HZIP hz = CreateZip(__T("scanpath_files.zip"), 0);
 		if (hz == 0) {
@@ -481,17 +624,7 @@ bool createScanZipfile(AMconfig &configData) {
 			cout << "*** Was not able to create scanpath_files.zip in the executable folder\n    Cancelling zip\n";
 			return 1;
 		}
-
-		string scanXMLfolder = configData.scanOutputFolder + "\\XMLdir\\";
-		string fname, pname, sysCommand;
 		ZRESULT fnResult;  // format for zip.cpp results
-		int xmlCount = 0;  // number of XML files found and added to zip
-
-		// Identify current cursor position
-		COORD cursorPosition;
-		HANDLE hStdout;
-		hStdout = GetStdHandle(STD_OUTPUT_HANDLE);
-		cursorPosition = GetConsoleCursorPosition(hStdout);
 
 		// search for and iterate over xml files in the scan output folder
 		for (auto& p : fs::directory_iterator(scanXMLfolder))
@@ -500,9 +633,7 @@ bool createScanZipfile(AMconfig &configData) {
 			{	// found an xml file
 				fname = p.path().stem().string() + ".xml";  // filename without path
 				pname = p.path().string();					// full path to the file
-				cout << "   Adding " << fname;
-				// reset cursor position for next iteration
-				SetConsoleCursorPosition(hStdout, cursorPosition);
+				progress.update("   Adding " + fname);
 
 				// create wstring versions of fname and pname
 				LPCSTR wsf, wsp;
@@ -529,6 +660,24 @@ bool createScanZipfile(AMconfig &configData) {
 
 		// wrap up
 		CloseZip(hz);
+#else
+		// zip.cpp uses the Win32 API, so use the zip command-line tool instead.
+		// -r -j adds the folder's files without their folder names, -i keeps only the xml files
+		for (auto& p : fs::directory_iterator(scanXMLfolder))
+		{
+			if (p.path().extension() == ".xml") { xmlCount++; }
+		}
+		if (xmlCount > 0) {
+			vector<string> zipCommand = { zipExecutable, "-q", "-r", "-j", "scanpath_files.zip", scanXMLfolder, "-i", "*.xml" };
+			int zipExitCode;
+			progress.update("   Adding " + to_string(xmlCount) + " files");
+			if (!runProcess(zipCommand, zipExitCode) || (zipExitCode != 0)) {
+				cout << "\n*** Was not able to create scanpath_files.zip in the executable folder using " << zipExecutable << "\n    Cancelling zip\n";
+				deleteFile("scanpath_files.zip");
+				return 1;
+			}
+		}
+#endif
 
 		// if xmlCount > 0, we'll consider it valid.
 		// change the archive's extension to .scn and move it to project folder, else delete it and alert the user
@@ -537,12 +686,10 @@ bool createScanZipfile(AMconfig &configData) {
 			
 			// change extension to the .scn expected by LabVIEW
 			cout << "Changing extension to .scn... ";
-			sysCommand = "rename scanpath_files.zip scanpath_files.scn";
-			system(sysCommand.c_str());
+			fs::rename("scanpath_files.zip", "scanpath_files.scn");
 
 			// move the scn file to the project folder
-			sysCommand = "move scanpath_files.scn \"" + configData.projectFolder + "\" >nul 2>&1";
-			system(sysCommand.c_str());
+			moveFilesWithExtension(".", ".scn", configData.projectFolder);
 			cout << "\nDone! scanpath_files.scn contains " << xmlCount << " files and is located in\n" << configData.projectFolder << endl << endl;
 			// report success
 			return 0;
@@ -551,7 +698,8 @@ bool createScanZipfile(AMconfig &configData) {
 		{
 			cout << "\nNo XML files were found in the scan folder, or at least none which could be accessed\nThe zip archive has been deleted\n";
 			// delete the zip or scn file, if it exists
-			system("del scanpath_files.* >nul 2>&1");
+			deleteFile("scanpath_files.zip");
+			deleteFile("scanpath_files.scn");
 			return 1;
 		}
 	}
@@ -559,10 +707,57 @@ bool createScanZipfile(AMconfig &configData) {
 		// something went wrong!
 		cout << "\nWe encountered an unknown error while zipping the xml files\nZip has been deleted\n";
 		// delete the zip file, if it exists
-		system("del scanpath_files.* >nul 2>&1");
+		deleteFile("scanpath_files.zip");
+		deleteFile("scanpath_files.scn");
 		return 1;
 	}
 
 	// cleanup - should have exited the function via one of the return statements above
 	return 1;
 }
+
+// check the manifests written by layer and/or scan shards, then write layer_header.xml (via genLayer) and the .scn file
+int mergeShardOutput(AMconfig &configData, bool batch)
+{
+	// return value = 0 if all is well, 1 if the shards could not be merged
+	errorCheckStructure errorData;
+	vector<shardManifest> layerManifests = readManifests(configData.layerOutputFolder, "layer");
+	vector<shardManifest> scanManifests = readManifests(configData.scanOutputFolder, "scan");
+	if ((layerManifests.size() == 0) & (scanManifests.size() == 0)) {
+		cout << "\nNo shard manifests were found below " << configData.projectFolder << "\nRun the shards (--shard and --layers) before merging\n";
+		return 1;
+	}
+
+	// 1. Layer shards: genLayer checks their manifests and writes the header file for the combined layers
+	if (layerManifests.size() > 0) {
+		cout << "\nMerging " << layerManifests.size() << " layer shards\n";
+		vector<string> command = { configData.executableFolder + pathSep + "genLayer", configData.configFilename, "--merge" };
+		if (batch) { command.push_back("--batch"); }
+		int exitCode;
+		if (!runProcess(command, exitCode) || (exitCode != 0)) {
+			cout << "We encountered an error while merging the layer shards\n";
+			return 1;
+		}
+	}
+
+	// 2. Scan shards: check their manifests, then collect the scan files into the .scn archive
+	if (scanManifests.size() > 0) {
+		cout << "\nMerging " << scanManifests.size() << " scan shards\n";
+		vector<string> problems;
+		vector<manifestEntry> entries = mergeManifests(scanManifests, configData.scanOutputFolder + pathSep + "XMLdir", "scan_", problems);
+		if ((problems.size() == 0) & (entries.size() == 0)) { problems.push_back("The scan shards did not produce any layers"); }
+		if (problems.size() > 0) {
+			for (size_t p = 0; p + 1 < problems.size(); p++) {
+				updateErrorResults(errorData, false, "mergeShardOutput", problems[p] + "\n", "", configData.configFilename, configData.configPath);
+			}
+			updateErrorResults(errorData, true, "mergeShardOutput", problems.back() + "\n", "", configData.configFilename, configData.configPath);
+			return 1;
+		}
+		cout << "Layers " << entries.front().layer << "-" << entries.back().layer << " are complete\n";
+		if (configData.createScanZIPfile == true) {
+			deleteFile(configData.projectFolder + pathSep + "scanpath_files.scn");
+			if (createScanZipfile(configData) != 0) { return 1; }
+		}
+	}
+	return 0;
+}
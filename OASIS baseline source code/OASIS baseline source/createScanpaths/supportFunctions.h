@@ -16,19 +16,13 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 
 #pragma once
 
-#include <filesystem>
 #include <cctype>
-#include <windows.h>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <vector>
 #include <stdlib.h>
 #include <stdio.h>
-#include <msxml6.h>
-#include <comdef.h>
-#include <tchar.h>
-#include <conio.h>
 #include <sstream>
 #include <math.h>
 #include <chrono>
@@ -40,8 +34,14 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 #include "errorChecks.h"
 #include "io_functions.h"
 #include "constants.h"
+#include "platform.h"
+#include "shardManifest.h"
 
+#ifdef _WIN32
+#include <windows.h>	// file dialog and file handles for zip.cpp
+#include <tchar.h>
 #include "zip.h"
+#endif
 
 #ifndef NOMINMAX
 #define NOMINMAX
@@ -55,27 +55,54 @@ struct fileData
 	string filenamePlusPath, filename, path, extension;
 };
 
+// options given on the command line.  With no options, createScanpaths asks the user for everything as before
+//	createScanpaths [config.xls | --config config.xls] [--mode layer|scan|both] [--existing delete|merge] [--batch]
+//	                [--shard id --layers first-last | --merge]
+struct commandLineOptions
+{
+	bool valid = true;			// false if an option was not recognized or is missing its value
+	string configFile = "";		// configuration file; "" = ask the user to select one
+	string mode = "";			// "layer", "scan" or "both"; "" = ask the user
+	string existing = "";		// "delete" or "merge" existing output; "" = ask the user if there is existing output
+	bool batch = false;			// never prompt or pause.  Requires configFile and mode
+	string shardId = "";		// generate only layerRange, as this shard; "" = all layers
+	string layerRange = "";		// <first>-<last>, passed on to genLayer and genScan.  Requires shardId
+	bool merge = false;			// combine the output of all shards instead of generating anything
+};
+
+
+// parse the command-line arguments into commandLineOptions, reporting any problems to the console
+commandLineOptions parseCommandLine(int argc, char **argv);
 
-// delete any runtime configuration and SVG files from prior runs
-bool cleanupOnStart();
+// delete any runtime configuration and SVG files from prior runs.  A shard only removes its own status files
+bool cleanupOnStart(string shardId);
 
 // allow user to navigate to and select a configuration file
 fileData selectConfigFile();
 
+// fill in fileData for a configuration file named on the command line (or typed in by the user)
+fileData configFileFromPath(string fullFilePath);
+
 // assess folder structure at/below the project folder indicated in config file
 string evaluateProjectFolder(AMconfig &configData);
 
 // provide the user with options based on existing layer and/or scan folders
 string getUserOption(AMconfig &configData, string folderStatus);
 
+// convert --mode and --existing into the same choice codes returned by getUserOption
+string getCommandLineOption(const commandLineOptions &options, string folderStatus);
+
 // set up folder structure for output
 int setupOutputFolders(AMconfig &configData, string userChoice);
 
-// run layer or scan generation
-int callGenerationCode(string sysCommand, string statusFilename);
+// run layer or scan generation.  command holds the executable path followed by its arguments
+int callGenerationCode(vector<string> command, string statusFilename);
 
 // perform final cleanup after layer or scan generation, irrespective of success.  Does not affect error result file, if any
-bool cleanupOnFinish();
+bool cleanupOnFinish(string shardId);
 
 // create a zip file containing the scan XML files
 bool createScanZipfile(AMconfig &configData);
+
+// check the manifests written by layer and/or scan shards, then write layer_header.xml (via genLayer) and the .scn file
+int mergeShardOutput(AMconfig &configData, bool batch);
@@ -19,9 +19,13 @@ layers of the resulting SVG file to identify vertices and edges
 //============================================================*/
 
 #include "SliceFuns.h"
+#include "stlMesh.h"
+#include "runReport.h"
+#include "constants.h"
 
-int runSlic3r(string fn, double layerThickness_mm, string executableFolder)
+int runSlic3r(string fn, double layerThickness_mm, string executableFolder, string svgFile)
 {   
+	TIME_STAGE("runSlic3r");
 	// executableFolder is the directory in which generateScanpaths.exe appears.  Slic3r should be in a slic3r_130 folder below that
 	// fn is the stl filename including full path and .stl extension
 	//
@@ -33,27 +37,25 @@ int runSlic3r(string fn, double layerThickness_mm, string executableFolder)
 	//		however we needed to choose the resolution to balance accuracy and error.  5um (0.005mm) seems to work well
 	
 	// create a Slic3r command that includes filename, SVG slice & export, layer height and other options
-	string command = "slic3r_130\\slic3r.exe \"" + fn + "\" --export-svg --no-gui --layer-height ";		// slic3r call plus filename
-	command += to_string(layerThickness_mm) + " --first-layer-height " + to_string(layerThickness_mm);	// options
-	command += " --resolution 0.005";	// additional options (added 2020-07-21)
+	vector<string> command = { executableFolder + pathSep + slic3rExecutable, fn, "--export-svg", "--no-gui" };	// slic3r call plus filename
+	command.insert(command.end(), { "--layer-height", to_string(layerThickness_mm), "--first-layer-height", to_string(layerThickness_mm) });	// options
+	command.insert(command.end(), { "--resolution", "0.005" });	// additional options (added 2020-07-21)
+	if (svgFile != "") { command.insert(command.end(), { "--output", svgFile }); }
 	cout << "Slicing " << fn << "... ";
-	// system call.  slic3r always returns 0 even when there's an error, so we don't evaluate the return value
-	system(command.c_str());
+	// slic3r always returns 0 even when there's an error, so we don't evaluate the return value
+	int slic3rExitCode;
+	runProcess(command, slic3rExitCode);
 	cout << "Done\n";
 
 	// check whether the SVG file was actually created
 	int outputFlag = -1;  // return value where 0 = valid svg file
-	// Generate the expected svg filename by replacing .stl with .svg
+	// Generate the expected svg filename by replacing .stl with .svg, unless the output was directed elsewhere
 	int len = strlen(fn.c_str());
-	string svg_fn = fn.substr(0, len - 4) + ".svg";
-	// evaluate attributes of this file
-	DWORD ftyp = GetFileAttributesA(svg_fn.c_str());
-	if (ftyp == INVALID_FILE_ATTRIBUTES) {
-		outputFlag = -1;      // SVG file was not created
+	string svg_fn = (svgFile != "") ? svgFile : fn.substr(0, len - 4) + ".svg";
+	if (fileExists(svg_fn)) {
+		outputFlag = 0;   // SVG file exists!
 	} else {
-		if (ftyp) {
-			outputFlag = 0;   // SVG file exists!
-		}
+		outputFlag = -1;  // SVG file was not created
 	}
 
 	return outputFlag;
@@ -62,6 +64,7 @@ int runSlic3r(string fn, double layerThickness_mm, string executableFolder)
 
 int readFile(string fn, long numLayer, layer* L, string rTag, string cSys, int cTraj, int hTraj)
 {
+	TIME_STAGE("readFile");
 	size_t			pos = 0;
 	string			line, sub;
 	long ctLayer = 0;
@@ -71,6 +74,7 @@ int readFile(string fn, long numLayer, layer* L, string rTag, string cSys, int c
 	double			Units = 0.0;
 	long			Layer = 0, Power = 0, Speed = 0, Focus = 0;//for iterating data per layer
 	ifstream		file(fn);
+	L->cordSys = cSys;
 	
 	vector<loop> lp;
 	slice sl;
@@ -119,28 +123,24 @@ int readFile(string fn, long numLayer, layer* L, string rTag, string cSys, int c
 				if (!looptype.compare("contour"))
 				{					
 					string vlist = getVlist(ss.str(),1);
-					vector<vertex> vl;
-					getVertices(vlist, vl, cSys);
 					loop r;
+					getVertices(vlist, r.vList);
 					r.type = "Outer";
 					r.tag = rTag;
 					r.contourTraj = cTraj;
 					r.hatchTraj = hTraj;
-					r.vList = vl;
-					lp.push_back(r);
+					lp.push_back(move(r));
 				}
 				else if (!looptype.compare("hole"))
 				{
 					string vlist = getVlist(ss.str(),2);
-					vector<vertex> vl;
-					getVertices(vlist, vl, cSys);
 					loop r;
+					getVertices(vlist, r.vList);
 					r.type = "Inner";
 					r.tag = rTag;
 					r.contourTraj = cTraj;
 					r.hatchTraj = hTraj;
-					r.vList = vl;
-					lp.push_back(r);
+					lp.push_back(move(r));
 				}
 			}
 		}
@@ -149,8 +149,8 @@ int readFile(string fn, long numLayer, layer* L, string rTag, string cSys, int c
 			
 			if (clayer == 1)
 			{			
-				sl.lpList = lp;
-				L->us = sl;
+				sl.lpList = move(lp);
+				L->us = move(sl);
 				return eof;
 			}			
 		}
@@ -174,9 +174,11 @@ string getVlist(string s, int type)
 	return vlist;
 }
 
-void getVertices(string vs, vector<vertex>& vl, string cSys)
+void getVertices(const string &vs, vector<vertex>& vl)
 {
 	vertex v;
+	v.z = 0;
+	vl.reserve(vl.size() + count(vs.begin(), vs.end(), ' ') + 1);	// one vertex per space-separated "x,y" pair
 	istringstream vss;
 	size_t vpos = 0;
 	vss.str(vs);
@@ -202,18 +204,17 @@ void getVertices(string vs, vector<vertex>& vl, string cSys)
 			sy = sy.substr(0, strlen(sy.c_str()) - 1);
 		v.x = atof(sx.c_str());
 		v.y = atof(sy.c_str());
-		v.cord_sys = cSys;
 		vl.push_back(v);
 	}
 	
 }
 
-void displayLayer(layer L)
+void displayLayer(const layer &L)
 {
 	cout << "Z Height: " << L.zHeight << endl;
-	slice s = L.us;
+	const slice &s = L.us;
 	cout << "Number of Loops : " << (s.lpList).size() << endl;
-	for (vector<loop>::iterator lt = (s.lpList).begin(); lt != (s.lpList).end(); ++lt)
+	for (vector<loop>::const_iterator lt = (s.lpList).begin(); lt != (s.lpList).end(); ++lt)
 	{
 		cout << "Loop Type:  " << (*lt).type << endl;
 		cout << "No. of vertices: " << ((*lt).vList).size() << endl;
@@ -222,17 +223,22 @@ void displayLayer(layer L)
 
 void refineLayer(layer *L)
 {
-	slice s = L->us;	// extract the upper slice bounding layer L
+	TIME_STAGE("refineLayer");
+	slice &s = L->us;	// the upper slice bounding layer L, updated in place
 	vector<vertex> vList;	// vList initially has no contents
-	vector<edge> eList;
 	edge e;
 	int idx;
 	vertex sv, fv;
-	int cnt = 0;
-	for (vector<loop>::iterator lt = (s.lpList).begin(); lt != (s.lpList).end(); ++lt)	// iterate across loops in the upper slice s
+	size_t numVertices = 0;
+	for (vector<loop>::const_iterator lt = (s.lpList).begin(); lt != (s.lpList).end(); ++lt) { numVertices += (*lt).vList.size(); }
+	vList.reserve(numVertices);	// at most one entry per loop vertex
+	(s.rList).reserve((s.rList).size() + (s.lpList).size());
+	for (vector<loop>::const_iterator lt = (s.lpList).begin(); lt != (s.lpList).end(); ++lt)	// iterate across loops in the upper slice s
 	{
-		eList.clear();	
-		region r;
+		(s.rList).push_back(region());
+		region &r = (s.rList).back();
+		vector<edge> &eList = r.eList;
+		eList.reserve((*lt).vList.size());	// one edge per vertex, including the closing edge
 		sv = (*lt).vList[0];	// sv is the first vertex of the current loop lt
 		int idx_s = findVertex(vList, sv);
 		if (idx_s >= 0)
@@ -244,7 +250,7 @@ void refineLayer(layer *L)
 			idx_s = e.start_idx;
 		}	
 		
-		for (vector<vertex>::iterator vt = ((*lt).vList).begin()+1; vt != ((*lt).vList).end(); ++vt)
+		for (vector<vertex>::const_iterator vt = ((*lt).vList).begin()+1; vt != ((*lt).vList).end(); ++vt)
 		{			
 			fv = *vt;
 			idx = findVertex(vList, fv);
@@ -261,18 +267,15 @@ void refineLayer(layer *L)
 		}
 		e.end_idx = idx_s;
 		eList.push_back(e);
-		r.eList = eList;
 		r.type = (*lt).type;
 		r.tag = (*lt).tag;
 		r.contourTraj = (*lt).contourTraj;
 		r.hatchTraj = (*lt).hatchTraj;
-		(s.rList).push_back(r);
 	}
-	L->vList = vList;
-	L->us = s;
+	L->vList = move(vList);
 }
 
-int cmpVertex(vertex v1, vertex v2)
+int cmpVertex(const vertex &v1, const vertex &v2)
 {
 	int match = 0;
 	if (v1.x == v2.x)
@@ -283,9 +286,9 @@ int cmpVertex(vertex v1, vertex v2)
 	return match;
 }
 
-int findVertex(vector<vertex> vList, vertex v)
+int findVertex(const vector<vertex> &vList, const vertex &v)
 {
-	for (vector<vertex>::iterator vt = vList.begin(); vt != vList.end(); ++vt)
+	for (vector<vertex>::const_iterator vt = vList.begin(); vt != vList.end(); ++vt)
 	{
 		if (vt->x == v.x)
 		{
@@ -311,22 +314,22 @@ int findVertex(vector<vertex> vList, vertex v)
 }
 */
 
-void displayFLayer(layer L)
+void displayFLayer(const layer &L)
 {
 
 	cout << "Z Height: " << L.zHeight << endl;
-	slice s = L.us;
+	const slice &s = L.us;
 	cout << "===================VertexList=====================" << endl;
-	for (vector<vertex>::iterator vt = (L.vList).begin(); vt != (L.vList).end(); ++vt)
+	for (vector<vertex>::const_iterator vt = (L.vList).begin(); vt != (L.vList).end(); ++vt)
 	{
 		cout << (*vt).x << "," << (*vt).y << endl;
 	}
 	cout << "===================Slice=====================" << endl;
 	cout << "Number of Regions: " << (s.rList).size() << endl;
-	for (vector<region>::iterator rt = (s.rList).begin(); rt != (s.rList).end(); ++rt)
+	for (vector<region>::const_iterator rt = (s.rList).begin(); rt != (s.rList).end(); ++rt)
 	{
 		cout << "Region Type:  " << (*rt).type << endl;
-		for (vector<edge>::iterator et = ((*rt).eList).begin(); et != ((*rt).eList).end(); ++et)
+		for (vector<edge>::const_iterator et = ((*rt).eList).begin(); et != ((*rt).eList).end(); ++et)
 		{
 			cout << (*et).start_idx << "," << (*et).end_idx << endl;
 		}
@@ -357,255 +360,199 @@ int getNumLayer(string fn)
 	return nlayer;
 }
 
-layer combLayer(vector<layer> vL)
+layer combLayer(const vector<layer> &vL)
 {
 	layer L;
 	int firstLayer = 1;
-	for (vector<layer>::iterator lt = vL.begin(); lt != vL.end(); ++lt)
+	size_t numLoops = 0;
+	for (vector<layer>::const_iterator lt = vL.begin(); lt != vL.end(); ++lt)
+	{
+		if (!(*lt).isEmpty) { numLoops += (*lt).us.lpList.size(); }
+	}
+	for (vector<layer>::const_iterator lt = vL.begin(); lt != vL.end(); ++lt)
 	{
 		if (!(*lt).isEmpty)
 		{
 			if (firstLayer)
 			{
 				L = *lt;
+				(L.us.lpList).reserve(numLoops);
 				firstLayer = 0;
 			}
 			else
 			{
-				slice s, st;
-				s = L.us;
-				st = (*lt).us;
-				(s.lpList).insert((s.lpList).end(), (st.lpList).begin(), (st.lpList).end());
-				L.us = s;
-				firstLayer = 0;
+				const vector<loop> &st = (*lt).us.lpList;
+				(L.us.lpList).insert((L.us.lpList).end(), st.begin(), st.end());
 			}
 		}
 	}
 	return L;
 }
 
-void scaleLayer(layer *L, double mag, double xo, double yo)
+// squared distance from p to the segment a-b
+static double segmentDistance2(const vertex &p, const vertex &a, const vertex &b)
 {
-	slice s = L->us;	
-	vertex v;	
-	for (vector<loop>::iterator lt = (s.lpList).begin(); lt != (s.lpList).end(); ++lt)
-	{
-
-		for (vector<vertex>::iterator vt = ((*lt).vList).begin(); vt != ((*lt).vList).end(); ++vt)
-		{
-			v.x = (*vt).x*mag + xo*mag;
-			v.y = (*vt).y*mag + yo*mag;
-			(*vt) = v;
-		}		
-	}
-	L->us = s;
+	double dx = b.x - a.x, dy = b.y - a.y;
+	double len2 = dx*dx + dy*dy;
+	double t = (len2 > 0) ? ((p.x - a.x)*dx + (p.y - a.y)*dy) / len2 : 0.0;
+	t = min(max(t, 0.0), 1.0);
+	double ex = a.x + t*dx - p.x, ey = a.y + t*dy - p.y;
+	return ex*ex + ey*ey;
 }
 
-vertex findOffset(string fn)
+size_t simplifyLayer(layer *L, double tolerance_mm)
 {
-	vertex vMin, vTmp;
-
-	//get first vertex and assign it to vMax and vMin;
-	size_t			pos = 0;
-	string			line, sub;
-	ifstream		file(fn);
-	int isFirst = 1;
-	while (getline(file, line))
+	TIME_STAGE("simplifyLayer");
+	size_t removed = 0;
+	if (tolerance_mm <= 0) { return removed; }
+	double tolerance2 = tolerance_mm*tolerance_mm;
+	vector<char> keep;
+	vector<pair<size_t, size_t>> spans;	// runs of vertices still to be simplified, as (first, last); index n is vertex 0 again
+	for (vector<loop>::iterator lt = L->us.lpList.begin(); lt != L->us.lpList.end(); ++lt)
 	{
-		if (string::npos != line.find("vertex"))
+		vector<vertex> &vList = (*lt).vList;
+		size_t n = vList.size();
+		if (n < 4) { continue; }
+
+		// a closed loop has no end points, so split it at vertex 0 and the vertex farthest from it
+		size_t farthest = 0;
+		double farthest2 = 0.0;
+		for (size_t k = 1; k < n; k++)
 		{
-			pos = line.find("vertex");
-			line = line.substr(pos + 7);
-			istringstream	ss;
-			ss.str(line);
-			getline(ss, sub, ' ');
-			getline(ss, sub, ' ');
-			vTmp.x = atof(sub.c_str());
-			getline(ss, sub, ' ');
-			vTmp.y = atof(sub.c_str());
-			getline(ss, sub, ' ');
-			vTmp.z = atof(sub.c_str());
-			if (isFirst)
+			double d2 = (vList[k].x - vList[0].x)*(vList[k].x - vList[0].x) + (vList[k].y - vList[0].y)*(vList[k].y - vList[0].y);
+			if (d2 > farthest2) { farthest2 = d2; farthest = k; }
+		}
+		if (farthest == 0) { continue; }
+		keep.assign(n, 0);
+		keep[0] = keep[farthest] = 1;
+		spans.clear();
+		spans.push_back(make_pair((size_t)0, farthest));
+		spans.push_back(make_pair(farthest, n));
+
+		// Douglas-Peucker: keep the vertex of a run farthest from its chord if it is beyond the tolerance, and split the run there
+		while (spans.size() > 0)
+		{
+			size_t first = spans.back().first, last = spans.back().second;
+			spans.pop_back();
+			const vertex &a = vList[first], &b = vList[last % n];
+			size_t worst = 0;
+			double worst2 = tolerance2;
+			for (size_t k = first + 1; k < last; k++)
 			{
-				isFirst = 0;
-				vMin = vTmp;
+				double d2 = segmentDistance2(vList[k], a, b);
+				if (d2 > worst2) { worst2 = d2; worst = k; }
 			}
-			else
-			{
-				if (vTmp.x < vMin.x)
-					vMin.x = vTmp.x;
-				if (vTmp.y < vMin.y)
-					vMin.y = vTmp.y;
-				if (vTmp.z < vMin.z)
-					vMin.z = vTmp.z;
+			if (worst != 0) {
+				keep[worst] = 1;
+				spans.push_back(make_pair(first, worst));
+				spans.push_back(make_pair(worst, last));
 			}
 		}
 
+		size_t kept = 0;
+		for (size_t k = 0; k < n; k++) { kept += keep[k]; }
+		if (kept < 3) { continue; }  // the whole loop is within the tolerance of a line; leave it as it is
+		size_t out = 0;
+		for (size_t k = 0; k < n; k++)
+		{
+			if (keep[k]) { vList[out++] = vList[k]; }
+		}
+		vList.resize(out);
+		removed += n - kept;
 	}
-	return vMin;
+	return removed;
 }
 
-int ckFile(string fn)
+void stampLayer(layer *Lc, const layer &src, const string &rTag, int cTraj, int hTraj, double mag, double xo, double yo)
 {
-	int length;
-	ifstream is(fn.c_str(), ios::in | ios::binary);
-	is.seekg(0, ios::end);
-	length = is.tellg();	
-	is.seekg(0, ios::beg);
-	char header[80];
-	char nTrig[4];
-	is.read(header, 80);
-	is.read(nTrig, 4);
-	if (length == (*((int *)nTrig)) * 50 + 84)
-	{
-		is.close();
-		return 1;
-	}
-	else if (length>15)
+	if (Lc->isEmpty)
 	{
-		return 0;
+		// first part found on this layer: take its z height, as combLayer does
+		Lc->isEmpty = 0;
+		Lc->zHeight = src.zHeight;
+		Lc->cordSys = src.cordSys;
 	}
-	else
+	vector<loop> &lpList = Lc->us.lpList;
+	lpList.reserve(lpList.size() + src.us.lpList.size());
+	for (vector<loop>::const_iterator lt = src.us.lpList.begin(); lt != src.us.lpList.end(); ++lt)
 	{
-		is.close();
-		return 2;
+		lpList.push_back(loop());
+		loop &copy = lpList.back();
+		copy.type = (*lt).type;
+		copy.tag = rTag;
+		copy.contourTraj = cTraj;
+		copy.hatchTraj = hTraj;
+		copy.vList.resize((*lt).vList.size());
+		for (size_t k = 0; k < (*lt).vList.size(); k++)
+		{
+			copy.vList[k].x = (*lt).vList[k].x*mag + xo*mag;	// same arithmetic as scaleLayer
+			copy.vList[k].y = (*lt).vList[k].y*mag + yo*mag;
+		}
 	}
-
 }
 
-vector<vertex> findBoundary(string fn)
+void scaleLayer(layer *L, double mag, double xo, double yo)
 {
-	vector<vertex> vv;
-	int isBinary = ckFile(fn);
-	if (isBinary)
+	slice &s = L->us;	// scaled in place
+	for (vector<loop>::iterator lt = (s.lpList).begin(); lt != (s.lpList).end(); ++lt)
 	{
-		// Binary STL format
-		ifstream is(fn.c_str(), ios::in | ios::binary);
-		char header[80];
-		char nTrig[4];
-		char facet[50];
-		is.read(header, 80);
-		is.read(nTrig, 4);
-		int iFaceCount = *((int *)nTrig);
-		
-		float v[12]; // normal=3, vertices=3*3 = 12
-		int isFirst = 1;
-		vertex vMin, vTmp,vL,vR,vT,vB;
 
-		// Every Face is 50 Bytes: Normal(3*float), Vertices(9*float), 2 Bytes Spacer
-		for (size_t i = 0; i<iFaceCount; i++)
+		for (vector<vertex>::iterator vt = ((*lt).vList).begin(); vt != ((*lt).vList).end(); ++vt)
 		{
-			is.read(facet, 50);
-			for (size_t j = 0; j<12; ++j) 
-			{
-				v[j] = *((float*)facet + j);	
-			}
-			for (int k = 1; k < 4; k++)
-			{
-				vTmp.x = v[k*3];
-				vTmp.y = v[k*3+1];
-				vTmp.z = v[k*3+2];
-				if (isFirst)
-				{
-					isFirst = 0;
-					vMin = vTmp;
-					vL = vTmp;	// vertex to Left
-					vR = vTmp;	// vertex to Right
-					vT = vTmp;	// vertex to Top
-					vB = vTmp;	// vertex to Bottom
-				}
-				else
-				{
-					if (vTmp.x < vMin.x)
-						vMin.x = vTmp.x;
-					if (vTmp.y < vMin.y)
-						vMin.y = vTmp.y;
-					if (vTmp.z < vMin.z)
-						vMin.z = vTmp.z;
-					if (vTmp.x < vL.x)
-						vL = vTmp;
-					if (vTmp.x > vR.x)
-						vR = vTmp;
-					if (vTmp.y < vB.y)
-						vB = vTmp;
-					if (vTmp.y > vT.y)
-						vT = vTmp;					
-				}
-			}			
+			(*vt).x = (*vt).x*mag + xo*mag;
+			(*vt).y = (*vt).y*mag + yo*mag;
 		}		
-		vv.push_back(vMin);	// vv[0] = vMin (left-most X value, bottom-most Y value)
-		vv.push_back(vL);	// vv[1].x = vL (left-most X value, same as vv[0].x
-		vv.push_back(vR);	// vv[2].x = vR (right-most X value)
-		vv.push_back(vB);	// vv[3].y = vB (bottom-most Y value, same as vv[0].y
-		vv.push_back(vT);	// vv[4].y = vT (top-most Y value)
-		// vv[1].y, vv[2].y, vv[3].x and vv[4].x are irrelevant values
-		is.close();
-	}
-	else
-	{
-		// Text-based STL format.  We permit variable number of delimiters (spaces) between values
-		vertex vMin, vTmp, vL, vR, vT, vB;
-		//get first vertex and assign it to vMax and vMin;
-		size_t			pos = 0;
-		string			line, sub;
-		ifstream		file(fn);
-		int isFirst = 1;
-		while (getline(file, line))
-		{
-			//cout << "line= " << (string)line << endl;
-			if (string::npos != line.find("vertex"))
-			{
-				pos = line.find("vertex");
-				line = line.substr(pos + 7);
-				//cout << "line after vertex= " << (string)line << endl;
-				istringstream ss;
-				ss.str(line);
-				vector<string> tokens;
-				copy(istream_iterator<string>(ss),
-					istream_iterator<string>(),
-					back_inserter(tokens));
-				vTmp.x = atof(tokens[0].c_str());
-				vTmp.y = atof(tokens[1].c_str());
-				vTmp.z = atof(tokens[2].c_str());
-				//cout << "X Y Z = " << vTmp.x << " " << vTmp.y << " " << vTmp.z << endl;
-				if (isFirst)
-				{
-					isFirst = 0;
-					vMin = vTmp;
-					vL = vTmp;
-					vR = vTmp;
-					vT = vTmp;
-					vB = vTmp;
-					//cout << "First vertex x y z = " << vTmp.x << " " << vTmp.y << " " << vTmp.z << endl;
-				}
-				else
-				{
-					if (vTmp.x < vMin.x)
-						vMin.x = vTmp.x;
-					if (vTmp.y < vMin.y)
-						vMin.y = vTmp.y;
-					if (vTmp.z < vMin.z)
-						vMin.z = vTmp.z;
-					if (vTmp.x < vL.x)
-						vL = vTmp;
-					if (vTmp.x > vR.x)
-						vR = vTmp;
-					if (vTmp.y < vB.y)
-						vB = vTmp;
-					if (vTmp.y > vT.y)
-						vT = vTmp;
-				}
-			}
-		}
-		vv.push_back(vMin);
-		vv.push_back(vL);
-		vv.push_back(vR);
-		vv.push_back(vB);
-		vv.push_back(vT);
 	}
+}
+
+vertex findOffset(string fn)
+{
+	// the lowest x, y and z over all vertices, i.e. vv[0] of findBoundary
+	stlMesh mesh;
+	mesh.open(fn);
+	return findBoundary(mesh)[0];
+}
+
+int ckFile(string fn)
+{
+	stlMesh mesh;
+	return mesh.open(fn);
+}
+
+vector<vertex> findBoundary(const stlMesh& mesh)
+{
+	// the mapped facets are reduced in one pass; see stlMesh::bounds
+	vector<vertex> vv;
+	float lo[3] = { 0, 0, 0 };
+	float hi[3] = { 0, 0, 0 };
+	mesh.bounds(lo, hi);
+	vertex vMin, vL, vR, vT, vB;
+	vMin.x = lo[0];
+	vMin.y = lo[1];
+	vMin.z = lo[2];
+	vL = vMin;		// vertex to Left
+	vR = vMin;		// vertex to Right
+	vR.x = hi[0];
+	vB = vMin;		// vertex to Bottom
+	vT = vMin;		// vertex to Top
+	vT.y = hi[1];
+	vv.push_back(vMin);	// vv[0] = vMin (left-most X value, bottom-most Y value)
+	vv.push_back(vL);	// vv[1].x = vL (left-most X value, same as vv[0].x
+	vv.push_back(vR);	// vv[2].x = vR (right-most X value)
+	vv.push_back(vB);	// vv[3].y = vB (bottom-most Y value, same as vv[0].y
+	vv.push_back(vT);	// vv[4].y = vT (top-most Y value)
+	// vv[1].y, vv[2].y, vv[3].x and vv[4].x are irrelevant values
 	return vv;
 }
 
+vector<vertex> findBoundary(string fn)
+{
+	// binary files are read in place from the mapped file; ASCII files are first parsed into the same facet layout
+	stlMesh mesh;
+	mesh.open(fn);
+	return findBoundary(mesh);
+}
+
 void includeStripesInBBox(AMconfig &configData, vector<double> &vL, vector<double> &vR, vector<double> &vB, vector<double> &vT)
 {
 	// Iterate over configData.stripeList to find min/max x and y coordinates
@@ -28,10 +28,7 @@ appropriate LAYER format
 #include <string>
 #include <stdlib.h>
 #include <stdio.h>
-#include <msxml6.h>
-#include <comdef.h>
-#include <tchar.h>
-#include <conio.h>
+#include <string.h>
 #include <sstream>
 #include <fstream>
 #include <math.h>
@@ -40,6 +37,8 @@ appropriate LAYER format
 #include <iterator>
 
 #include "readExcelConfig.h"
+#include "platform.h"
+#include "stlMesh.h"
 
 using namespace std;
 
@@ -50,12 +49,12 @@ struct obj
 	int totLayer;//total number of layers in the stl file at given slicing thickness	
 };
 
+// plain 24-byte point; the coordinate system is the same for every vertex of a layer, so it is kept in layer::cordSys
 struct vertex
 {
 	double x;
 	double y;
 	double z;
-	string cord_sys;
 };
 
 //not used
@@ -104,6 +103,7 @@ struct layer
 	int isEmpty = 1;
 	double zHeight;
 	double thickness;
+	string cordSys = "R";	// coordinate system of all vertices in the layer (R = rectangular)
 	vector<vertex> vList;
 	slice us;
 	slice ls;
@@ -116,7 +116,8 @@ struct Linfo
 };
 
 // invokes slic3r to generate all points of intersections between triangulated surfaces and desired planes
-int runSlic3r(string fn, double layerThickness_mm, string executableFolder);
+// The SVG is written next to the STL file unless svgFile names another location (used by shards, so they don't share one file)
+int runSlic3r(string fn, double layerThickness_mm, string executableFolder, string svgFile = "");
 
 //read an SVG file generated by slic3r to get information for a particular layer number, and assign appropriate tags and trajectory#'s
 int readFile(string fn, long numLayer, layer* L, string rTag, string cSys, int cTraj, int hTraj);
@@ -125,13 +126,13 @@ int readFile(string fn, long numLayer, layer* L, string rTag, string cSys, int c
 string getVlist(string s, int type);
 
 // get individual vertices in a particular loop in the output file of slic3r from the list
-void getVertices(string vs, vector<vertex>& vl, string cSys);
+void getVertices(const string &vs, vector<vertex>& vl);
 
 // display the contents of a layer
-void displayLayer(layer L);
+void displayLayer(const layer &L);
 
 // display layer in a different format
-void displayFLayer(layer L);
+void displayFLayer(const layer &L);
 
 //refine the layer data structure to make it ready to be written to xml
 void refineLayer(layer *L);
@@ -140,16 +141,25 @@ void refineLayer(layer *L);
 void scaleLayer(layer *L, double mag, double xo, double yo);
 
 //compare to vertices to see if they are same
-int cmpVertex(vertex v1, vertex v2);
+int cmpVertex(const vertex &v1, const vertex &v2);
 
 //find a particular vertex from a list
-int findVertex(vector<vertex> vList, vertex v);
+int findVertex(const vector<vertex> &vList, const vertex &v);
 
 //get total number of layers that would be generated from a stl at a given thickness
 int getNumLayer(string fn);
 
 //combine layers with different tags at the same z height
-layer combLayer(vector<layer> vL);
+layer combLayer(const vector<layer> &vL);
+
+//simplify the loops of a layer (as read by readFile) with Douglas-Peucker, removing vertices that lie within tolerance_mm
+//of the simplified outline.  Loops are simplified independently and keep at least three vertices.  Returns the number of
+//vertices removed; a tolerance of 0 leaves the layer unchanged
+size_t simplifyLayer(layer *L, double tolerance_mm);
+
+//append a copy of the loops of one part's layer (as read by readFile) to the combined layer Lc, with the given tag and
+//trajectory numbers and scaled/translated as scaleLayer would.  Lets one parsed layer be placed for every instance of a part
+void stampLayer(layer *Lc, const layer &src, const string &rTag, int cTraj, int hTraj, double mag, double xo, double yo);
 
 //find how much the stl file offset from origin
 vertex findOffset(string fn);
@@ -157,6 +167,10 @@ vertex findOffset(string fn);
 //find the bounding box of the stl
 vector<vertex> findBoundary(string fn);
 
+//find the bounding box of an stl which has already been opened.
+//vv[1], vv[2], vv[3] and vv[4] carry the min x, max x, min y and max y; their other coordinates are those of vv[0]
+vector<vertex> findBoundary(const stlMesh& mesh);
+
 //determine bounding box of single stripes (if included) and append to the vL/vR/vT/vB vectors
 void includeStripesInBBox(AMconfig &configData, vector<double> &vL, vector<double> &vR, vector<double> &vB, vector<double> &vT);
 
@@ -23,7 +23,7 @@ which must be downloaded separately by the end user
 
 #include "SliceFuns.h"
 #include "writeLayerXML.h"
-#include "simple_svg_1.0.0.hpp"
+#include "svgStream.h"
 #include <cctype>
 #include <algorithm>
 
@@ -32,79 +32,69 @@ which must be downloaded separately by the end user
 #include "BasicExcel.hpp"
 #include "errorChecks.h"
 #include "io_functions.h"
+#include "runReport.h"
+#include "traceEvents.h"
+#include "memoryBudget.h"
+#include "shardManifest.h"
 
 using namespace std;
 
 //function to write output in svg format
 //takes as input the output filename fn, layer L and the user defined configuration file
-void rlayer2SVG(string fn, layer L, AMconfig configData)
+void rlayer2SVG(string fn, const layer &L, const AMconfig &configData)
 {
-	svg::Dimensions dimensions(configData.dim, configData.dim);
-	svg::Document docH(fn, svg::Layout(dimensions, svg::Layout::TopLeft));
+	svgStream docH(fn, configData.dim, configData.dim);
 	double sx, sy, fx, fy;// co-ordinates of vertices of an edge
-	slice s = L.us;
-	vector<vertex> vList = L.vList;
+	const slice &s = L.us;
+	const vector<vertex> &vList = L.vList;
 
 	//scaling factors so that svg fills the screen
 	double mag = configData.vMag;
 	double offx = configData.vOffx;
 	double offy = configData.vOffy;
-	int numSec = (configData.vF).size();
 
-	//go through the layer structure and generate individual vectors to write to the svg file
-	for (vector<region>::iterator rt = (s.rList).begin(); rt != (s.rList).end(); ++rt)
+	//go through the layer structure and generate individual vectors to write to the svg file.  The edges of a region
+	//form one polyline, and regions drawn in the same color share an SVG element
+	for (vector<region>::const_iterator rt = (s.rList).begin(); rt != (s.rList).end(); ++rt)
 	{
-		for (vector<edge>::iterator et = ((*rt).eList).begin(); et != ((*rt).eList).end(); ++et)
+		//use different color for different type of regions: black for outer and blue for inner contours of a region
+		//profile's tag, red for a tag with no region profile
+		string color = "red";
+		for (size_t i = 0; i < (configData.vF).size(); i++)
+		{
+			if (!((*rt).tag).compare((configData.vF[i]).Tag))
+			{
+				color = (!((*rt).type).compare("Inner")) ? "blue" : "black";
+				break;
+			}
+		}
+		for (vector<edge>::const_iterator et = ((*rt).eList).begin(); et != ((*rt).eList).end(); ++et)
 		{
 			sx = (vList[(*et).start_idx - 1]).x * mag + offx;
 			sy = (vList[(*et).start_idx - 1]).y * mag + offy;
 			fx = (vList[(*et).end_idx - 1]).x * mag + offx;
 			fy = (vList[(*et).end_idx - 1]).y * mag + offy;
-			int bCont = 1;
-			int i = 0;
-			while (bCont)
-			{
-				//use different color for different type of regions
-				if (!((*rt).tag).compare((configData.vF[i]).Tag))
-				{
-					bCont = 0;
-					if (!((*rt).type).compare("Inner"))
-					{
-						svg::Line line(svg::Point(sx, configData.dim -sy), svg::Point(fx, configData.dim -fy), svg::Stroke(1, svg::Color::Blue));
-						docH << line;
-					}
-					else
-					{
-						svg::Line line(svg::Point(sx, configData.dim -sy), svg::Point(fx, configData.dim -fy), svg::Stroke(1, svg::Color::Black));
-						docH << line;
-					}
-				}
-				if (i == numSec)
-				{
-					bCont = 0;
-					svg::Line line(svg::Point(sx, configData.dim -sy), svg::Point(fx, configData.dim -fy), svg::Stroke(1, svg::Color::Red));
-					docH << line;
-				}
-				++i;
-			}
+			docH.line(sx, configData.dim - sy, fx, configData.dim - fy, color, 1);
 		}
 	}
-	docH.save();
+	docH.close();
 }
 
 
 int	main(int argc, char **argv)
 // Required argument for genLayer.exe:
 // <filename>.xls = full path to configuration file (surrounded by "").  If not specified, error will be reported
+// Optional argument:
+// --batch = never wait for a keypress (used on headless batch nodes)
+// --shard <id> --layers <first>-<last> = generate only this range of layers and record them in the shard's manifest
+// --merge = check the manifests of all layer shards and write layer_header.xml for the combined layers
 {
 	// To enhance memory management, this program is called from an external script. Every time this program is called, 
 	// it reads the last layer number generated from a *cfg file, generates a specific number of layers, and write the 
 	// final layer number in the *cfg file for next time (or write if it is finished).
 
 	// Determine where we are (current path)
-	TCHAR filePath[MAX_PATH + 1] = "";
-	GetCurrentDirectory(MAX_PATH, filePath);
-	string currentPath = &filePath[0];
+	string currentPath = currentDirectory();
 
 	// 1. Read the configuration file indicated by command-line arguments
 	AMconfig configData;
@@ -112,34 +102,101 @@ int	main(int argc, char **argv)
 	// Parse the command-line arguments, if any.
 	// argc indicates the number of command-line arguments entered by the user
 	string configFilename = "";
+	shardRange shard;
+	bool mergeShards = false;
 	if (argc > 1)
 	{
 		configFilename = argv[1];
+		for (int a = 2; a < argc; a++) {
+			if (string(argv[a]) == "--batch") { setInteractive(false); }
+			else if (string(argv[a]) == "--merge") { mergeShards = true; }
+			else if ((string(argv[a]) == "--shard") && (a + 1 < argc)) { shard.shardId = argv[++a]; }
+			else if ((string(argv[a]) == "--layers") && (a + 1 < argc)) {
+				if (!parseLayerRange(argv[++a], shard.firstLayer, shard.lastLayer)) {
+					cout << "Invalid layer range " << argv[a] << "; expected <first>-<last>" << endl;
+					pauseForUser();
+					return -1;
+				}
+			}
+		}
 	}
 	else
 	{
 		// no config file specified... most likely the user tried to run genLayer or genScan directly
 		string errMsg = "Please use createScanpaths.exe to handle layer and scan generation. genScan.exe and genLayer.exe are helper functions only\n";
-		system("pause");
+		pauseForUser();
 		return -1;
 	}
 	
 	configData = AMconfigRead(configFilename);
 	configData.executableFolder = currentPath;  // assume we begin in the executable folder, slic3r folder is located
+#if TRACEEVENTS
+	openTraceFile(configData.projectFolder + pathSep + shardFilename(traceFilename, shard.shardId), "genLayer");
+#endif
+	string xmlFolder = configData.layerOutputFolder + pathSep + "XMLdir";
+
+	// If asked to merge, check the layer files written by all shards and write the header which covers them
+	if (mergeShards)
+	{
+		vector<shardManifest> manifests = readManifests(configData.layerOutputFolder, "layer");
+		vector<string> problems;
+		vector<manifestEntry> entries = mergeManifests(manifests, xmlFolder, "layer_", problems);
+		int totalLayers = (manifests.size() > 0) ? manifests[0].totalLayers : 0;
+		if ((problems.size() == 0) && ((entries.size() == 0) || (entries.front().layer != 1) || (entries.back().layer != totalLayers))) {
+			problems.push_back("The shards must together cover layers 1-" + to_string(totalLayers));
+		}
+		if (problems.size() > 0) {
+			for (size_t p = 0; p + 1 < problems.size(); p++) {
+				updateErrorResults(errorData, false, "genLayer merge", problems[p] + "\n", "", configData.configFilename, configData.configPath);
+			}
+			updateErrorResults(errorData, true, "genLayer merge", problems.back() + "\n", "", configData.configFilename, configData.configPath);
+			return -1;
+		}
+		vector<Linfo> Lhdr;
+		for (size_t e = 0; e < entries.size(); e++)
+		{
+			Linfo li;
+			li.fn = entries[e].filename;
+			li.zHeight = entries[e].zHeight;
+			Lhdr.push_back(li);
+		}
+		HRESULT hr = CoInitialize(NULL);
+		if (SUCCEEDED(hr))
+		{
+			string hfn = xmlFolder + pathSep + "layer_header.xml";
+			hr = writeHeader(hfn, Lhdr, totalLayers);
+			CoUninitialize();
+			if (FAILED(hr)) {
+				updateErrorResults(errorData, true, "genLayer merge", "Could not write the layer header file " + hfn + "\n", "", configData.configFilename, configData.configPath);
+				return -1;
+			}
+		}
+		cout << "Merged " << entries.size() << " layers from " << manifests.size() << " shards\n";
+		return 0;
+	}
 
 	// 2. Read the status file to determine the last layer completed by prior run of genLayer.exe, if any
-	sts cst = readStatus("gl_sts.cfg"); // read ending layer number of the last iteration (or check if it is the first layer)
+	string statusFilename = shardFilename("gl_sts.cfg", shard.shardId);	// each shard keeps its own status file
+	sts cst = readStatus(statusFilename); // read ending layer number of the last iteration (or check if it is the first layer)
 	int started; // flag to check if slicing of the part has already started
 	int finished; // flag to write if slicing of the part is complete
 	int sLayer; // starting layer number for a particular function call
 	int fLayer; // final layer number for a particular call
 	finished = 0; // by default, finished flag is set to zero
 	started = cst.started;
-	sLayer = cst.lastLayer+1;
-	fLayer = sLayer + numLayersPerCall; // we do multiple layers in each call of this function. Increasing this number will increase memory
-	// requirements between calls, but fewer iterations will make it run faster. 
+	sLayer = max(cst.lastLayer+1, shard.firstLayer);	// a shard begins at the start of its own range
+	fLayer = sLayer + maxLayersPerCall - 1; // we do multiple layers in each call of this function, stopping early (see 6f) if
+	// another layer would exceed the memory budget.  More layers per call will make it run faster
+	memoryBudget layerMemory(cst.layerCostMB);	// tracks the working set per layer to size this batch
 	int close = 0;
 
+	// Each shard slices the parts into its own folder, so that shards working in the same project don't overwrite each other's SVGs
+	string sliceFolder = "";
+	if (shard.shardId != "") {
+		sliceFolder = configData.layerOutputFolder + pathSep + shardFolderName + pathSep + "slices_shard" + shard.shardId;
+		createFolder(sliceFolder);
+	}
+
 	vector<obj> vOBJ;	// vOBJ contains information about each stl file
 	vector<int> nLayer;	// number of layers in stl files
 	vector<int> soffset;// z offset for stl files
@@ -183,17 +240,14 @@ int	main(int argc, char **argv)
 		}
 		else {
 			// evaluate attributes of this file
-			DWORD ftyp = GetFileAttributesA((configData.vF[i]).fn.c_str());
-			if (ftyp == INVALID_FILE_ATTRIBUTES) {
+			if (!::fileExists((configData.vF[i]).fn)) {
 				fileExists = false;  // STL file cannot be found
 				string errMsg = "The STL file named " + configData.vF[i].fn + " cannot be found in the same folder as the configuration file\n";
 				updateErrorResults(errorData, true, "genLayer main", errMsg, "", configData.configFilename, configData.configPath);
 				return -1;
 			}
 			else {
-				if (ftyp) {
-					fileExists = true;   // STL file exists
-				}
+				fileExists = true;   // STL file exists
 			}
 		}
 		
@@ -219,8 +273,12 @@ int	main(int argc, char **argv)
 		(configData.vF[i]).z_offset = (configData.vF[i]).z_offset + vv[0].z;
 
 		// 3c. If not previously sliced, run slic3r on the part
+		int len = strlen((configData.vF[i]).fn.c_str());
+		o.fn = (configData.vF[i]).fn.substr(0, len - 4);	// filename without extension, where slic3r writes the SVG
+		if (sliceFolder != "") { o.fn = sliceFolder + pathSep + filenameOnly(o.fn); }
 		if ((!started) & (!previouslySliced)) {
-			int slicerReturnValue = runSlic3r((configData.vF[i]).fn, configData.layerThickness_mm, configData.executableFolder);
+			TRACE_SCOPE("runSlic3r", "genLayer", -1, -1, (configData.vF[i]).Tag);
+			int slicerReturnValue = runSlic3r((configData.vF[i]).fn, configData.layerThickness_mm, configData.executableFolder, (sliceFolder != "") ? o.fn + ".svg" : "");
 			if (slicerReturnValue != 0) {
 				// slic3r encountered an issue with an STL file
 				string errMsg = "Slic3r was not able to slice " + configData.vF[i].fn + "\n";
@@ -229,8 +287,6 @@ int	main(int argc, char **argv)
 			}
 		}
 		// 3d. Compute number of layers in this part above z=0, incorporating z offset
-		int len = strlen((configData.vF[i]).fn.c_str());
-		o.fn = (configData.vF[i]).fn.substr(0, len - 4);
 		// save information about this part:  filename without extension, z offset in layers, total layer count
 		o.cntOffset = (int)(((configData.vF[i]).z_offset) / configData.layerThickness_mm);
 		soffset.push_back(o.cntOffset);
@@ -258,6 +314,17 @@ int	main(int argc, char **argv)
 		fLayer = totLayer;
 		finished = 1;
 	}
+	// likewise if this shard's range ends within the current call
+	if (shard.lastLayer <= fLayer)
+	{
+		fLayer = shard.lastLayer;
+		finished = 1;
+	}
+	string manifestFile = manifestPath(configData.layerOutputFolder, "layer", shard.shardId);
+	if ((shard.shardId != "") && (started == 0))
+	{	// first call for this shard: begin its manifest.  A range entirely above the build is recorded as empty
+		startManifest(manifestFile, shard.shardId, sLayer, min(shard.lastLayer, totLayer), totLayer);
+	}
 
 	// 5. Generate scaling factors for svg visualization and save to a text file to be later used by scan generator.
 	// We compute span as the max x or y range when all parts are in their assigned (offset) locations
@@ -281,84 +348,92 @@ int	main(int argc, char **argv)
 	configData.vOffx = xo;
 	configData.vOffy = yo;
 	ofstream fout;
-	fout.open(configData.layerOutputFolder + "\\" + "vConfig.txt");
+	fout.open(configData.layerOutputFolder + pathSep + "vConfig.txt");
 	fout << mag << "," << xo << "," << yo << endl;
 	fout.close();
 
 	if (started == 0) { cout << "Total number of layers: " << totLayer << "\n\n"; }
 
-	vector<layer> vLayer;// layer from all stl files
-	layer L;  // temporary layer var
+	// Parts which use the same STL file at the same z offset are instances of one another (e.g. a plate of identical
+	// coupons).  Each layer is read only for the first instance and then placed at the x/y offset of every instance
+	vector<int> instanceOf(vOBJ.size());
+	for (int j = 0; j < (int)vOBJ.size(); j++)
+	{
+		instanceOf[j] = j;
+		for (int k = 0; k < j; k++)
+		{
+			if ((vOBJ[k].fn == vOBJ[j].fn) && (vOBJ[k].cntOffset == vOBJ[j].cntOffset)) {
+				instanceOf[j] = k;
+				break;
+			}
+		}
+	}
+
+	vector<layer> partLayers(vOBJ.size());	// current layer of each part, as read from its SVG (used by all its instances)
 	layer Lc; // combined layer with appropriate tags
 	vector<Linfo> Lhdr; // information to be written in the header file
 
-	// set up variables for cursor control
-	COORD cursorPosition;
-	HANDLE hStdout;
-	hStdout = GetStdHandle(STD_OUTPUT_HANDLE);
-	// Identify current cursor position
-	cursorPosition = GetConsoleCursorPosition(hStdout);
+	// set up progress display (rewritten in place on a console, one line per layer otherwise)
+	consoleProgress progress;
 
 	//**************************************
 	// 6. PROCESS A NUMBER OF LAYERS from sLayer (starting layer for this genLayer instance) to fLayer (final layer for this instance)
 	// By generating combined layer structure with appropriate tags and write them to XML and SVG formats
 	for (int i = sLayer; i <= fLayer; i++)
 	{
-		cout << "Processing layer " << i << " of " << totLayer;
-		// reset cursor position for next iteration
-		SetConsoleCursorPosition(hStdout, cursorPosition);
-
-		// clear the large re-used variables to help with memory leakage
-		vLayer.clear();
-		vLayer.shrink_to_fit();
-		//
-		Lc.ls.lpList.clear();  // clear the combined layer (this is done once per layer)
+		TIME_STAGE("layer");
+		TRACE_SCOPE("layer", "genLayer", i);
+		layerMemory.beginLayer();
+		progress.update("Processing layer " + to_string(i) + " of " + to_string(totLayer));
+
+		// clear the combined layer (this is done once per layer).  The loop and region lists keep their capacity,
+		// so the next layer reuses them; the loops' own vertex and edge lists are released here
+		Lc.isEmpty = 1;
+		Lc.ls.lpList.clear();
 		Lc.ls.rList.clear();
 		Lc.us.lpList.clear();
 		Lc.us.rList.clear();
 		Lc.vList.clear();
-		//
-		Lc.ls.lpList.shrink_to_fit();
-		Lc.ls.rList.shrink_to_fit();
-		Lc.us.lpList.shrink_to_fit();
-		Lc.us.rList.shrink_to_fit();
-		Lc.vList.shrink_to_fit();
-
-		// 6a. Iterate across parts listed in vOBJ, generate a layer structure for each and append to vLayer
-		//		This includes all regions for the part on just the current layer
+
+		size_t simplifiedVertices = 0;	// outline vertices removed by simplifyLayer, once per part read
+
+		// 6a. Iterate across parts listed in vOBJ.  Read this layer of each part from its SVG file (once for a set of
+		//		instances), then stamp a copy with the part's tags, trajectory#'s and offset into the combined layer
+		// 6b. The combined layer Lc thus collects all parts, in part order
 		for (int j = 0; j < (int)vOBJ.size(); j++)
 		{
-			L.ls.lpList.clear();  // clear the temporary layer var (this is done in between reading parts for this layer)
-			L.ls.rList.clear();
-			L.us.lpList.clear();
-			L.us.rList.clear();
-			L.vList.clear();
-			//
-			L.ls.lpList.shrink_to_fit();
-			L.ls.rList.shrink_to_fit();
-			L.us.lpList.shrink_to_fit();
-			L.us.rList.shrink_to_fit();
-			L.vList.shrink_to_fit();
-
-			L.isEmpty = 1;  // will be set to 0 (not empty) if anything is found for part j on layer i
-
 			if (i > (vOBJ[j].cntOffset) && i <= (vOBJ[j].totLayer+1))
 			{
-				L.isEmpty = 0;
-				// Read the SVG file corresponding to this point, extract info for one layer and apply tags and trajectory#'s
-				readFile(vOBJ[j].fn + ".svg", (i-1) - vOBJ[j].cntOffset, &L, (configData.vF[j]).Tag, "R", (configData.vF[j]).contourTraj, (configData.vF[j]).hatchTraj);
-				// "R" is the coordinate system, short for "Rectangular"
+				layer &partLayer = partLayers[instanceOf[j]];
+				if (instanceOf[j] == j)
+				{
+					partLayer.us.lpList.clear();  // clear the part's previous layer
+					TRACE_SCOPE("readFile", "genLayer", i, (configData.vF[j]).contourTraj, (configData.vF[j]).Tag);
+					// Read the SVG file corresponding to this point, extracting info for one layer
+					readFile(vOBJ[j].fn + ".svg", (i-1) - vOBJ[j].cntOffset, &partLayer, (configData.vF[j]).Tag, "R", (configData.vF[j]).contourTraj, (configData.vF[j]).hatchTraj);
+					// "R" is the coordinate system, short for "Rectangular"
+					// Optionally drop the nearly collinear points of Slic3r's fine outlines, once for all instances of the part
+					simplifiedVertices += simplifyLayer(&partLayer, configData.simplifyTolerance_um / 1000.0 / configData.pMag);
+				}
+				stampLayer(&Lc, partLayer, (configData.vF[j]).Tag, (configData.vF[j]).contourTraj, (configData.vF[j]).hatchTraj, configData.pMag, (configData.vF[j]).x_offset, (configData.vF[j]).y_offset);
 			}
-			scaleLayer(&L, configData.pMag, (configData.vF[j]).x_offset, (configData.vF[j]).y_offset);
-			vLayer.push_back(L);
 		}
-
-		// 6b. Combine all parts into one layer structure
-		Lc = combLayer(vLayer);
 		
 		// 6c. Clean up layer structure and convert it to the desired form
-		refineLayer(&Lc);
+		{
+			TRACE_SCOPE("refineLayer", "genLayer", i);
+			refineLayer(&Lc);
+		}
 		Lc.thickness = configData.layerThickness_mm;
+#if STAGETIMING
+		// record the size of the combined layer for the run report
+		size_t numEdges = 0;
+		for (size_t r = 0; r < Lc.us.rList.size(); r++) { numEdges += Lc.us.rList[r].eList.size(); }
+		COUNT_LAYER(i, "vertices", Lc.vList.size());
+		COUNT_LAYER(i, "edges", numEdges);
+		COUNT_LAYER(i, "regions", Lc.us.rList.size());
+		COUNT_LAYER(i, "simplified_vertices", simplifiedVertices);
+#endif
 
 		// generate filenames by appending appropriate numbers
 		string zs;
@@ -371,42 +446,75 @@ int	main(int argc, char **argv)
 		if ( (configData.createLayerSVG == 1) && ((i % configData.layerSVGinterval == 0) | (i==1)) ) {
 			//generate SVG file then move to SVG subfolder
 			string nfn = "layer_" + zs + to_string(i) + ".svg";
-			string fullSVGpath = configData.layerOutputFolder + "\\SVGdir\\" + nfn;
+			string fullSVGpath = configData.layerOutputFolder + pathSep + "SVGdir" + pathSep + nfn;
 			rlayer2SVG(fullSVGpath, Lc, configData);
 		}
 
 		// 6e. Generate an XML layer file from the layer structure, using the Microsoft DOM
 		string xfn = "layer_" + zs + to_string(i) + ".xml";
-		string fullXMLpath = configData.layerOutputFolder + "\\XMLdir\\" + xfn;
+		string fullXMLpath = configData.layerOutputFolder + pathSep + "XMLdir" + pathSep + xfn;
 		HRESULT hr = CoInitialize(NULL);
 		if (SUCCEEDED(hr))
 		{
+			TRACE_SCOPE("writeLayer", "genLayer", i);
 			writeLayer(fullXMLpath, Lc);		
+			if ((shard.shardId != "") && !addManifestEntry(manifestFile, i, Lc.zHeight, xmlFolder, xfn)) {
+				string errMsg = "Could not add " + fullXMLpath + " to the shard manifest\n";
+				updateErrorResults(errorData, true, "genLayer main", errMsg, "", configData.configFilename, configData.configPath);
+			}
 			Linfo li;
 			li.fn = xfn;
 			li.zHeight = Lc.zHeight;
 			Lhdr.push_back(li);
 			CoUninitialize();
 		}
+
+		// 6f. End this batch early if another layer is expected to exceed the memory budget
+		layerMemory.endLayer(i);
+		if ((i < fLayer) && !layerMemory.roomForNextLayer())
+		{
+			fLayer = i;
+			finished = 0;
+			break;
+		}
 	} // end for (int i = sLayer; i <= fLayer; i++)
 
 	// 7. Target number of layers are complete for this instance of genLayer.  Create a single XML file containing header information from the DOM
-	string hfn = "\"" + configData.layerOutputFolder + "\\XMLdir\\layer_header.xml\"";
-	HRESULT hr = CoInitialize(NULL);
+	// Shards leave the header to the merge step, which sees the layers of every shard
+	if (shard.shardId == "")
+	{
+		string hfn = configData.layerOutputFolder + pathSep + "XMLdir" + pathSep + "layer_header.xml";
+		HRESULT hr = CoInitialize(NULL);
 
-	if (SUCCEEDED(hr))
+		if (SUCCEEDED(hr))
+		{
+			hr = writeHeader(hfn, Lhdr, totLayer);
+			CoUninitialize();
+			if (FAILED(hr)) {
+				updateErrorResults(errorData, true, "genLayer main", "Could not write the layer header file " + hfn + "\n", "", configData.configFilename, configData.configPath);
+				return -1;
+			}
+		}
+	}
+	else if (finished == 1)
 	{
-		writeHeader(hfn, Lhdr, totLayer);
-		CoUninitialize();
+		finishManifest(manifestFile);
 	}
 
+#if STAGETIMING
+	// save this instance's timing samples, layer counts and batch for the run report assembled by createScanpaths
+	layerMemory.recordBatch(sLayer, fLayer);
+	appendRunSamples(configData.projectFolder + pathSep + shardFilename(runSamplesFilename, shard.shardId), "genLayer");
+#endif
+
 	// 8. Write ending layer number and whether all are completed to gl_sts.cfg file for communication with createScanpaths
 	ofstream stfile;
-	stfile.open("gl_sts.cfg");
+	stfile.open(statusFilename);
 	stfile << 1 << endl;	// set started to 1, which will avoid re-slicing parts
 	stfile << fLayer << endl;
 	stfile << finished << endl;
 	stfile << configData.layerOutputFolder << endl;
+	stfile << layerMemory.layerCostMB() << endl;	// per-layer memory estimate for the next call
 	stfile.close();
 
 	return 0;
@@ -0,0 +1,265 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+stlMesh.cpp maps STL files, parses ASCII STLs and computes bounding
+boxes.  The min/max reduction uses AVX when the compiler targets it
+(e.g. -mavx2 or /arch:AVX2), SSE on other x86-64 builds, and plain
+C++ elsewhere.
+
+The ASCII parser works directly on the mapped file without creating
+strings or streams: it looks only for the "normal" and "vertex"
+keywords and reads the three numbers after each.  Every three
+vertices complete a facet.  Large files are split after an
+"endfacet" keyword into chunks which are parsed on separate threads
+and then joined in order
+//============================================================*/
+
+#include "stlMesh.h"
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <thread>
+// <charconv> is not available in Visual Studio 2015 (the .sln toolset); parseFloat falls back to strtof there
+#if defined(__has_include)
+	#if __has_include(<charconv>)
+		#include <charconv>
+	#endif
+#endif
+
+#if defined(__AVX__)
+	#define STL_SIMD_WIDTH 8
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define STL_SIMD_WIDTH 4
+	#include <emmintrin.h>
+#else
+	#define STL_SIMD_WIDTH 1
+#endif
+
+int stlMesh::open(const string& fn)
+{
+	facetData = nullptr;
+	facetCount = 0;
+	fileFormat = stlInvalid;
+	if (!file.open(fn)) { return fileFormat; }
+
+	// check the size and facet count once, here, so that the facets can then be read without further checks
+	size_t length = file.size();
+	if (length >= stlHeaderBytes) {
+		unsigned int headerCount;
+		memcpy(&headerCount, file.data() + 80, sizeof(headerCount));
+		if ((unsigned long long)length == (unsigned long long)headerCount * stlFacetBytes + stlHeaderBytes) {
+			fileFormat = stlBinary;
+			facetData = file.data() + stlHeaderBytes;
+			facetCount = headerCount;
+			return fileFormat;
+		}
+	}
+	if (length > 15) {
+		fileFormat = stlASCII;
+		parseASCII();
+		file.close();	// the facets have been copied out of the file
+	}
+	return fileFormat;
+}
+
+static inline bool isSpace(char c)
+{
+	return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r') || (c == '\f') || (c == '\v');
+}
+
+// read a number at p, after any white space, and move p past it.  Returns false if there is no number
+static bool parseFloat(const char*& p, const char* end, float& value)
+{
+	while ((p < end) && isSpace(*p)) { p++; }
+	if ((p < end) && (*p == '+')) { p++; }	// from_chars doesn't accept a leading +
+#if defined(__cpp_lib_to_chars) && (__cpp_lib_to_chars >= 201611L)
+	from_chars_result result = from_chars(p, end, value);
+	if (result.ec != errc()) { return false; }
+	p = result.ptr;
+#else
+	// older libraries have no floating-point from_chars; strtof needs a terminated copy of the token
+	char token[64];
+	size_t n = 0;
+	while ((p + n < end) && !isSpace(p[n]) && (n < sizeof(token) - 1)) { token[n] = p[n]; n++; }
+	token[n] = '\0';
+	char* stop;
+	value = strtof(token, &stop);
+	if (stop == token) { return false; }
+	p += stop - token;
+#endif
+	return true;
+}
+
+// parse the facets whose keywords begin in [begin, end), appending them to out in binary STL layout.
+// Numbers may run past end (up to fileEnd) since chunks are only split between facets
+static void parseASCIIRange(const char* begin, const char* end, const char* fileEnd, vector<char>& out)
+{
+	out.reserve(out.size() + (end - begin) / 250 * stlFacetBytes);	// a typical ASCII facet is 250-300 characters
+	float record[12] = {};	// normal and three vertices
+	char attribute[2] = { 0, 0 };
+	int numVertices = 0;
+	const char* p = begin;
+	while (p < end)
+	{
+		// find the next word
+		while ((p < end) && isSpace(*p)) { p++; }
+		const char* word = p;
+		while ((p < fileEnd) && !isSpace(*p)) { p++; }
+		size_t length = p - word;
+
+		if ((length == 6) && (memcmp(word, "vertex", 6) == 0)) {
+			float* xyz = record + 3 + 3 * numVertices;
+			if (!parseFloat(p, fileEnd, xyz[0]) || !parseFloat(p, fileEnd, xyz[1]) || !parseFloat(p, fileEnd, xyz[2])) { continue; }
+			if (++numVertices == 3) {
+				out.insert(out.end(), (const char*)record, (const char*)record + sizeof(record));
+				out.insert(out.end(), attribute, attribute + 2);
+				numVertices = 0;
+				record[0] = record[1] = record[2] = 0.0f;
+			}
+		}
+		else if ((length == 6) && (memcmp(word, "normal", 6) == 0)) {
+			if (!parseFloat(p, fileEnd, record[0]) || !parseFloat(p, fileEnd, record[1]) || !parseFloat(p, fileEnd, record[2])) { continue; }
+		}
+		else if ((length == 5) && (memcmp(word, "solid", 5) == 0)) {
+			// the rest of the line is the solid's name, which may contain any words
+			while ((p < fileEnd) && (*p != '\n')) { p++; }
+		}
+	}
+}
+
+void stlMesh::parseASCII()
+{
+	const char* begin = file.data();
+	const char* end = begin + file.size();
+
+	// split large files into chunks, each ending just after an "endfacet"
+	size_t numChunks = 1;
+	if (file.size() >= 2 * stlASCIIChunkBytes) {
+		numChunks = min((size_t)max(1u, thread::hardware_concurrency()), file.size() / stlASCIIChunkBytes);
+	}
+	vector<const char*> chunkStart = { begin };
+	static const char endfacet[] = "endfacet";
+	for (size_t c = 1; c < numChunks; c++)
+	{
+		const char* nominal = max(begin + file.size() / numChunks * c, chunkStart.back());
+		const char* split = search(nominal, end, endfacet, endfacet + 8);
+		chunkStart.push_back((split == end) ? end : split + 8);
+	}
+	chunkStart.push_back(end);
+
+	asciiFacets.clear();
+	if (numChunks == 1) {
+		parseASCIIRange(begin, end, end, asciiFacets);
+	}
+	else {
+		vector<vector<char>> chunkFacets(numChunks);
+		vector<thread> workers;
+		for (size_t c = 0; c < numChunks; c++)
+		{
+			workers.emplace_back(parseASCIIRange, chunkStart[c], chunkStart[c + 1], end, ref(chunkFacets[c]));
+		}
+		size_t totalBytes = 0;
+		for (size_t c = 0; c < numChunks; c++)
+		{
+			workers[c].join();
+			totalBytes += chunkFacets[c].size();
+		}
+		asciiFacets.reserve(totalBytes);
+		for (size_t c = 0; c < numChunks; c++)
+		{
+			asciiFacets.insert(asciiFacets.end(), chunkFacets[c].begin(), chunkFacets[c].end());
+		}
+	}
+	facetData = asciiFacets.data();
+	facetCount = asciiFacets.size() / stlFacetBytes;
+}
+
+float stlMesh::vertexCoord(size_t f, int v, int c) const
+{
+	float value;
+	memcpy(&value, facetData + f * stlFacetBytes + stlVertexOffset + (3 * v + c) * sizeof(float), sizeof(float));
+	return value;
+}
+
+bool stlMesh::bounds(float minXYZ[3], float maxXYZ[3]) const
+{
+	if (facetCount == 0) { return false; }
+	for (int c = 0; c < 3; c++)
+	{
+		minXYZ[c] = maxXYZ[c] = vertexCoord(0, 0, c);
+	}
+
+	// The vector loads take 4 floats per vertex (x, y, z and the following value, which is ignored).
+	// For the last facet that 4th value lies beyond the end of the file, so the last facet is left to the scalar loop
+	size_t f = 0;
+	size_t lastFacet = facetCount - 1;
+#if STL_SIMD_WIDTH > 1
+	const float* first = (const float*)(facetData + stlVertexOffset);
+	__m128 lo4 = _mm_loadu_ps(first);
+	__m128 hi4 = lo4;
+#if STL_SIMD_WIDTH == 8
+	// two facets per iteration, one in each 128-bit half
+	__m256 lo8 = _mm256_insertf128_ps(_mm256_castps128_ps256(lo4), lo4, 1);
+	__m256 hi8 = lo8;
+	for (; f + 2 <= lastFacet; f += 2)
+	{
+		const char* a = facetData + f * stlFacetBytes + stlVertexOffset;
+		const char* b = a + stlFacetBytes;
+		for (int v = 0; v < 3; v++)
+		{
+			__m256 xyz = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps((const float*)(a + 12 * v))), _mm_loadu_ps((const float*)(b + 12 * v)), 1);
+			lo8 = _mm256_min_ps(lo8, xyz);
+			hi8 = _mm256_max_ps(hi8, xyz);
+		}
+	}
+	lo4 = _mm_min_ps(_mm256_castps256_ps128(lo8), _mm256_extractf128_ps(lo8, 1));
+	hi4 = _mm_max_ps(_mm256_castps256_ps128(hi8), _mm256_extractf128_ps(hi8, 1));
+#endif
+	for (; f < lastFacet; f++)
+	{
+		const char* a = facetData + f * stlFacetBytes + stlVertexOffset;
+		for (int v = 0; v < 3; v++)
+		{
+			__m128 xyz = _mm_loadu_ps((const float*)(a + 12 * v));
+			lo4 = _mm_min_ps(lo4, xyz);
+			hi4 = _mm_max_ps(hi4, xyz);
+		}
+	}
+	float lo[4], hi[4];
+	_mm_storeu_ps(lo, lo4);
+	_mm_storeu_ps(hi, hi4);
+	for (int c = 0; c < 3; c++)
+	{
+		minXYZ[c] = lo[c];
+		maxXYZ[c] = hi[c];
+	}
+#endif
+
+	// remaining facets (all of them without SIMD)
+	for (; f < facetCount; f++)
+	{
+		for (int v = 0; v < 3; v++)
+		{
+			for (int c = 0; c < 3; c++)
+			{
+				float value = vertexCoord(f, v, c);
+				if (value < minXYZ[c]) { minXYZ[c] = value; }
+				if (value > maxXYZ[c]) { maxXYZ[c] = value; }
+			}
+		}
+	}
+	return true;
+}
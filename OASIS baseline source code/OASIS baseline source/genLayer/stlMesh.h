@@ -0,0 +1,75 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+stlMesh.h defines a reader for STL part files.  The file is memory-
+mapped and its format checked once; binary facets are then used in
+place, straight from the mapping, by any stage which needs them (such
+as the bounding-box computation in findBoundary).  ASCII files are
+parsed into the same binary facet layout, so later stages need not
+care which format a part was supplied in
+//============================================================*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "platform.h"
+
+using namespace std;
+
+// binary STL layout: 80-byte header, 4-byte facet count, then one record per facet
+static const size_t stlHeaderBytes = 84;
+static const size_t stlFacetBytes = 50;		// normal (3 floats), 3 vertices (9 floats), 2-byte attribute
+static const size_t stlVertexOffset = 12;	// offset of the first vertex within a facet record
+
+// ASCII files at least twice this size are parsed in chunks of about this size on parallel threads
+static const size_t stlASCIIChunkBytes = 32 * 1024 * 1024;
+
+// file formats, using the codes returned by ckFile
+enum stlFormat
+{
+	stlASCII = 0,
+	stlBinary = 1,
+	stlInvalid = 2
+};
+
+class stlMesh
+{
+public:
+	// map the file and determine its format.  A file is binary if its size matches the facet count in its header;
+	// otherwise (if it isn't tiny) it is parsed as ASCII
+	int open(const string& fn);
+	int format() const { return fileFormat; }
+
+	// facet records in binary STL layout, stlFacetBytes apart.  For a binary file these point into the mapped file,
+	// for an ASCII file into the parsed records
+	size_t numFacets() const { return facetCount; }
+	const char* facets() const { return facetData; }
+
+	// coordinate c (0=x, 1=y, 2=z) of vertex v (0-2) of facet f
+	float vertexCoord(size_t f, int v, int c) const;
+
+	// component-wise minimum and maximum over all vertices.  Returns false if there are no facets
+	bool bounds(float minXYZ[3], float maxXYZ[3]) const;
+
+private:
+	void parseASCII();
+
+	mappedFile file;
+	vector<char> asciiFacets;	// facet records parsed from an ASCII file
+	int fileFormat = stlInvalid;
+	const char* facetData = nullptr;
+	size_t facetCount = 0;
+};
@@ -29,6 +29,7 @@ the Excel configuration file
 
 #include "constants.h"
 #include "readExcelConfig.h"
+#include "runReport.h"
 
 //IXMLDOMDocument *pXMLDomLayer;
 
@@ -198,7 +199,11 @@ CleanUp:
 
 HRESULT CreateAndInitDOM(IXMLDOMDocument **ppDoc)
 {
+#ifdef _WIN32
 	HRESULT hr = CoCreateInstance(__uuidof(DOMDocument60), NULL, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(ppDoc));
+#else
+	HRESULT hr = createDOMDocument(ppDoc);	// portable DOM subset from xmlDOM.h
+#endif
 	if (SUCCEEDED(hr))
 	{
 		// these methods should not fail so don't inspect result
@@ -210,8 +215,9 @@ HRESULT CreateAndInitDOM(IXMLDOMDocument **ppDoc)
 	return hr;
 }
 
-void writeLayer(string fn, layer L)
+void writeLayer(string fn, const layer &L)
 {
+	TIME_STAGE("writeLayer");
 	int p = layerCoordPrecision;
 
 	HRESULT hr = S_OK;
@@ -235,12 +241,12 @@ void writeLayer(string fn, layer L)
 	BSTR bstrXML = NULL;
 	VARIANT varFileName;
 	VariantInit(&varFileName);
-	slice s = L.us;
-	vector<region> rlist = s.rList;
+	const vector<region> &rlist = L.us.rList;
 	wstring wfn(fn.begin(), fn.end());
 	LPCWSTR  wszValue = wfn.c_str();
 	wstring ws;
 	string st;
+	bool firstVertex = true;
 	IXMLDOMDocument *pXMLDomLayer = NULL;
 	CHK_HR(CreateAndInitDOM(&pXMLDomLayer));
 	
@@ -257,8 +263,7 @@ void writeLayer(string fn, layer L)
 		CHK_HR(CreateAndAddTextNode(pXMLDomLayer, ws.c_str(), tNode));
 	SAFE_RELEASE(tNode);
 	CHK_HR(CreateAndAddElementNode(pXMLDomLayer, L"VertexList", L"\n\t", pRoot, &VlNode));
-	bool firstVertex = true;
-	for (vector<vertex>::iterator it = (L.vList).begin(); it != (L.vList).end(); ++it)
+	for (vector<vertex>::const_iterator it = (L.vList).begin(); it != (L.vList).end(); ++it)
 	{
 		CHK_HR(CreateAndAddElementNode(pXMLDomLayer, L"Vertex", L"\n\t", VlNode, &VNode));
 		CHK_HR(CreateAndAddElementNode(pXMLDomLayer, L"X", L"\n\t", VNode, &XNode));
@@ -288,10 +293,10 @@ void writeLayer(string fn, layer L)
 	SAFE_RELEASE(VlNode);
 		
 	CHK_HR(CreateAndAddElementNode(pXMLDomLayer, L"Slice", L"\n\t", pRoot, &SNode));
-	for (vector<region>::iterator it = rlist.begin(); it != rlist.end(); ++it)
+	for (vector<region>::const_iterator it = rlist.begin(); it != rlist.end(); ++it)
 	{
-		string tag = (*it).tag;
-		string type = (*it).type;
+		const string &tag = (*it).tag;
+		const string &type = (*it).type;
 		int contourTraj = (*it).contourTraj;
 		int hatchTraj = (*it).hatchTraj;
 		// Region
@@ -317,8 +322,8 @@ void writeLayer(string fn, layer L)
 				ws = wstring(type.begin(), type.end());
 			CHK_HR(CreateAndAddTextNode(pXMLDomLayer,ws.c_str(), tNode));
 			SAFE_RELEASE(tNode);
-			vector<edge> elist = (*it).eList;
-			for (vector<edge>::iterator et = elist.begin(); et != elist.end(); ++et)
+			const vector<edge> &elist = (*it).eList;
+			for (vector<edge>::const_iterator et = elist.begin(); et != elist.end(); ++et)
 			{
 				CHK_HR(CreateAndAddElementNode(pXMLDomLayer, L"Edge", L"\n\t", RNode, &ENode));
 					CHK_HR(CreateAndAddElementNode(pXMLDomLayer, L"Start", L"\n\t", ENode, &IsNode));
@@ -366,7 +371,7 @@ CleanUp:
 	VariantClear(&varFileName);
 };
 
-void writeHeader(string fn, vector<Linfo> li, int numLayer)
+HRESULT writeHeader(string fn, vector<Linfo> li, int numLayer)
 {
 	HRESULT hr = S_OK;
 	IXMLDOMElement *pRoot = NULL;
@@ -423,6 +428,7 @@ CleanUp:
 	SAFE_RELEASE(pDF);
 	SysFreeString(bstrXML);
 	VariantClear(&varFileName);
+	return hr;
 }
 
 PCWSTR d2lp(double in)
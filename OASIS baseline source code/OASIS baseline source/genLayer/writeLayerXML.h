@@ -23,11 +23,9 @@ layer structure to an xml file.
 #define WRITEXML_H
 
 #include <vector>
-#include <msxml6.h>
+#include "xmlDOM.h"
 #include "SliceFuns.h"
-#include <comdef.h>
 #include <string>
-#include <windows.h>
 
 
 // Macro that calls a COM method returning HRESULT value.
@@ -76,10 +74,10 @@ HRESULT CreateAndInitDOM(IXMLDOMDocument **ppDoc);
 
 
 // function that writes the layer structure L to the xml file fn
-void writeLayer(string fn, layer L);
+void writeLayer(string fn, const layer &L);
 
-//function that writes the header structure Lhdr to xml file fn
-void writeHeader(string fn, vector<Linfo> Lhdr, int numLayer);
+//function that writes the header structure Lhdr to xml file fn.  Returns a failed HRESULT if the file could not be written
+HRESULT writeHeader(string fn, vector<Linfo> Lhdr, int numLayer);
 
 //helper function to convert double to PCWSTR
 LPCWSTR d2lp(double in);
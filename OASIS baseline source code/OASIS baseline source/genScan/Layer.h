@@ -24,10 +24,6 @@ layer XML format
 #include <string>
 #include <stdlib.h>
 #include <stdio.h>
-#include <msxml6.h>
-#include <comdef.h>
-#include <tchar.h>
-#include <conio.h>
 #include <sstream>
 #include <fstream>
 #include <math.h>
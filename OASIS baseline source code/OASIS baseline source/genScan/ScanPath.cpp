@@ -24,8 +24,11 @@ contain multiple Paths
 
 #include "ScanPath.h"
 #include "constants.h"
+#include "runReport.h"
+#include "pathOrder.h"
+#include <cfloat>
 
-void findHatchBoundary(vector<vertex> &in, double hatchAngle, double *a_min, double *a_max)
+void findHatchBoundary(const vector<vertex> &in, double hatchAngle, double *a_min, double *a_max)
 {
 	// Computes min/max x or y intersection of hatch lines drawn through all vertices
 	// This identifies the number of hatch lines we need to create
@@ -34,46 +37,91 @@ void findHatchBoundary(vector<vertex> &in, double hatchAngle, double *a_min, dou
 	// If hatchAngle 315 to 45 degrees or 135 to 225 degrees, we evaluate along the y axis
 	// If hatchAngle is 45 to 135 or 225 to 315 degrees we evaluate along the x axis
 	double hatchAngle_rads = hatchAngle * 3.14159265358979323846 / 180;  // hatch angle in radians
-	int vLen = in.size();
-	vector<double> a;
-	a.reserve(vLen);  // pre-size the vector
-	vertex v;
+	if (in.empty()) {
+		*a_min = 0.0;
+		*a_max = 0.0;
+		return;
+	}
+	*a_min = DBL_MAX;
+	*a_max = -DBL_MAX;
 
 	// Determine whether to evaluate along x or y axis, based on hatchAngle
 	if ((((int)hatchAngle + 315) % 180) > 90) {
 		// hatches are spaced along y axis, so find y-intercept of hatchline through each vertex
-		double slope = tan(hatchAngle_rads);
-		//cout << "\nAlong y, hatchAngle " << hatchAngle << ", slope = " << slope << endl;
-		for (int i = 0; i < vLen; i++)
-		{
-			v = in[i];
-			a[i] = v.y - (v.x * slope);
-			//cout << "   vx " << v.x << ", vy " << v.y << ", a[i] = " << a[i] << endl;  // testing purposes
-		}
+		interceptRange(in.data(), in.size(), tan(hatchAngle_rads), true, a_min, a_max);
 	}
 	else {
 		// hatches are spaced along x axis, so find x-intercept of hatchline through each vertex
-		double slope = cos(hatchAngle_rads) / sin(hatchAngle_rads);  // can't use 1/tan, which fails at 90 degrees, whereas this returns 0
-		//cout << "\nAlong x, hatchAngle " << hatchAngle << ", slope = " << slope << endl;
-		for (int i = 0; i < vLen; i++)
-		{
-			v = in[i];
-			a[i] = v.x - (v.y * slope);
-			//cout << "   vx " << v.x << ", vy " << v.y << ", a[i] = " << a[i] << endl;  // testing purposes
-		}
+		// can't use 1/tan, which fails at 90 degrees, whereas cos/sin returns 0
+		interceptRange(in.data(), in.size(), cos(hatchAngle_rads) / sin(hatchAngle_rads), false, a_min, a_max);
 	}
-	
-	// find min/max values in a[] and return them in a_min, a_max
-	*a_min = a[0];
-	*a_max = a[0];
-	for (int i = 0; i < vLen; i++)
-	{	// using this rather than MinMax function due to some odd issues observed
-		if (a[i] < *a_min) { *a_min = a[i]; }
-		if (a[i] > *a_max) { *a_max = a[i]; }
+}
+
+void hatchBoundaryCache::clear()
+{
+	frames.clear();
+	groups = 0;
+}
+
+void hatchBoundaryCache::hatchBoundary(const layer &L, const vector<int> &regionIndex, double hatchAngle, double resHatch, double offset, double *a_min, double *a_max)
+{
+	double hatchAngle_rads = hatchAngle * 3.14159265358979323846 / 180;
+	bool yIntercept = ((((int)hatchAngle + 315) % 180) > 90);	// as in findHatchBoundary
+	double hatchFunctionValue = yIntercept ? tan(hatchAngle_rads) : cos(hatchAngle_rads) / sin(hatchAngle_rads);
+
+	// find the projections at this hatch angle, starting with the whole layer the first time it is seen
+	hatchFrame *frame = NULL;
+	for (size_t f = 0; f < frames.size(); f++) {
+		if (frames[f].hatchAngle == hatchAngle) { frame = &frames[f]; }
+	}
+	if (frame == NULL) {
+		frames.emplace_back();
+		frame = &frames.back();
+		frame->hatchAngle = hatchAngle;
+		findHatchBoundary(L.vList, hatchAngle, &frame->layerMin, &frame->layerMax);
+		frame->regionMin.assign(L.s.rList.size(), DBL_MAX);
+		frame->regionMax.assign(L.s.rList.size(), -DBL_MAX);
+		frame->regionProjected.assign(L.s.rList.size(), 0);
+	}
+	*a_min = frame->layerMin;
+	*a_max = frame->layerMax;
+	groups++;
+
+	// range of the group's own vertices; the edges of a region are closed loops, so their start and end points are the same vertices
+	static_assert(sizeof(edge) == 2 * sizeof(vertex), "edge must be two packed vertices");
+	double groupMin = DBL_MAX, groupMax = -DBL_MAX;
+	for (size_t k = 0; k < regionIndex.size(); k++) {
+		int r = regionIndex[k];
+		if (!frame->regionProjected[r]) {
+			const vector<edge> &eList = L.s.rList[r].eList;
+			if (!eList.empty()) { interceptRange(&eList[0].s, 2 * eList.size(), hatchFunctionValue, yIntercept, &frame->regionMin[r], &frame->regionMax[r]); }
+			frame->regionProjected[r] = 1;
+		}
+		groupMin = min(groupMin, frame->regionMin[r]);
+		groupMax = max(groupMax, frame->regionMax[r]);
 	}
-	//cout << "   a_min " << *a_min << ", a_max " << *a_max << endl;
 
-	return;
+	// hatch lines lie at a_start + k*hSpace, stepping from the layer's a_min (or a_max if hSpace < 0) as hatch() does
+	double hSpace = resHatch / (yIntercept ? cos(hatchAngle_rads) : sin(hatchAngle_rads));
+	if ((groupMin > groupMax) || !(fabs(hSpace) > 0.0) || !isfinite(hSpace)) { return; }
+	// a negative offset pushes the hatched area outside the group's vertices; widen by it, and by one line for lines through a vertex
+	double margin = fabs(offset) * fabs(hSpace) / resHatch + fabs(hSpace);
+	groupMin -= margin;
+	groupMax += margin;
+
+	// advance the start by whole lines with the same additions that hatch() makes, so the lines kept fall exactly where they did
+	if (hSpace > 0) {
+		double a = frame->layerMin;
+		while (a + hSpace < groupMin) { a += hSpace; }
+		*a_min = a;
+		*a_max = min(frame->layerMax, groupMax);
+	}
+	else {
+		double a = frame->layerMax;
+		while (a + hSpace > groupMax) { a += hSpace; }
+		*a_max = a;
+		*a_min = max(frame->layerMin, groupMin);
+	}
 }
 
 double dist(vertex &v1, vertex &v2)
@@ -82,7 +130,7 @@ double dist(vertex &v1, vertex &v2)
 	return r;
 }
 
-int findIntersection(vertex *out, double hatchAngle, double hatchAngle_rads, vector<vertex> BB, double intercept, edge e, double hatchFunctionValue)
+int findIntersection(vertex *out, double hatchAngle, const vector<vertex> &BB, double intercept, const edge &e, double hatchFunctionValue)
 {
 	// e is the edge (2-point line segment) to be evaluated for intersection with a particular hatch line
 	// the hatch line is defined via hatchAngle and intercept, which may be either x or y intercept based on hatchAngle
@@ -205,7 +253,7 @@ int findIntersection(vertex *out, double hatchAngle, double hatchAngle_rads, vec
 }
 
 // sort vertexList in order of ascending y coordinate, and ascending x-coordinate if y's are equal
-void yAsc(vector<vertex> &vertexList)
+void yAsc(arenaVector<vertex> &vertexList)
 {
 	int vLen = vertexList.size();
 	for (int i = 0; i < vLen; i++)
@@ -234,7 +282,7 @@ void yAsc(vector<vertex> &vertexList)
 	return;
 }
 
-void yDsc(vector<vertex> &vertexList)
+void yDsc(arenaVector<vertex> &vertexList)
 {
 	int vLen = (int)vertexList.size();
 	for (int i = 0; i < vLen; i++)
@@ -263,7 +311,7 @@ void yDsc(vector<vertex> &vertexList)
 	return;
 }
 
-void xAsc(vector<vertex> &vertexList)
+void xAsc(arenaVector<vertex> &vertexList)
 {
 	int vLen = vertexList.size();
 	for (int i = 0; i < vLen; i++)
@@ -292,7 +340,7 @@ void xAsc(vector<vertex> &vertexList)
 	return;
 }
 
-void xDsc(vector<vertex> &vertexList)
+void xDsc(arenaVector<vertex> &vertexList)
 {
 	int vLen = (int)vertexList.size();
 	for (int i = 0; i < vLen; i++)
@@ -321,10 +369,10 @@ void xDsc(vector<vertex> &vertexList)
 	return;
 }
 
-vector<vertex> eliminateDuplicateVertices(vector<vertex> &vertexList)
+void eliminateDuplicateVertices(const arenaVector<vertex> &vertexList, arenaVector<vertex> &vListOut)
 {	// assumes vertexList has been sorted in x and y.  doesn't matter which is the primary axis
 	int vLen = (int)vertexList.size();
-	vector<int> duplicateList;
+	arenaVector<int> duplicateList;
 	bool bContinue = true;
 	int i = 0;
 
@@ -342,13 +390,15 @@ vector<vertex> eliminateDuplicateVertices(vector<vertex> &vertexList)
 			bContinue = false;
 	}
 
-	// eliminate any duplicates and return as a new vector
-	vector<vertex> vListOut = vertexList;
-	for (int it = duplicateList.size() - 1; it >= 0; it--)
-	{	// erase the duplicate vertex
-		vListOut.erase(vListOut.begin() + duplicateList[it]);
+	// copy the vertices which are not duplicates to the output
+	vListOut.clear();
+	vListOut.reserve(vLen);
+	size_t d = 0;
+	for (int k = 0; k < vLen; k++)
+	{
+		if (d < duplicateList.size() && duplicateList[d] == k) { d++; continue; }	// duplicateList is in ascending order
+		vListOut.push_back(vertexList[k]);
 	}
-	return vListOut;
 }
 
 ray e2r(edge e)
@@ -362,6 +412,11 @@ ray e2r(edge e)
 	return r;
 }
 
+const char *regionTypeName(regionType type)
+{
+	return (type == regionType::contour) ? "contour" : "hatch";
+}
+
 ray rAdd(ray r1, ray r2)
 {
 	ray r;
@@ -397,40 +452,24 @@ int getTurnDir(edge ev1, edge ev2)
 		return -1;
 }
 
-void edgeOffset(layer &L, vector<int> regionIndex, vector<edge> &edgeListOut, vector<vector<edge>> &polyVectorsOut, double offset, bool returnPolyVectors)
+void offsetContours(layer &L, const vector<int> &regionIndex, double offset, ClipperLib::Paths &contoursOut)
 {
-	// this function offsets a set of edges "inward" for positive offset values
-	// therefore outer contours will be indended toward center of part (making the outer contour smaller),
-	// while inner contours (holes) will be indented in opposite fashion to make the hole larger
-	//
-	// uses the ClipperOffset routine, which may result in multiple output polygons if sections are clipped down to intersection
-	//
-	// regionIndex indicates the various regions (in layer L) to be included in the same offsetting operation.
-	// L.s.rList[x].eList are the actual edges, where x is an element in regionIndex
-	// **only one of edgeListOut or polyVectorsOut will be populated, based on returnPolyVectors:
-	//		true --> polyVectorsOut is used, false --> edgeListOut instead
-	// edgeListOut is a single vector which aggregates edges from all polygons that result from the operation
-	// polyVectorsOut is a vector of edgeListOut-style edge vectors
-	// offset is a value in millimeters.  positive shrinks the part (we flip the sign when passing it to ClipperOffset
+	// offsets the contours of the regions in regionIndex "inward" by offset mm (see edgeOffset), leaving the resulting
+	// polygons in contoursOut in Clipper integer units, where one unit is intersectRange mm
 
-	ClipperLib::Paths allContoursIn, allContoursOut;  // we expect mutiple contours (paths) in and out.  Counts may differ if some are eliminated by offsetting
+	ClipperLib::Paths allContoursIn;  // we expect mutiple contours (paths) in and out.  Counts may differ if some are eliminated by offsetting
 	
-	ClipperLib::Path contourIn;  // temporary aggregation variables
 	ClipperLib::ClipperOffset coTemp;
 	ClipperLib::IntPoint a;
-	int i, j;	// iterators
-
-	// ensure the output has no existing elements
-	polyVectorsOut.clear();
-	polyVectorsOut.shrink_to_fit();
-	edgeListOut.clear();
-	edgeListOut.shrink_to_fit();
+	size_t i;	// iterator
+	contoursOut.clear();
 
-	// 1. Iterate over regions and convert the edges into a Clipper Path (vector of endpoints).  Then add them to allContoursIn
-	for (vector<int>::iterator it = regionIndex.begin(); it != regionIndex.end(); ++it) {
+	// 1. Iterate over regions and convert the edges into a Clipper Path (vector of endpoints), built in place at the end of allContoursIn
+	allContoursIn.reserve(regionIndex.size());
+	for (vector<int>::const_iterator it = regionIndex.begin(); it != regionIndex.end(); ++it) {
 		// pre-size contourIn to hold the number of endpoints expected
-		contourIn.clear();
-		contourIn.shrink_to_fit();
+		allContoursIn.push_back(ClipperLib::Path());
+		ClipperLib::Path &contourIn = allContoursIn.back();
 		contourIn.reserve(L.s.rList[(*it)].eList.size());
 
 		// iterate over the edges in this region and create a Clipper Path
@@ -442,17 +481,45 @@ void edgeOffset(layer &L, vector<int> regionIndex, vector<edge> &edgeListOut, ve
 			a.Y = (int)round(L.s.rList[(*it)].eList[i].s.y / intersectRange);
 			contourIn.push_back(a);
 		}
-		// append contourIn to the vector of Paths
-		allContoursIn.push_back(contourIn);
 	}
 	
 	// 2. add path(s) to coTemp and set offsetting "styles" (but not the offset value itself)
 	// appropriate settings for joinType (second parameter) are jtSquare or jtMiter.  jtRound is too fine in detail (adds many points)
 	coTemp.AddPaths(allContoursIn, ClipperLib::jtMiter, ClipperLib::etClosedPolygon);
 
-	// 3. offset allContoursIn --> allContoursOut.  This may lead to zero, one or multiple polygons
-	coTemp.Execute(allContoursOut, -1*offset/intersectRange);  // must convert offset to same units as points, and flip sign because negative = shrinkage
-	// allContoursOut is populated with the result, a vector of polygon-vertex vectors
+	// 3. offset allContoursIn --> contoursOut.  This may lead to zero, one or multiple polygons
+	coTemp.Execute(contoursOut, -1*offset/intersectRange);  // must convert offset to same units as points, and flip sign because negative = shrinkage
+	// contoursOut is populated with the result, a vector of polygon-vertex vectors
+}
+
+void edgeOffset(layer &L, const vector<int> &regionIndex, vector<edge> &edgeListOut, vector<vector<edge>> &polyVectorsOut, double offset, bool returnPolyVectors)
+{
+	TIME_STAGE("edgeOffset");
+	// this function offsets a set of edges "inward" for positive offset values
+	// therefore outer contours will be indended toward center of part (making the outer contour smaller),
+	// while inner contours (holes) will be indented in opposite fashion to make the hole larger
+	//
+	// uses the ClipperOffset routine, which may result in multiple output polygons if sections are clipped down to intersection
+	//
+	// regionIndex indicates the various regions (in layer L) to be included in the same offsetting operation.
+	// L.s.rList[x].eList are the actual edges, where x is an element in regionIndex
+	// **only one of edgeListOut or polyVectorsOut will be populated, based on returnPolyVectors:
+	//		true --> polyVectorsOut is used, false --> edgeListOut instead
+	// edgeListOut is a single vector which aggregates edges from all polygons that result from the operation
+	// polyVectorsOut is a vector of edgeListOut-style edge vectors
+	// offset is a value in millimeters.  positive shrinks the part (we flip the sign when passing it to ClipperOffset
+
+	ClipperLib::Paths allContoursOut;  // offset polygons, in Clipper units
+	int i, j;	// iterators
+
+	// ensure the output has no existing elements
+	polyVectorsOut.clear();
+	polyVectorsOut.shrink_to_fit();
+	edgeListOut.clear();
+	edgeListOut.shrink_to_fit();
+
+	// 1-3. convert the regions to Clipper paths and offset them
+	offsetContours(L, regionIndex, offset, allContoursOut);
 
 	// 4. Determine if any polygons survived the offsetting operation
 	if (allContoursOut.size() == 0) {
@@ -464,14 +531,13 @@ void edgeOffset(layer &L, vector<int> regionIndex, vector<edge> &edgeListOut, ve
 	// (but not the other way around).  Simplifies things
 	polyVectorsOut.reserve(allContoursOut.size());  // assume all output polygons are valid (non-zero size)
 
-	// 4b. iterate through allContoursOut. create a set of edges for each polygon and append it to polyVectorsOut
-	vector<edge> tmpEdgeList;
+	// 4b. iterate through allContoursOut. create a set of edges for each polygon, built in place as a new, separate, vector of polyVectorsOut
 	edge e;
 	for (j=0; j < allContoursOut.size(); j++) {
 		int polySize = allContoursOut[j].size();  // used multiple times
 		if (polySize > 0) {
-			tmpEdgeList.clear();	// clear any prior iterations
-			tmpEdgeList.shrink_to_fit();
+			polyVectorsOut.push_back(vector<edge>());
+			vector<edge> &tmpEdgeList = polyVectorsOut.back();
 			tmpEdgeList.reserve(polySize);
 
 			// iterate over this single polygon and create edges up to (but not including) final edge
@@ -490,9 +556,6 @@ void edgeOffset(layer &L, vector<int> regionIndex, vector<edge> &edgeListOut, ve
 			e.f.x = allContoursOut[j][0].X * intersectRange;  // ending point of edge = first polygon point
 			e.f.y = allContoursOut[j][0].Y * intersectRange;
 			tmpEdgeList.push_back(e);
-
-			// add tmpEdgeList polyVectorsOut as a new, separate, vector
-			polyVectorsOut.push_back(tmpEdgeList);
 		}  // if polySize > 0
 	}  // end iteration over output polygons
 
@@ -599,7 +662,7 @@ vector<vertex> getBB(layer &L)
 	return BB;
 }
 
-int findInt(vector<vertex> &BB, vertex v1, vertex v2)
+int findInt(const vector<vertex> &BB, const vertex &v1, const vertex &v2)
 {
 	int bInt = 0;
 
@@ -722,7 +785,7 @@ path singleStripes(int layerNum, int trajectoryNum, AMconfig &configData)
 	return P;
 }
 
-path hatch(layer &L, vector<int> regionIndex, regionProfile &rProfile, double offset, double hatchAngle, double a_min, double a_max, bool outputIntegerIDs, vector<vertex> boundingBox)
+path hatch(layer &L, const vector<int> &regionIndex, regionProfile &rProfile, double offset, double hatchAngle, double a_min, double a_max, bool outputIntegerIDs, const vector<vertex> &boundingBox)
 {
 	/*	L: pointer to the layer structure
 	regionIndex: list of regions to be hatched.  Must all have the same tag identified in rProfile
@@ -731,11 +794,13 @@ path hatch(layer &L, vector<int> regionIndex, regionProfile &rProfile, double of
 	offset: hatch offset (from rProfile) with all contour offsets added
 	hatchAngle: hatch angle in degrees.  0 = horizontal to the left
 	a_min, a_max: min/max intercepts of hatch lines with vertices in L.vList, based on whether hatchAngle is closer to x or y axis
+		(from findHatchBoundary, or the narrower range on the same grid of lines from hatchBoundaryCache)
 		if hatchAngle is [315 to 45] or [135 to 225], these should be min/max y coordinates
 		however if hatchAngle is [45 to 135] or [225 to 315], these should be min/max x coordinates
 	outputIntegerIDs: whether to use auto-generated integer ID's for segments styles, or the original string ID's
 	boundingBox: vector of min/max x and y coordinates of this layer
 	*/
+	TIME_STAGE("hatch");
 
 	path P;  // path of hatch segments to be created
 	vector<edge> edgeList;
@@ -751,7 +816,7 @@ path hatch(layer &L, vector<int> regionIndex, regionProfile &rProfile, double of
 
 	// Determine primary hatching orientation (toward x or y axis), and adjust hSpace to account for hatchAngle
 	double hatchAngle_rads = hatchAngle * 3.14159265358979323846 / 180;  // hatch angle in radians
-	double hatchFunctionValue;  // sine or tangent value of hatchAngle_rads to be computed once and passed to findIntersection
+	double hatchFunctionValue;  // sine or tangent value of hatchAngle_rads to be computed once and passed to makeHatchLine
 	string primaryHatchDir;     // either y (progress along y axis) or x (progress along x axis), depending on hatchAngle
 	// Determine whether to generate hatches progressing along the vertical or horizontal axis based on hatch angle
 	if ((((int)hatchAngle + 315) % 180) > 90) {
@@ -808,23 +873,16 @@ path hatch(layer &L, vector<int> regionIndex, regionProfile &rProfile, double of
 
 	bool finished = false;  // use this to determine when we've reached a_end, since we could be incrementing or decrementing via hSpace
 	// We start at a_start + hSpace because a hatch exactly at a_start would have no length (it would be a one-point hatch)
-	vector<vertex> isList;  // list of intersections between edges and hatch lines
+	arenaVector<vertex> isList;  // list of intersections between edges and hatch lines
 	a_curr = a_start + hSpace;  // a_curr is the x or y intersection of the current hatch line
+	arenaVector<vertex> tmp_isList, tmp_isListNoDuplicates;  // temporary list of intersections between one hatch line and all edges for this region tag
+	tmp_isList.reserve(naiveTmpSize);  // number of intersections is not yet known; may be 0 or very large depending on geometry.  Re-used for every hatch line
+	edgeBlock edges;  // the offset edges in batch form, set up once for all hatch lines
+	makeEdgeBlock(edgeList, edges);
 	while (!finished)
 	{
-		vector<vertex> tmp_isList, tmp_isListNoDuplicates;  // temporary list of intersections between one hatch line and all edges for this region tag
-		tmp_isList.reserve(naiveTmpSize);  // number of intersections is not yet known; may be 0 or very large depending on geometry
-		for (vector<edge>::iterator it = edgeList.begin(); it != edgeList.end(); ++it)
-		{
-			//get intersection with edge
-			vertex is;
-			int isB;
-			isB = findIntersection(&is, hatchAngle, hatchAngle_rads, boundingBox, a_curr, *it, hatchFunctionValue);
-
-			// if an intersection was found (return value == 0), add to tmp intersection vector
-			if (isB == 0)
-				tmp_isList.push_back(is);
-		}
+		// get intersections of the current hatch line with all edges, in edge order
+		findIntersections(makeHatchLine(hatchAngle, boundingBox, a_curr, hatchFunctionValue), edges, tmp_isList);
 
 		// Now that we've evaluated a particular hatch line against all edges, process whatever intersections we have
 		//
@@ -860,7 +918,7 @@ path hatch(layer &L, vector<int> regionIndex, regionProfile &rProfile, double of
 			}
 
 			// remove any duplicate vertices
-			tmp_isListNoDuplicates = eliminateDuplicateVertices(tmp_isList);  // list must be sorted in x and y (or reverse) before calling this function
+			eliminateDuplicateVertices(tmp_isList, tmp_isListNoDuplicates);  // list must be sorted in x and y (or reverse) before calling this function
 
 			// If everything went well, tmp_isListNoDuplicates should contain an even number of vertices.
 			// however, due to the combination of "close enough = intersection" and "remove duplicates within proximity range" we
@@ -911,7 +969,7 @@ path hatch(layer &L, vector<int> regionIndex, regionProfile &rProfile, double of
 	segment sg;
 	int jump = 0;
 	vSg.reserve((int)isList.size());  // pre-size the output.  We know exactly how many segments we need, at this point
-	for (vector<vertex>::iterator it = isList.begin(); it != isList.end() - 1; ++it)
+	for (arenaVector<vertex>::iterator it = isList.begin(); it != isList.end() - 1; ++it)
 	{
 		sg.start = *it;
 		sg.end = *(it + 1);
@@ -932,7 +990,7 @@ path hatch(layer &L, vector<int> regionIndex, regionProfile &rProfile, double of
 	}
 
 	// finalize the output path
-	P.vecSg = vSg;
+	P.vecSg = move(vSg);
 	P.tag = rProfile.Tag;
 	P.SkyWritingMode = rProfile.hatchSkywriting;
 	P.type = "hatch";
@@ -940,7 +998,235 @@ path hatch(layer &L, vector<int> regionIndex, regionProfile &rProfile, double of
 	return P;
 }
 
-path hatchOPT(layer &L, vector<int> regionIndex, regionProfile &rProfile, double offset, double hatchAngle, double a_min, double a_max, bool outputIntegerIDs, vector<vertex> boundingBox)
+// one mark of hatchClip: a clipped piece of hatch line lineNum, with its ends ordered along the line
+struct hatchPiece
+{
+	int lineNum;			// index of the hatch line the piece came from
+	ClipperLib::cInt pos;	// position of the piece's start along the line (Clipper units)
+	vertex s, f;			// start and finish, in ascending order along the line
+};
+
+path hatchClip(layer &L, const vector<int> &regionIndex, regionProfile &rProfile, double offset, double hatchAngle, double a_min, double a_max, bool outputIntegerIDs, const vector<vertex> &boundingBox)
+{
+	/*	arguments are the same as for hatch()
+
+	Rather than intersecting every hatch line with every edge, the whole grid of hatch lines is added to a Clipper
+	object as open paths and clipped against the offset polygons with a single Execute.  Clipper works in integer
+	units of intersectRange, so each clipped piece of a hatch line is exactly one mark and there are no odd
+	intersection counts to recover from.  The pieces are then ordered along their hatch lines, zig-zagging from
+	line to line as in hatch(), and joined with jumps
+	*/
+	TIME_STAGE("hatchClip");
+
+	path P;  // path of hatch segments to be created
+	vector<segment> vSg;
+
+	double hSpace = rProfile.resHatch;  // hSpace is the spacing between hatches, which will be modified by hatchAngle
+	int dirHatch = 0;  // 0 = next line with marks runs in the positive direction, 1 = negative; flips on every such line
+
+	// Determine primary hatching orientation (toward x or y axis), and adjust hSpace to account for hatchAngle
+	double hatchAngle_rads = hatchAngle * 3.14159265358979323846 / 180;  // hatch angle in radians
+	double hatchFunctionValue;  // sine or tangent value of hatchAngle_rads to be computed once and passed to makeHatchLine
+	bool spacedAlongX;  // true if hatches intersect the x axis (and are ordered by y), false if they intersect the y axis (ordered by x)
+	if ((((int)hatchAngle + 315) % 180) > 90) {
+		// hatchAngle is [315 to 45] or [135 to 225] degrees; hatches are spaced along the y axis
+		spacedAlongX = false;
+		hSpace = hSpace / cos(hatchAngle_rads);
+		hatchFunctionValue = tan(hatchAngle_rads);
+	}
+	else {
+		// hatchAngle is [45 to 135] or [225 to 315] degrees; hatches are spaced along the x axis
+		spacedAlongX = true;
+		hSpace = hSpace / sin(hatchAngle_rads);
+		hatchFunctionValue = cos(hatchAngle_rads) / sin(hatchAngle_rads);  // can't use 1/tan, which fails at 90 degrees;
+	}
+
+	// Identify the segment styles, in terms of either their string or auto-generated integer ID's
+	string hatchSegStyle, jumpSegStyle;
+	if (outputIntegerIDs == true) {
+		hatchSegStyle = to_string(rProfile.hatchStyleIntID);
+		jumpSegStyle = to_string(rProfile.jumpStyleIntID);
+	}
+	else {
+		hatchSegStyle = rProfile.hatchStyleID;
+		jumpSegStyle = rProfile.jumpStyleID;
+	}
+
+	//*** Offset the regions under this tag, keeping the polygons in Clipper units
+	ClipperLib::Paths polygons;
+	offsetContours(L, regionIndex, offset, polygons);
+	if (polygons.size() == 0) {
+		// no result!
+		P.type = "";  // indicates null result
+		P.vecSg.clear();
+		return P;
+	}
+
+	//*** Lay the grid of hatch lines across the bounding box, stepping the intercept from a_min to a_max exactly as hatch() does
+	double a_start, a_end;
+	if (hSpace > 0) {
+		a_start = a_min;
+		a_end = a_max;
+	}
+	else {
+		a_start = a_max;
+		a_end = a_min;
+	}
+	ClipperLib::Clipper clipper;
+	ClipperLib::Path line(2);
+	double a_curr = a_start + hSpace;  // a hatch exactly at a_start would have no length
+	double a_first = a_curr;
+	int numLines = 0;
+	bool finished = false;
+	while (!finished)
+	{
+		hatchLine h = makeHatchLine(hatchAngle, boundingBox, a_curr, hatchFunctionValue);
+		line[0].X = (ClipperLib::cInt)round(h.start.x / intersectRange);
+		line[0].Y = (ClipperLib::cInt)round(h.start.y / intersectRange);
+		line[1].X = (ClipperLib::cInt)round(h.finish.x / intersectRange);
+		line[1].Y = (ClipperLib::cInt)round(h.finish.y / intersectRange);
+		clipper.AddPath(line, ClipperLib::ptSubject, false);  // open path
+		numLines++;
+
+		a_curr += hSpace;
+		if (hSpace > 0) {
+			if (a_curr >= a_end) { finished = true; }
+		}
+		else {
+			if (a_curr <= a_end) { finished = true; }
+		}
+	}
+
+	//*** Clip all hatch lines against the polygons at once.  Even-odd filling matches hatch(), where crossing any edge toggles mark/jump
+	clipper.AddPaths(polygons, ClipperLib::ptClip, true);
+	ClipperLib::PolyTree clipped;
+	clipper.Execute(ClipperLib::ctIntersection, clipped, ClipperLib::pftEvenOdd, ClipperLib::pftEvenOdd);
+	ClipperLib::Paths pieces;
+	ClipperLib::OpenPathsFromPolyTree(clipped, pieces);
+
+	// Clipper does not say which hatch line a piece came from, so recover it from the piece's intercept.
+	// Rounding moves the intercept by a few intersectRange at most, far less than half the hatch spacing
+	arenaVector<hatchPiece> marks;
+	marks.reserve(pieces.size());
+	for (ClipperLib::Paths::const_iterator pc = pieces.begin(); pc != pieces.end(); ++pc)
+	{
+		if (pc->size() < 2) { continue; }
+		// a piece may carry extra collinear points; its ends are its extreme points along the line
+		const ClipperLib::IntPoint *lo = &(*pc)[0], *hi = &(*pc)[0];
+		for (ClipperLib::Path::const_iterator pt = pc->begin(); pt != pc->end(); ++pt)
+		{
+			ClipperLib::cInt key = spacedAlongX ? pt->Y : pt->X;
+			if (key < (spacedAlongX ? lo->Y : lo->X)) { lo = &(*pt); }
+			if (key > (spacedAlongX ? hi->Y : hi->X)) { hi = &(*pt); }
+		}
+		if (*lo == *hi) { continue; }  // the line only touches the polygon
+
+		hatchPiece m;
+		m.s.x = lo->X * intersectRange;
+		m.s.y = lo->Y * intersectRange;
+		m.f.x = hi->X * intersectRange;
+		m.f.y = hi->Y * intersectRange;
+		m.pos = spacedAlongX ? lo->Y : lo->X;
+		double a = spacedAlongX ? (m.s.x - m.s.y * hatchFunctionValue) : (m.s.y - m.s.x * hatchFunctionValue);
+		m.lineNum = min(max((int)round((a - a_first) / hSpace), 0), numLines - 1);
+		marks.push_back(m);
+	}
+
+	// determine whether we have anything to output (any pieces of hatch inside the polygons)
+	if (marks.size() == 0) {
+		// no result!
+		P.type = "";  // indicates null result
+		P.vecSg.clear();
+		return P;
+	}
+
+	sort(marks.begin(), marks.end(), [](const hatchPiece &m1, const hatchPiece &m2) {
+		return (m1.lineNum < m2.lineNum) || ((m1.lineNum == m2.lineNum) && (m1.pos < m2.pos));
+	});
+
+	//*** Build the mark and jump segments line by line, alternating the direction of successive lines
+	segment sg;
+	vSg.reserve(2 * marks.size());
+	bool firstMark = true;
+	size_t lineStart = 0;
+	while (lineStart < marks.size())
+	{
+		size_t lineEnd = lineStart;
+		while ((lineEnd < marks.size()) && (marks[lineEnd].lineNum == marks[lineStart].lineNum)) { lineEnd++; }
+
+		for (size_t k = 0; k < lineEnd - lineStart; k++)
+		{
+			const hatchPiece &m = (dirHatch == 0) ? marks[lineStart + k] : marks[lineEnd - 1 - k];
+			vertex markStart = (dirHatch == 0) ? m.s : m.f;
+			vertex markEnd = (dirHatch == 0) ? m.f : m.s;
+			if (!firstMark) {
+				// jump from the end of the previous mark
+				sg.start = vSg.back().end;
+				sg.end = markStart;
+				sg.idSegStyl = jumpSegStyle;
+				sg.isMark = 0;
+				vSg.push_back(sg);
+			}
+			sg.start = markStart;
+			sg.end = markEnd;
+			sg.idSegStyl = hatchSegStyle;
+			sg.isMark = 1;
+			vSg.push_back(sg);
+			firstMark = false;
+		}
+		dirHatch = 1 - dirHatch;
+		lineStart = lineEnd;
+	}
+
+	// finalize the output path
+	P.vecSg = move(vSg);
+	P.tag = rProfile.Tag;
+	P.SkyWritingMode = rProfile.hatchSkywriting;
+	P.type = "hatch";
+
+	return P;
+}
+
+// trace a hatch island as it will be scanned, as the gap patch at the end of hatchOPT does for the whole path:
+// a segment which does not start where the previous one ended is turned round if it ends there, or else reached by a jump.
+// Afterwards the island runs head to tail from start to end, and can be reversed
+static void traceIsland(hRegion &hrg, const string &jumpSegStyle)
+{
+	vector<segment> traced;
+	traced.reserve(hrg.vecSg.size() + hrg.vecSg.size() / 2);
+	vertex cur = hrg.start;
+	for (vector<segment>::iterator sg = hrg.vecSg.begin(); sg != hrg.vecSg.end(); ++sg)
+	{
+		if ((cur.x != (*sg).start.x) || (cur.y != (*sg).start.y))
+		{
+			if ((cur.x == (*sg).end.x) && (cur.y == (*sg).end.y)) {
+				swap((*sg).start, (*sg).end);
+			}
+			else {
+				segment jump;
+				jump.start = cur;
+				jump.end = (*sg).start;
+				jump.idSegStyl = jumpSegStyle;
+				jump.isMark = 0;
+				traced.push_back(jump);
+			}
+		}
+		traced.push_back(*sg);
+		cur = (*sg).end;
+	}
+	hrg.vecSg = move(traced);
+	hrg.end = cur;
+}
+
+// run a traced hatch island backwards
+static void reverseIsland(hRegion &hrg)
+{
+	reverse(hrg.vecSg.begin(), hrg.vecSg.end());
+	for (vector<segment>::iterator sg = hrg.vecSg.begin(); sg != hrg.vecSg.end(); ++sg) { swap((*sg).start, (*sg).end); }
+	swap(hrg.start, hrg.end);
+}
+
+path hatchOPT(layer &L, const vector<int> &regionIndex, regionProfile &rProfile, double offset, double hatchAngle, double a_min, double a_max, bool outputIntegerIDs, const vector<vertex> &boundingBox, bool refineTour)
 {
 	/*	L: pointer to the layer structure
 	regionIndex: list of regions to be hatched.  Must all have the same tag identified in rProfile
@@ -949,11 +1235,14 @@ path hatchOPT(layer &L, vector<int> regionIndex, regionProfile &rProfile, double
 	offset: hatch offset (from rProfile) with all contour offsets added
 	hatchAngle: hatch angle in degrees.  0 = horizontal to the left
 	a_min, a_max: min/max intercepts of hatch lines with vertices in L.vList, based on whether hatchAngle is closer to x or y axis
+		(from findHatchBoundary, or the narrower range on the same grid of lines from hatchBoundaryCache)
 		if hatchAngle is [315 to 45] or [135 to 225], these should be min/max y coordinates
 		however if hatchAngle is [45 to 135] or [225 to 315], these should be min/max x coordinates
 	outputIntegerIDs: whether to use auto-generated integer ID's for segments styles, or the original string ID's
 	boundingBox: vector of min/max x and y coordinates of this layer
+	refineTour: if true, improve the order and direction of the hatch islands beyond the nearest-neighbour chain
 	*/
+	TIME_STAGE("hatchOPT");
 
 	path P;  // path of hatch segments to be created
 	vector<edge> edgeList;
@@ -968,7 +1257,7 @@ path hatchOPT(layer &L, vector<int> regionIndex, regionProfile &rProfile, double
 
 	// Determine primary hatching orientation (toward x or y axis), and adjust hSpace to account for hatchAngle
 	double hatchAngle_rads = hatchAngle * 3.14159265358979323846 / 180;  // hatch angle in radians
-	double hatchFunctionValue;  // sine or tangent value of hatchAngle_rads to be computed once and passed to findIntersection
+	double hatchFunctionValue;  // sine or tangent value of hatchAngle_rads to be computed once and passed to makeHatchLine
 	string primaryHatchDir;     // either y (progress along y axis) or x (progress along x axis), depending on hatchAngle
 	// Determine whether to generate hatches progressing along the vertical or horizontal axis based on hatch angle
 	if ((((int)hatchAngle + 315) % 180) > 90) {
@@ -1032,22 +1321,15 @@ path hatchOPT(layer &L, vector<int> regionIndex, regionProfile &rProfile, double
 	int hStart = 0;
 
 	//get intersection points between edges and hatch lines
+	arenaVector<vertex> tmp_isList, tmp_isListNoDuplicates;  // temporary list of intersections between one hatch line and all edges for this region tag
+	tmp_isList.reserve(naiveTmpSize);  // re-used for every hatch line
+	edgeBlock edges;  // the offset edges in batch form, set up once for all hatch lines
+	makeEdgeBlock(edgeList, edges);
 	while (!finished)
 	{
-		vector<vertex> tmp_isList, tmp_isListNoDuplicates;  // temporary list of intersections between one hatch line and all edges for this region tag
-		for (vector<edge>::iterator it = edgeList.begin(); it != edgeList.end(); ++it)
-		{
-			//get intersection with edge
-			vertex is;
-			int isB;
-			isB = findIntersection(&is, hatchAngle, hatchAngle_rads, boundingBox, a_curr, *it, hatchFunctionValue);
-			
-			// if an intersection was found (return value == 0), add to tmp intersection vector
-			if (isB == 0)
-			{
-				tmp_isList.push_back(is);
-			}	
-		}
+		tmp_isList.clear();
+		// get intersections of the current hatch line with all edges, in edge order
+		findIntersections(makeHatchLine(hatchAngle, boundingBox, a_curr, hatchFunctionValue), edges, tmp_isList);
 
 		// Now that we've evaluated a particular hatch line against all edges, process whatever intersections we have
 		//
@@ -1083,7 +1365,7 @@ path hatchOPT(layer &L, vector<int> regionIndex, regionProfile &rProfile, double
 			}
 
 			// remove any duplicate vertices
-			tmp_isListNoDuplicates = eliminateDuplicateVertices(tmp_isList);  // list must be sorted in x and y (or reverse) before calling this function
+			eliminateDuplicateVertices(tmp_isList, tmp_isListNoDuplicates);  // list must be sorted in x and y (or reverse) before calling this function
 
 			// If everything went well, tmp_isListNoDuplicates should contain an even number of vertices.
 			// however, due to the combination of "close enough = intersection" and "remove duplicates within proximity range" we
@@ -1216,6 +1498,41 @@ path hatchOPT(layer &L, vector<int> regionIndex, regionProfile &rProfile, double
 
 	//all hatches have now been generated.  put all disjoints regions in one vector
 	hRegionList.insert(hRegionList.end(), tmp_hRegionList.begin(), tmp_hRegionList.end());
+
+	if (refineTour)
+	{
+		// chain the islands by nearest neighbour plus 2-opt/Or-opt, letting any island run backwards (see pathOrder.h)
+		vector<tourStop> stops(hRegionList.size());
+		for (size_t h = 0; h < hRegionList.size(); h++)
+		{
+			traceIsland(hRegionList[h], jumpSegStyle);
+			stops[h].entries.push_back(hRegionList[h].start);
+			stops[h].exit = hRegionList[h].end;
+			stops[h].reversible = true;
+		}
+		tourOrder order = orderTour(stops, hRegionList[0].start, hatchRefineBudget_ms, hatchRefineMaxPasses);
+		vector<segment> vsgTour;
+		for (size_t k = 0; k < order.stops.size(); k++)
+		{
+			hRegion &hrg = hRegionList[order.stops[k]];
+			if (order.entries[order.stops[k]] == 1) { reverseIsland(hrg); }
+			if (k > 0)
+			{
+				segment sg;
+				sg.start = vsgTour.back().end;
+				sg.end = hrg.start;
+				sg.idSegStyl = jumpSegStyle;
+				sg.isMark = 0;
+				vsgTour.push_back(sg);
+			}
+			vsgTour.insert(vsgTour.end(), hrg.vecSg.begin(), hrg.vecSg.end());
+		}
+		P.vecSg = move(vsgTour);
+		P.tag = rProfile.Tag;
+		P.SkyWritingMode = rProfile.hatchSkywriting;
+		P.type = "hatch";
+		return P;
+	}
 	vector<segment> vsg;
 	vector<int> mapHrg(hRegionList.size(), 0);
 	int cnt = hRegionList.size();
@@ -1300,7 +1617,7 @@ path hatchOPT(layer &L, vector<int> regionIndex, regionProfile &rProfile, double
 	}
 	
 	// finalize the output path
-	P.vecSg = segVecNoHoles;
+	P.vecSg = move(segVecNoHoles);
 	P.tag = rProfile.Tag;
 	P.SkyWritingMode = rProfile.hatchSkywriting;
 	P.type = "hatch";
@@ -1308,7 +1625,7 @@ path hatchOPT(layer &L, vector<int> regionIndex, regionProfile &rProfile, double
 	return P;
 }
 
-path contour(layer &L, vector<int> regionIndex, regionProfile &rProfile, double offset, vector<vertex> BB, bool outputIntegerIDs)
+path contour(layer &L, const vector<int> &regionIndex, regionProfile &rProfile, double offset, const vector<vertex> &BB, bool outputIntegerIDs)
 {
 	/*	L is a pointer to the layer, which contains regions, edges and vertices.
 		regionIndex is a vector of region numbers (as measured from the start of (*L).s.rList) to be contoured together
@@ -1317,6 +1634,7 @@ path contour(layer &L, vector<int> regionIndex, regionProfile &rProfile, double
 		BB is the bounding box of the layer L, used to determine if any point lands out of bounds
 
 		Process:
+			Offset all regions, then order the offset rings to shorten the jumps between them (see pathOrder.h)
 			Iterate over regions in regionProfile
 				Offset the individual region
 				If this is not the first region, add a jump from prior region endpoint to first coordinate of this region
@@ -1324,6 +1642,7 @@ path contour(layer &L, vector<int> regionIndex, regionProfile &rProfile, double
 				Save the final segment endpoint into a temporary variable
 			Create a path out of the accumulated segments
 	*/
+	TIME_STAGE("contour");
 
 	// Identify the values we'll need
 	path P;
@@ -1368,6 +1687,9 @@ path contour(layer &L, vector<int> regionIndex, regionProfile &rProfile, double
 		return P;
 	}
 
+	// visit the offset rings in the order, and from the vertices, which shorten the jumps between them
+	orderRings(allOffsetEdges);
+
 	// Iterate over regions in allOffsetEdges
 	int numPopulatedRegions = 0;  // counts the number of regions with non-zero segments after offsetting
 	for (int r = 0; r != allOffsetEdges.size(); ++r)
@@ -1404,11 +1726,11 @@ path contour(layer &L, vector<int> regionIndex, regionProfile &rProfile, double
 	}
 
 	// Convert the segments into a path structure
-	P.vecSg = vSg;  // will have size zero if no result
+	P.vecSg = move(vSg);  // will have size zero if no result
 	P.tag = tag;
 	P.type = "contour";
 	P.SkyWritingMode = rProfile.cntrSkywriting;
-	if (vSg.size() == 0) {
+	if (P.vecSg.size() == 0) {
 		P.type = "";  // indicates no result
 		P.vecSg.clear();
 	}
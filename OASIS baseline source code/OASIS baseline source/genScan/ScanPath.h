@@ -29,6 +29,8 @@ New hatching/contouring functions should also be defined here.
 #include <algorithm>
 #include <math.h>
 #include "clipper.hpp"
+#include "scanArena.h"
+#include "hatchIntersect.h"	// batch hatch/edge intersection used by hatch and hatchOPT
 
 #include "readExcelConfig.h"
 
@@ -55,6 +57,21 @@ struct path
 	int SkyWritingMode = 0;	// Defines how and whether skywriting should be enabled for this path
 };
 
+// the two kinds of scanpath generated for a region: its contours and its hatch
+enum class regionType { contour, hatch };
+
+// "contour" or "hatch", for console output
+const char *regionTypeName(regionType type);
+
+// regions of a trajectory that are contoured or hatched together, in a single path: those with the same type and tag
+struct regionGroup
+{
+	regionType type;
+	string tag;
+	int profile = -1;		// index of the tag's region profile in regionProfileList, or -1 if there is none
+	vector<int> regions;	// region numbers (order in the region list from XML), in that order
+};
+
 //data structure to define a single trajectory, a collection of paths.
 //In the multi-laser schema, trajectories are not dedicated to a single laser and may contain paths that utilize different lasers.
 struct trajectory
@@ -67,10 +84,10 @@ struct trajectory
 	vector<int> trajRegions;		// list of regions under this trajectory number as identified by their order in the region list from XML.
 		// NOTE - if contour and hatch for a region use the same trajectory#, they will appear twice
 		// in trajRegions and trajRegionTypes because the two components are different paths and have different trajRegionTypes values
-	vector<string> trajRegionTypes;	// identifies which of the two types each element of trajRegions refers to.  contour or hatch
+	vector<regionType> trajRegionTypes;	// identifies which of the two types each element of trajRegions refers to.  contour or hatch
 	vector<string> trajRegionTags;	// indicates the tag assigned to the corresponding region in trajRegions
-	vector<bool> trajRegionIsHatched; // indicates whether each region has already been hatched, to enable multiple regions to be done concurrently
 	vector<region*> trajRegionLinks;// link to the actual regions listed in trajRegions, to simplify referencing
+	vector<regionGroup> regionGroups;	// trajRegions grouped by type and tag, in the order of each group's first region
 };
 
 //data structure to represent a subset of path
@@ -100,30 +117,64 @@ double rAngle(ray r1, ray r2);
 //function to convert an edge to a vector
 ray e2r(edge e);
 
+//offsets the contours of a set of regions (as edgeOffset does) and returns the offset polygons in Clipper integer units of intersectRange
+void offsetContours(layer &L, const vector<int> &regionIndex, double offset, ClipperLib::Paths &contoursOut);
+
 //given an vector of edge lists (assumed to be closed contours), their types (inner/outer) and offset, this function calculates a new set of offseted edges.
 // only one of edgeListOut or polyVectorsOut will be populated, based on returnPolyVectors.  true --> polyVectorsOut is used, false --> edgeListOut instead
-void edgeOffset(layer &L, vector<int> regionIndex, vector<edge> &edgeListOut, vector<vector<edge>> &polyVectorsOut, double offset, bool returnPolyVectors);
+void edgeOffset(layer &L, const vector<int> &regionIndex, vector<edge> &edgeListOut, vector<vector<edge>> &polyVectorsOut, double offset, bool returnPolyVectors);
 
-// helper function to determine endpoints of hatching (min/max x or y coordinates)
-void findHatchBoundary(vector<vertex> &in, double hatchAngle, double *a_min, double *a_max);
+// helper function to determine endpoints of hatching (min/max x or y coordinates).  a_min = a_max = 0 if in is empty
+void findHatchBoundary(const vector<vertex> &in, double hatchAngle, double *a_min, double *a_max);
+
+// a_min/a_max for hatching groups of a layer's regions, from hatch-line intercepts projected once per layer and hatch angle.
+// Each group's range covers only its own regions, but stays on the grid of hatch lines that findHatchBoundary's range over
+// the whole layer gives, so hatch and hatchOPT draw the same lines and skip only the empty ones outside the group
+class hatchBoundaryCache
+{
+public:
+	// forget the projections of the previous layer
+	void clear();
+
+	// range of intercepts to pass to hatch, hatchOPT or hatchClip for the regions in regionIndex, hatched at hatchAngle
+	// with spacing resHatch and hatch offset offset
+	void hatchBoundary(const layer &L, const vector<int> &regionIndex, double hatchAngle, double resHatch, double offset, double *a_min, double *a_max);
+
+	size_t hatchAngles() const { return frames.size(); }	// whole-layer projections made since clear(), one per hatch angle
+	size_t hatchGroups() const { return groups; }			// groups of regions given a range since clear()
+
+private:
+	// intercepts at one hatch angle: of the whole layer, and of each region once it has been projected
+	struct hatchFrame
+	{
+		double hatchAngle;
+		double layerMin, layerMax;
+		vector<double> regionMin, regionMax;
+		vector<char> regionProjected;
+	};
+	vector<hatchFrame> frames;	// a layer has only a few hatch angles, so these are searched in order
+	size_t groups = 0;
+};
 
 //helper function to find intersection between an edge and a hatch line using hatch angle and x or y intercept
-int findIntersection(vertex *out, double hatchAngle, double hatchAngle_rads, vector<vertex> BB, double intercept, edge e, double hatchFunctionValue);
+// (one edge per call; hatch and hatchOPT use the batch form findIntersections from hatchIntersect.h)
+int findIntersection(vertex *out, double hatchAngle, const vector<vertex> &BB, double intercept, const edge &e, double hatchFunctionValue);
 
 //helper function to sort vertices with ascending y coordinates
-void yAsc(vector<vertex> &vertexList);
+void yAsc(arenaVector<vertex> &vertexList);
 
 //helper function to sort vertices with descending y coordinates
-void yDsc(vector<vertex> &vertexList);
+void yDsc(arenaVector<vertex> &vertexList);
 
 //helper function to sort vertices with ascending x coordinates
-void xAsc(vector<vertex> &vertexList);
+void xAsc(arenaVector<vertex> &vertexList);
 
 //helper function to sort vertices with descending x coordinates
-void xDsc(vector<vertex> &vertexList);
+void xDsc(arenaVector<vertex> &vertexList);
 
 //helper function that removes duplicate entries, which may arise when a hatch line crosses precisely through a vertex of multiple edges
-vector<vertex> eliminateDuplicateVertices(vector<vertex> &vertexList);
+//the result is written to vListOut (cleared first)
+void eliminateDuplicateVertices(const arenaVector<vertex> &vertexList, arenaVector<vertex> &vListOut);
 
 //function to calculate distance between two vertices
 double dist(vertex &v1, vertex &v2);
@@ -135,13 +186,19 @@ vector<int> singleStripeCount(int layerNum, AMconfig &configData);  // return va
 path singleStripes(int layerNum, int trajectoryNum, AMconfig &configData);
 
 // function to determine hatching path for all regions with a particular tag, without any constraints on distance
-path hatch(layer &L, vector<int> regionIndex, regionProfile &rProfile, double offset, double hatchAngle, double a_min, double a_max, bool outputIntegerIDs, vector<vertex> boundingBox);
+path hatch(layer &L, const vector<int> &regionIndex, regionProfile &rProfile, double offset, double hatchAngle, double a_min, double a_max, bool outputIntegerIDs, const vector<vertex> &boundingBox);
+
+// function to determine hatching path for all regions with a particular tag by clipping the whole grid of hatch lines
+// against the offset polygons in one Clipper operation.  Same arguments and output as hatch
+path hatchClip(layer &L, const vector<int> &regionIndex, regionProfile &rProfile, double offset, double hatchAngle, double a_min, double a_max, bool outputIntegerIDs, const vector<vertex> &boundingBox);
 
-// function to determine hatching path for all regions with a particular tag - while minimizing total travel distance
-path hatchOPT(layer &L, vector<int> regionIndex, regionProfile &rProfile, double offset, double hatchAngle, double a_min, double a_max, bool outputIntegerIDs, vector<vertex> boundingBox);
+// function to determine hatching path for all regions with a particular tag - while minimizing total travel distance.
+// If refineTour is true, the nearest-neighbour chain of hatch islands is improved by local search (see pathOrder.h),
+// which may also run islands backwards, within hatchRefineMaxPasses and hatchRefineBudget_ms
+path hatchOPT(layer &L, const vector<int> &regionIndex, regionProfile &rProfile, double offset, double hatchAngle, double a_min, double a_max, bool outputIntegerIDs, const vector<vertex> &boundingBox, bool refineTour = false);
 
 // function to create a contouring path for the inner or outer boundary of a specific region
-path contour(layer &L, vector<int> regionIndex, regionProfile &rProfile, double offset, vector<vertex> BB, bool outputIntegerIDs);
+path contour(layer &L, const vector<int> &regionIndex, regionProfile &rProfile, double offset, const vector<vertex> &BB, bool outputIntegerIDs);
 
 //decides whether edges are turing CW or CCW to determine whether that portion of the curve is convex or not
 int getTurnDir(edge ev1, edge ev2);
@@ -153,4 +210,4 @@ void displayPath(path P);
 vector<vertex> getBB(layer &L);
 
 //failsafe to see if any hatch/contour is leaving the bounding box. The line in question is defined by the vertices
-int findInt(vector<vertex> &BB, vertex v1, vertex v2);
+int findInt(const vector<vertex> &BB, const vertex &v1, const vertex &v2);
@@ -0,0 +1,285 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+hatchIntersect.cpp implements the batch hatch/edge intersection
+kernel described in hatchIntersect.h.
+
+The test for each edge is the one in findIntersection: the hatch
+and edge lines must not be parallel (|det| / edge length must be at
+least minDeterminant) and the crossing point must lie within
+intersectRange of both segments.  The vector paths compute every
+lane without branching, combine the rejection tests into one mask
+and append the surviving lanes in edge order.  Comparisons are
+ordered, so a NaN never rejects a lane, just as it never satisfies
+the < and > tests in findIntersection
+//============================================================*/
+
+#include "hatchIntersect.h"
+#include "constants.h"
+
+#include <cmath>
+#include <algorithm>
+
+// edges tested per step, chosen from the instruction set the compiler targets (as in genLayer's stlMesh.cpp)
+#if defined(__AVX__)
+	#define HATCH_SIMD_WIDTH 4
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define HATCH_SIMD_WIDTH 2
+	#include <emmintrin.h>
+#else
+	#define HATCH_SIMD_WIDTH 1
+#endif
+
+hatchLine makeHatchLine(double hatchAngle, const vector<vertex> &BB, double intercept, double hatchFunctionValue)
+{
+	// see findIntersection for how the hatch angle selects the intercept axis and hatch direction
+	hatchLine h;
+	double bL, bR, bB, bT;	//left, right, bottom, top coordinates of bounding box
+	bL = BB[0].x;
+	bR = BB[1].x;
+	bB = BB[2].y;
+	bT = BB[3].y;
+
+	if ((((int)hatchAngle + 315) % 180) > 90) {
+		// intercept is along the y axis
+		if (hatchAngle > 90) {
+			h.start.x = bR;
+			h.finish.x = bL;
+		}
+		else {
+			h.start.x = bL;
+			h.finish.x = bR;
+		}
+		h.start.y = intercept + h.start.x * hatchFunctionValue;
+		h.finish.y = intercept + h.finish.x * hatchFunctionValue;
+	}
+	else {
+		// intercept is along the x axis
+		if (hatchAngle > 180) {
+			h.start.y = bB;
+			h.finish.y = bT;
+		}
+		else {
+			h.start.y = bT;
+			h.finish.y = bB;
+		}
+		h.start.x = intercept + h.start.y * hatchFunctionValue;
+		h.finish.x = intercept + h.finish.y * hatchFunctionValue;
+	}
+
+	h.a = h.finish.y - h.start.y;
+	h.b = h.start.x - h.finish.x;
+	h.c = h.a*(h.start.x) + h.b*(h.start.y);
+	h.minX = min(h.start.x, h.finish.x) - intersectRange;
+	h.maxX = max(h.start.x, h.finish.x) + intersectRange;
+	h.minY = min(h.start.y, h.finish.y) - intersectRange;
+	h.maxY = max(h.start.y, h.finish.y) + intersectRange;
+	return h;
+}
+
+void makeEdgeBlock(const vector<edge> &edges, edgeBlock &block)
+{
+	size_t n = edges.size();
+	arenaVector<double> *cols[] = { &block.a1, &block.b1, &block.c1, &block.len, &block.minX, &block.maxX, &block.minY, &block.maxY };
+	for (arenaVector<double> *col : cols) {
+		col->clear();
+		col->reserve(n);
+	}
+
+	for (const edge &e : edges) {
+		double a1 = e.f.y - e.s.y;
+		double b1 = e.s.x - e.f.x;
+		block.a1.push_back(a1);
+		block.b1.push_back(b1);
+		block.c1.push_back(a1*(e.s.x) + b1*(e.s.y));
+		block.len.push_back(sqrt(pow((e.s.x - e.f.x), 2) + pow((e.s.y - e.f.y), 2)));
+		block.minX.push_back(min(e.s.x, e.f.x) - intersectRange);
+		block.maxX.push_back(max(e.s.x, e.f.x) + intersectRange);
+		block.minY.push_back(min(e.s.y, e.f.y) - intersectRange);
+		block.maxY.push_back(max(e.s.y, e.f.y) + intersectRange);
+	}
+}
+
+// test a single edge; used for the lanes left over after the vector loop, and for the whole block on other targets
+static inline void intersectOne(const hatchLine &h, const edgeBlock &block, size_t i, arenaVector<vertex> &out)
+{
+	double a1 = block.a1[i];
+	double b1 = block.b1[i];
+	double c1 = block.c1[i];
+	double det = h.a*b1 - a1*h.b;
+	if (abs(det) / block.len[i] < minDeterminant)
+		return;
+
+	double x = (b1*h.c - h.b*c1) / det;
+	double y = (h.a*c1 - a1*h.c) / det;
+	if ((x < h.minX) | (x > h.maxX) | (y < h.minY) | (y > h.maxY))
+		return;
+	if ((x < block.minX[i]) | (x > block.maxX[i]) | (y < block.minY[i]) | (y > block.maxY[i]))
+		return;
+
+	vertex v;
+	v.x = x;
+	v.y = y;
+	out.push_back(v);
+}
+
+void findIntersections(const hatchLine &h, const edgeBlock &block, arenaVector<vertex> &out)
+{
+	size_t n = block.size();
+	size_t i = 0;
+
+#if HATCH_SIMD_WIDTH == 4
+	const __m256d a = _mm256_set1_pd(h.a);
+	const __m256d b = _mm256_set1_pd(h.b);
+	const __m256d c = _mm256_set1_pd(h.c);
+	const __m256d hMinX = _mm256_set1_pd(h.minX);
+	const __m256d hMaxX = _mm256_set1_pd(h.maxX);
+	const __m256d hMinY = _mm256_set1_pd(h.minY);
+	const __m256d hMaxY = _mm256_set1_pd(h.maxY);
+	const __m256d minDet = _mm256_set1_pd(minDeterminant);
+	const __m256d signBit = _mm256_set1_pd(-0.0);
+	for (; i + 4 <= n; i += 4) {
+		__m256d a1 = _mm256_loadu_pd(&block.a1[i]);
+		__m256d b1 = _mm256_loadu_pd(&block.b1[i]);
+		__m256d c1 = _mm256_loadu_pd(&block.c1[i]);
+		__m256d det = _mm256_sub_pd(_mm256_mul_pd(a, b1), _mm256_mul_pd(a1, b));
+		__m256d reject = _mm256_cmp_pd(_mm256_div_pd(_mm256_andnot_pd(signBit, det), _mm256_loadu_pd(&block.len[i])), minDet, _CMP_LT_OQ);
+
+		__m256d x = _mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(b1, c), _mm256_mul_pd(b, c1)), det);
+		__m256d y = _mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(a, c1), _mm256_mul_pd(a1, c)), det);
+		reject = _mm256_or_pd(reject, _mm256_or_pd(_mm256_cmp_pd(x, hMinX, _CMP_LT_OQ), _mm256_cmp_pd(x, hMaxX, _CMP_GT_OQ)));
+		reject = _mm256_or_pd(reject, _mm256_or_pd(_mm256_cmp_pd(y, hMinY, _CMP_LT_OQ), _mm256_cmp_pd(y, hMaxY, _CMP_GT_OQ)));
+		reject = _mm256_or_pd(reject, _mm256_or_pd(_mm256_cmp_pd(x, _mm256_loadu_pd(&block.minX[i]), _CMP_LT_OQ), _mm256_cmp_pd(x, _mm256_loadu_pd(&block.maxX[i]), _CMP_GT_OQ)));
+		reject = _mm256_or_pd(reject, _mm256_or_pd(_mm256_cmp_pd(y, _mm256_loadu_pd(&block.minY[i]), _CMP_LT_OQ), _mm256_cmp_pd(y, _mm256_loadu_pd(&block.maxY[i]), _CMP_GT_OQ)));
+
+		int hits = ~_mm256_movemask_pd(reject) & 0xF;
+		if (hits != 0) {
+			double xs[4], ys[4];
+			_mm256_storeu_pd(xs, x);
+			_mm256_storeu_pd(ys, y);
+			for (int lane = 0; lane < 4; lane++) {
+				if (hits & (1 << lane)) {
+					vertex v;
+					v.x = xs[lane];
+					v.y = ys[lane];
+					out.push_back(v);
+				}
+			}
+		}
+	}
+#elif HATCH_SIMD_WIDTH == 2
+	const __m128d a = _mm_set1_pd(h.a);
+	const __m128d b = _mm_set1_pd(h.b);
+	const __m128d c = _mm_set1_pd(h.c);
+	const __m128d hMinX = _mm_set1_pd(h.minX);
+	const __m128d hMaxX = _mm_set1_pd(h.maxX);
+	const __m128d hMinY = _mm_set1_pd(h.minY);
+	const __m128d hMaxY = _mm_set1_pd(h.maxY);
+	const __m128d minDet = _mm_set1_pd(minDeterminant);
+	const __m128d signBit = _mm_set1_pd(-0.0);
+	for (; i + 2 <= n; i += 2) {
+		__m128d a1 = _mm_loadu_pd(&block.a1[i]);
+		__m128d b1 = _mm_loadu_pd(&block.b1[i]);
+		__m128d c1 = _mm_loadu_pd(&block.c1[i]);
+		__m128d det = _mm_sub_pd(_mm_mul_pd(a, b1), _mm_mul_pd(a1, b));
+		__m128d reject = _mm_cmplt_pd(_mm_div_pd(_mm_andnot_pd(signBit, det), _mm_loadu_pd(&block.len[i])), minDet);
+
+		__m128d x = _mm_div_pd(_mm_sub_pd(_mm_mul_pd(b1, c), _mm_mul_pd(b, c1)), det);
+		__m128d y = _mm_div_pd(_mm_sub_pd(_mm_mul_pd(a, c1), _mm_mul_pd(a1, c)), det);
+		reject = _mm_or_pd(reject, _mm_or_pd(_mm_cmplt_pd(x, hMinX), _mm_cmpgt_pd(x, hMaxX)));
+		reject = _mm_or_pd(reject, _mm_or_pd(_mm_cmplt_pd(y, hMinY), _mm_cmpgt_pd(y, hMaxY)));
+		reject = _mm_or_pd(reject, _mm_or_pd(_mm_cmplt_pd(x, _mm_loadu_pd(&block.minX[i])), _mm_cmpgt_pd(x, _mm_loadu_pd(&block.maxX[i]))));
+		reject = _mm_or_pd(reject, _mm_or_pd(_mm_cmplt_pd(y, _mm_loadu_pd(&block.minY[i])), _mm_cmpgt_pd(y, _mm_loadu_pd(&block.maxY[i]))));
+
+		int hits = ~_mm_movemask_pd(reject) & 0x3;
+		if (hits != 0) {
+			double xs[2], ys[2];
+			_mm_storeu_pd(xs, x);
+			_mm_storeu_pd(ys, y);
+			for (int lane = 0; lane < 2; lane++) {
+				if (hits & (1 << lane)) {
+					vertex v;
+					v.x = xs[lane];
+					v.y = ys[lane];
+					out.push_back(v);
+				}
+			}
+		}
+	}
+#endif
+
+	for (; i < n; i++)
+		intersectOne(h, block, i, out);
+}
+
+void interceptRange(const vertex *v, size_t n, double hatchFunctionValue, bool yIntercept, double *a_min, double *a_max)
+{
+	// the vertices are read as an array of x, y pairs
+	static_assert(sizeof(vertex) == 2 * sizeof(double), "vertex must be two packed doubles");
+	const double *p = &v[0].x;
+	double lo = *a_min, hi = *a_max;
+	size_t i = 0;
+
+#if HATCH_SIMD_WIDTH == 4
+	const __m256d s = _mm256_set1_pd(hatchFunctionValue);
+	__m256d vLo = _mm256_set1_pd(lo);
+	__m256d vHi = _mm256_set1_pd(hi);
+	for (; i + 4 <= n; i += 4) {
+		__m256d v01 = _mm256_loadu_pd(p + 2 * i);		// x0 y0 x1 y1
+		__m256d v23 = _mm256_loadu_pd(p + 2 * i + 4);	// x2 y2 x3 y3
+		__m256d x = _mm256_unpacklo_pd(v01, v23);		// x0 x2 x1 x3
+		__m256d y = _mm256_unpackhi_pd(v01, v23);
+		__m256d a = yIntercept ? _mm256_sub_pd(y, _mm256_mul_pd(x, s)) : _mm256_sub_pd(x, _mm256_mul_pd(y, s));
+		vLo = _mm256_min_pd(vLo, a);
+		vHi = _mm256_max_pd(vHi, a);
+	}
+	double los[4], his[4];
+	_mm256_storeu_pd(los, vLo);
+	_mm256_storeu_pd(his, vHi);
+	for (int lane = 0; lane < 4; lane++) {
+		lo = min(lo, los[lane]);
+		hi = max(hi, his[lane]);
+	}
+#elif HATCH_SIMD_WIDTH == 2
+	const __m128d s = _mm_set1_pd(hatchFunctionValue);
+	__m128d vLo = _mm_set1_pd(lo);
+	__m128d vHi = _mm_set1_pd(hi);
+	for (; i + 2 <= n; i += 2) {
+		__m128d v0 = _mm_loadu_pd(p + 2 * i);		// x0 y0
+		__m128d v1 = _mm_loadu_pd(p + 2 * i + 2);	// x1 y1
+		__m128d x = _mm_unpacklo_pd(v0, v1);		// x0 x1
+		__m128d y = _mm_unpackhi_pd(v0, v1);
+		__m128d a = yIntercept ? _mm_sub_pd(y, _mm_mul_pd(x, s)) : _mm_sub_pd(x, _mm_mul_pd(y, s));
+		vLo = _mm_min_pd(vLo, a);
+		vHi = _mm_max_pd(vHi, a);
+	}
+	double los[2], his[2];
+	_mm_storeu_pd(los, vLo);
+	_mm_storeu_pd(his, vHi);
+	for (int lane = 0; lane < 2; lane++) {
+		lo = min(lo, los[lane]);
+		hi = max(hi, his[lane]);
+	}
+#endif
+
+	for (; i < n; i++) {
+		double a = yIntercept ? (p[2 * i + 1] - p[2 * i] * hatchFunctionValue) : (p[2 * i] - p[2 * i + 1] * hatchFunctionValue);
+		lo = min(lo, a);
+		hi = max(hi, a);
+	}
+	*a_min = lo;
+	*a_max = hi;
+}
@@ -0,0 +1,65 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+hatchIntersect.h defines the batch kernel that intersects one
+hatch line with a block of edges.  It gives the same intersections,
+in the same order, as calling findIntersection for every edge, but
+the hatch line is set up once per intercept and the edge terms once
+per hatch call, and the edges are tested several at a time.
+
+The kernel uses AVX (4 edges per step) when the compiler targets it
+(e.g. -mavx2 or /arch:AVX2), SSE2 (2 edges) on other x86-64 builds
+and plain C++ elsewhere.  All paths evaluate the same expressions
+in the same order, so results do not depend on the instruction set.
+
+interceptRange projects vertices onto the hatch axis with the same
+instruction sets, to find the range of hatch lines they span
+//============================================================*/
+
+#pragma once
+
+#include "Layer.h"
+#include "scanArena.h"
+
+// one hatch line: its endpoints on the layer's bounding box, the line a*x + b*y = c, and its extent widened by intersectRange
+struct hatchLine
+{
+	vertex start;
+	vertex finish;
+	double a, b, c;
+	double minX, maxX, minY, maxY;
+};
+
+// edges in structure-of-arrays form, with the terms of findIntersection that depend only on the edge
+struct edgeBlock
+{
+	arenaVector<double> a1, b1, c1;		// the edge's line a1*x + b1*y = c1
+	arenaVector<double> len;			// edge length
+	arenaVector<double> minX, maxX, minY, maxY;	// edge extent widened by intersectRange
+	size_t size() const { return a1.size(); }
+};
+
+// set up the hatch line for an intercept, as findIntersection does.  BB is the layer bounding box from getBB
+hatchLine makeHatchLine(double hatchAngle, const vector<vertex> &BB, double intercept, double hatchFunctionValue);
+
+// fill block with the edges (replacing any previous contents)
+void makeEdgeBlock(const vector<edge> &edges, edgeBlock &block);
+
+// append the intersections of hatch line h with the edges in block to out, in edge order
+void findIntersections(const hatchLine &h, const edgeBlock &block, arenaVector<vertex> &out);
+
+// extend [*a_min, *a_max] to cover the hatch-line intercepts of the n vertices at v: v.y - v.x*hatchFunctionValue if yIntercept,
+// otherwise v.x - v.y*hatchFunctionValue (as in findHatchBoundary).  The caller initialises the range, e.g. to +/-DBL_MAX
+void interceptRange(const vertex *v, size_t n, double hatchFunctionValue, bool yIntercept, double *a_min, double *a_max);
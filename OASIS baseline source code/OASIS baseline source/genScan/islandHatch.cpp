@@ -0,0 +1,425 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+islandHatch.cpp implements the island and stripe hatching
+described in islandHatch.h
+//============================================================*/
+
+#include "islandHatch.h"
+#include "constants.h"
+#include "runReport.h"
+
+#include <atomic>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <thread>
+
+// one piece of the hatch field, a square island or a stripe, and the marks and jumps which hatch it
+struct fieldPiece
+{
+	long long ku, kv;			// position along the grid's u and v axes, in piece widths.  Stripes have kv = 0
+	ClipperLib::Path outline;	// corners, in Clipper units
+	ClipperLib::IntRect bounds;
+	double hatchAngle;			// degrees
+	vector<segment> vSg;		// empty until hatched, and if the piece misses the regions
+};
+
+// one clipped piece of a hatch line, with its ends ordered along the line
+struct linePiece
+{
+	long long lineNum;			// hatch line, counted on the layer's common grid of lines
+	double pos;					// position of the start along the line (Clipper units)
+	vertex s, f;
+};
+
+static ClipperLib::IntRect pathBounds(const ClipperLib::Path &p)
+{
+	ClipperLib::IntRect r;
+	r.left = r.top = numeric_limits<ClipperLib::cInt>::max();
+	r.right = r.bottom = numeric_limits<ClipperLib::cInt>::min();
+	for (ClipperLib::Path::const_iterator pt = p.begin(); pt != p.end(); ++pt)
+	{
+		r.left = min(r.left, pt->X);
+		r.right = max(r.right, pt->X);
+		r.top = min(r.top, pt->Y);
+		r.bottom = max(r.bottom, pt->Y);
+	}
+	return r;
+}
+
+static bool overlaps(const ClipperLib::IntRect &a, const ClipperLib::IntRect &b)
+{
+	return (a.left <= b.right) && (b.left <= a.right) && (a.top <= b.bottom) && (b.top <= a.bottom);
+}
+
+// extent of the polygons along the axes u = (ux, uy) and v = (-uy, ux), in Clipper units
+static void polygonExtents(const ClipperLib::Paths &polygons, double ux, double uy, double *uMin, double *uMax, double *vMin, double *vMax)
+{
+	*uMin = *vMin = numeric_limits<double>::max();
+	*uMax = *vMax = -numeric_limits<double>::max();
+	for (ClipperLib::Paths::const_iterator pc = polygons.begin(); pc != polygons.end(); ++pc)
+	{
+		for (ClipperLib::Path::const_iterator pt = pc->begin(); pt != pc->end(); ++pt)
+		{
+			double u = pt->X * ux + pt->Y * uy;
+			double v = pt->Y * ux - pt->X * uy;
+			*uMin = min(*uMin, u);
+			*uMax = max(*uMax, u);
+			*vMin = min(*vMin, v);
+			*vMax = max(*vMax, v);
+		}
+	}
+}
+
+// the piece covering [u0, u1] x [v0, v1] along the axes u = (ux, uy) and v = (-uy, ux)
+static fieldPiece makePiece(long long ku, long long kv, double u0, double u1, double v0, double v1, double ux, double uy, double hatchAngle)
+{
+	fieldPiece fp;
+	fp.ku = ku;
+	fp.kv = kv;
+	fp.hatchAngle = hatchAngle;
+	double corners[4][2] = { { u0, v0 }, { u1, v0 }, { u1, v1 }, { u0, v1 } };
+	for (int c = 0; c < 4; c++)
+	{
+		fp.outline.push_back(ClipperLib::IntPoint((ClipperLib::cInt)round(corners[c][0] * ux - corners[c][1] * uy),
+			(ClipperLib::cInt)round(corners[c][0] * uy + corners[c][1] * ux)));
+	}
+	fp.bounds = pathBounds(fp.outline);
+	return fp;
+}
+
+// hatch one piece: intersect its outline with the regions, then clip hatch lines at the piece's angle against the result
+// and join them line by line, alternating direction as hatchClip does.  Runs on a worker thread, so it touches nothing
+// but the piece
+static void hatchOnePiece(fieldPiece &fp, const ClipperLib::Paths &polygons, const vector<ClipperLib::IntRect> &polygonBounds,
+	double hSpace, const string &hatchSegStyle, const string &jumpSegStyle)
+{
+	// 1. the part of the regions inside the piece.  Regions whose bounds miss the outline cannot change it
+	ClipperLib::Clipper clipper;
+	bool anyRegion = false;
+	for (size_t p = 0; p < polygons.size(); p++)
+	{
+		if (overlaps(polygonBounds[p], fp.bounds)) {
+			clipper.AddPath(polygons[p], ClipperLib::ptSubject, true);
+			anyRegion = true;
+		}
+	}
+	if (!anyRegion) { return; }
+	clipper.AddPath(fp.outline, ClipperLib::ptClip, true);
+	ClipperLib::Paths area;
+	clipper.Execute(ClipperLib::ctIntersection, area, ClipperLib::pftEvenOdd, ClipperLib::pftNonZero);
+	if (area.size() == 0) { return; }
+
+	// 2. hatch lines run along d and are spaced along n, half a spacing off the multiples of hSpace so that they
+	// miss piece borders on grids whose size is a multiple of the spacing
+	double angle_rads = fp.hatchAngle * 3.14159265358979323846 / 180;
+	double dx = cos(angle_rads), dy = sin(angle_rads);
+	double nx = -dy, ny = dx;
+	double spacing = hSpace / intersectRange;	// Clipper units
+	double tMin, tMax, nMin, nMax;
+	polygonExtents(area, dx, dy, &tMin, &tMax, &nMin, &nMax);
+	long long firstLine = (long long)ceil(nMin / spacing - 0.5);
+	long long lastLine = (long long)floor(nMax / spacing - 0.5);
+	if (lastLine < firstLine) { return; }
+
+	ClipperLib::Clipper lines;
+	ClipperLib::Path line(2);
+	for (long long k = firstLine; k <= lastLine; k++)
+	{
+		double n = (k + 0.5) * spacing;
+		line[0].X = (ClipperLib::cInt)round(n * nx + (tMin - 1) * dx);
+		line[0].Y = (ClipperLib::cInt)round(n * ny + (tMin - 1) * dy);
+		line[1].X = (ClipperLib::cInt)round(n * nx + (tMax + 1) * dx);
+		line[1].Y = (ClipperLib::cInt)round(n * ny + (tMax + 1) * dy);
+		lines.AddPath(line, ClipperLib::ptSubject, false);  // open path
+	}
+	lines.AddPaths(area, ClipperLib::ptClip, true);
+	ClipperLib::PolyTree clipped;
+	lines.Execute(ClipperLib::ctIntersection, clipped, ClipperLib::pftEvenOdd, ClipperLib::pftEvenOdd);
+	ClipperLib::Paths pieces;
+	ClipperLib::OpenPathsFromPolyTree(clipped, pieces);
+
+	// 3. order the pieces along their lines; each line is recovered from the position of the piece across the lines
+	vector<linePiece> marks;
+	marks.reserve(pieces.size());
+	for (ClipperLib::Paths::const_iterator pc = pieces.begin(); pc != pieces.end(); ++pc)
+	{
+		if (pc->size() < 2) { continue; }
+		const ClipperLib::IntPoint *lo = &(*pc)[0], *hi = &(*pc)[0];
+		double tLo = lo->X * dx + lo->Y * dy, tHi = tLo;
+		for (ClipperLib::Path::const_iterator pt = pc->begin(); pt != pc->end(); ++pt)
+		{
+			double t = pt->X * dx + pt->Y * dy;
+			if (t < tLo) { lo = &(*pt); tLo = t; }
+			if (t > tHi) { hi = &(*pt); tHi = t; }
+		}
+		if (*lo == *hi) { continue; }  // the line only touches the area
+
+		linePiece m;
+		m.s.x = lo->X * intersectRange;
+		m.s.y = lo->Y * intersectRange;
+		m.f.x = hi->X * intersectRange;
+		m.f.y = hi->Y * intersectRange;
+		m.pos = tLo;
+		m.lineNum = llround((lo->X * nx + lo->Y * ny) / spacing - 0.5);
+		marks.push_back(m);
+	}
+	sort(marks.begin(), marks.end(), [](const linePiece &m1, const linePiece &m2) {
+		return (m1.lineNum < m2.lineNum) || ((m1.lineNum == m2.lineNum) && (m1.pos < m2.pos));
+	});
+
+	segment sg;
+	fp.vSg.reserve(2 * marks.size());
+	int dirHatch = 0;  // 0 = next line with marks runs in the positive direction, 1 = negative
+	size_t lineStart = 0;
+	while (lineStart < marks.size())
+	{
+		size_t lineEnd = lineStart;
+		while ((lineEnd < marks.size()) && (marks[lineEnd].lineNum == marks[lineStart].lineNum)) { lineEnd++; }
+
+		for (size_t k = 0; k < lineEnd - lineStart; k++)
+		{
+			const linePiece &m = (dirHatch == 0) ? marks[lineStart + k] : marks[lineEnd - 1 - k];
+			vertex markStart = (dirHatch == 0) ? m.s : m.f;
+			vertex markEnd = (dirHatch == 0) ? m.f : m.s;
+			if (fp.vSg.size() > 0) {
+				sg.start = fp.vSg.back().end;
+				sg.end = markStart;
+				sg.idSegStyl = jumpSegStyle;
+				sg.isMark = 0;
+				fp.vSg.push_back(sg);
+			}
+			sg.start = markStart;
+			sg.end = markEnd;
+			sg.idSegStyl = hatchSegStyle;
+			sg.isMark = 1;
+			fp.vSg.push_back(sg);
+		}
+		dirHatch = 1 - dirHatch;
+		lineStart = lineEnd;
+	}
+}
+
+// hatch all pieces on worker threads, one per piecesPerThread pieces up to the number of cores
+static void hatchAllPieces(vector<fieldPiece> &pieces, size_t piecesPerThread, const ClipperLib::Paths &polygons, const vector<ClipperLib::IntRect> &polygonBounds,
+	double hSpace, const string &hatchSegStyle, const string &jumpSegStyle)
+{
+	atomic<size_t> nextPiece(0);
+	auto hatchSome = [&]() {
+		for (size_t n = nextPiece++; n < pieces.size(); n = nextPiece++)
+		{
+			hatchOnePiece(pieces[n], polygons, polygonBounds, hSpace, hatchSegStyle, jumpSegStyle);
+		}
+	};
+	size_t numWorkers = min((size_t)max(1u, thread::hardware_concurrency()), (pieces.size() + piecesPerThread - 1) / piecesPerThread);
+	if (numWorkers <= 1) {
+		hatchSome();
+	}
+	else {
+		vector<thread> workers;
+		for (size_t w = 0; w < numWorkers; w++)
+		{
+			workers.emplace_back(hatchSome);
+		}
+		for (size_t w = 0; w < numWorkers; w++)
+		{
+			workers[w].join();
+		}
+	}
+}
+
+// offset the regions under this tag, keeping the polygons in Clipper units, and find the bounds of each
+static bool fieldPolygons(layer &L, const vector<int> &regionIndex, double offset, ClipperLib::Paths &polygons, vector<ClipperLib::IntRect> &polygonBounds)
+{
+	offsetContours(L, regionIndex, offset, polygons);
+	polygonBounds.clear();
+	polygonBounds.reserve(polygons.size());
+	for (ClipperLib::Paths::const_iterator pc = polygons.begin(); pc != polygons.end(); ++pc)
+	{
+		polygonBounds.push_back(pathBounds(*pc));
+	}
+	return polygons.size() > 0;
+}
+
+// join the hatched pieces, in scanOrder, with jumps into a hatch path
+static path joinPieces(vector<fieldPiece> &pieces, const vector<size_t> &scanOrder, const regionProfile &rProfile, const string &jumpSegStyle)
+{
+	path P;
+	vector<segment> vSg;
+	size_t numSegments = 0;
+	for (size_t n = 0; n < scanOrder.size(); n++) { numSegments += pieces[scanOrder[n]].vSg.size() + 1; }
+	vSg.reserve(numSegments);
+	segment sg;
+	for (size_t n = 0; n < scanOrder.size(); n++)
+	{
+		vector<segment> &pieceSg = pieces[scanOrder[n]].vSg;
+		if (vSg.size() > 0) {
+			sg.start = vSg.back().end;
+			sg.end = pieceSg[0].start;
+			sg.idSegStyl = jumpSegStyle;
+			sg.isMark = 0;
+			vSg.push_back(sg);
+		}
+		vSg.insert(vSg.end(), make_move_iterator(pieceSg.begin()), make_move_iterator(pieceSg.end()));
+	}
+
+	// finalize the output path
+	P.vecSg = move(vSg);
+	P.tag = rProfile.Tag;
+	P.SkyWritingMode = rProfile.hatchSkywriting;
+	P.type = "hatch";
+
+	return P;
+}
+
+path hatchIslands(layer &L, const vector<int> &regionIndex, regionProfile &rProfile, double offset, double hatchAngle, int layerNum, bool outputIntegerIDs)
+{
+	TIME_STAGE("hatchIslands");
+
+	path P;  // null result unless some island is hatched
+	P.type = "";
+
+	// Identify the segment styles, in terms of either their string or auto-generated integer ID's
+	string hatchSegStyle, jumpSegStyle;
+	if (outputIntegerIDs == true) {
+		hatchSegStyle = to_string(rProfile.hatchStyleIntID);
+		jumpSegStyle = to_string(rProfile.jumpStyleIntID);
+	}
+	else {
+		hatchSegStyle = rProfile.hatchStyleID;
+		jumpSegStyle = rProfile.jumpStyleID;
+	}
+
+	//*** 1. Offset the regions under this tag
+	ClipperLib::Paths polygons;
+	vector<ClipperLib::IntRect> polygonBounds;
+	if (!fieldPolygons(L, regionIndex, offset, polygons, polygonBounds)) { return P; }
+
+	//*** 2. Lay the island grid over the polygons.  u and v are the grid's axes, turned by islandRotation from x and y,
+	// and the grid is moved along both by islandShift per layer.  Islands alternate between the hatch angle on "black"
+	// squares and 90 degrees to it on "white".  Islands are no narrower than the hatch spacing, which bounds their number
+	double size = max((rProfile.islandSize > 0) ? rProfile.islandSize : defaultIslandSize, rProfile.resHatch);  // mm
+	double rotation_rads = rProfile.islandRotation * 3.14159265358979323846 / 180;
+	double ux = cos(rotation_rads), uy = sin(rotation_rads);
+	double shift = fmod(fmod((layerNum - 1) * rProfile.islandShift, size) + size, size) / intersectRange;
+	double width = size / intersectRange;  // Clipper units
+	double uMin, uMax, vMin, vMax;
+	polygonExtents(polygons, ux, uy, &uMin, &uMax, &vMin, &vMax);
+
+	vector<fieldPiece> islands;
+	long long kuFirst = (long long)floor((uMin - shift) / width), kuLast = (long long)floor((uMax - shift) / width);
+	long long kvFirst = (long long)floor((vMin - shift) / width), kvLast = (long long)floor((vMax - shift) / width);
+	islands.reserve((size_t)((kuLast - kuFirst + 1) * (kvLast - kvFirst + 1)));
+	for (long long kv = kvFirst; kv <= kvLast; kv++)
+	{
+		for (long long ku = kuFirst; ku <= kuLast; ku++)
+		{
+			double u0 = shift + ku * width, v0 = shift + kv * width;
+			double angle = (((ku + kv) % 2) == 0) ? hatchAngle : hatchAngle + 90.0;
+			islands.push_back(makePiece(ku, kv, u0, u0 + width, v0, v0 + width, ux, uy, angle));
+		}
+	}
+
+	//*** 3. Hatch the islands
+	hatchAllPieces(islands, islandsPerThread, polygons, polygonBounds, rProfile.resHatch, hatchSegStyle, jumpSegStyle);
+
+	//*** 4. Scan the islands in strided passes, so that consecutive islands are islandScanStride squares apart.
+	// Each pass takes the squares at one (row, column) offset; passes step the column offset along with the row
+	// offset, so that the squares of successive passes are not side by side either
+	vector<size_t> scanOrder;
+	for (size_t n = 0; n < islands.size(); n++)
+	{
+		if (islands[n].vSg.size() > 0) { scanOrder.push_back(n); }
+	}
+	if (scanOrder.size() == 0) { return P; }
+	auto offsetOf = [](long long k) { return ((k % islandScanStride) + islandScanStride) % islandScanStride; };
+	stable_sort(scanOrder.begin(), scanOrder.end(), [&](size_t a, size_t b) {
+		long long ovA = offsetOf(islands[a].kv), ovB = offsetOf(islands[b].kv);
+		long long passA = offsetOf(offsetOf(islands[a].ku) - ovA) * islandScanStride + ovA;
+		long long passB = offsetOf(offsetOf(islands[b].ku) - ovB) * islandScanStride + ovB;
+		return passA < passB;	// islands were created row by row, so within a pass they stay in row order
+	});
+
+	//*** 5. Join the islands with jumps
+	return joinPieces(islands, scanOrder, rProfile, jumpSegStyle);
+}
+
+path hatchStripes(layer &L, const vector<int> &regionIndex, regionProfile &rProfile, double offset, double hatchAngle, bool outputIntegerIDs)
+{
+	TIME_STAGE("hatchStripes");
+
+	path P;  // null result unless some stripe is hatched
+	P.type = "";
+
+	// Identify the segment styles, in terms of either their string or auto-generated integer ID's
+	string hatchSegStyle, jumpSegStyle;
+	if (outputIntegerIDs == true) {
+		hatchSegStyle = to_string(rProfile.hatchStyleIntID);
+		jumpSegStyle = to_string(rProfile.jumpStyleIntID);
+	}
+	else {
+		hatchSegStyle = rProfile.hatchStyleID;
+		jumpSegStyle = rProfile.jumpStyleID;
+	}
+
+	//*** 1. Offset the regions under this tag
+	ClipperLib::Paths polygons;
+	vector<ClipperLib::IntRect> polygonBounds;
+	if (!fieldPolygons(L, regionIndex, offset, polygons, polygonBounds)) { return P; }
+
+	//*** 2. Cut the field into stripes across the hatch lines.  u runs along the hatch lines, and stripe k covers
+	// u = k to k+1 stripe widths, widened by half the overlap on each side.  Stripes are no narrower than the hatch spacing
+	double width = max((rProfile.stripeWidth > 0) ? rProfile.stripeWidth : defaultStripeWidth, rProfile.resHatch) / intersectRange;  // Clipper units
+	double overlap = rProfile.stripeOverlap / intersectRange;
+	double angle_rads = hatchAngle * 3.14159265358979323846 / 180;
+	double ux = cos(angle_rads), uy = sin(angle_rads);
+	double uMin, uMax, vMin, vMax;
+	polygonExtents(polygons, ux, uy, &uMin, &uMax, &vMin, &vMax);
+
+	vector<fieldPiece> stripes;
+	long long kFirst = (long long)floor(uMin / width), kLast = (long long)floor(uMax / width);
+	stripes.reserve((size_t)(kLast - kFirst + 1));
+	for (long long k = kFirst; k <= kLast; k++)
+	{
+		stripes.push_back(makePiece(k, 0, k * width - overlap / 2, (k + 1) * width + overlap / 2, vMin - 1, vMax + 1, ux, uy, hatchAngle));
+	}
+
+	//*** 3. Hatch the stripes
+	hatchAllPieces(stripes, stripesPerThread, polygons, polygonBounds, rProfile.resHatch, hatchSegStyle, jumpSegStyle);
+
+	//*** 4. Scan the stripes in order along the hatch lines.  Each stripe zig-zags across the field from one side to the
+	// other; it is run backwards if that starts it nearer to where the previous stripe ended
+	vector<size_t> scanOrder;
+	for (size_t n = 0; n < stripes.size(); n++)
+	{
+		if (stripes[n].vSg.size() == 0) { continue; }
+		if (scanOrder.size() > 0) {
+			const vertex &last = stripes[scanOrder.back()].vSg.back().end;
+			vector<segment> &vSg = stripes[n].vSg;
+			double toStart = (vSg.front().start.x - last.x)*(vSg.front().start.x - last.x) + (vSg.front().start.y - last.y)*(vSg.front().start.y - last.y);
+			double toEnd = (vSg.back().end.x - last.x)*(vSg.back().end.x - last.x) + (vSg.back().end.y - last.y)*(vSg.back().end.y - last.y);
+			if (toEnd < toStart) {
+				reverse(vSg.begin(), vSg.end());
+				for (vector<segment>::iterator sg = vSg.begin(); sg != vSg.end(); ++sg) { swap(sg->start, sg->end); }
+			}
+		}
+		scanOrder.push_back(n);
+	}
+	if (scanOrder.size() == 0) { return P; }
+
+	//*** 5. Join the stripes with jumps
+	return joinPieces(stripes, scanOrder, rProfile, jumpSegStyle);
+}
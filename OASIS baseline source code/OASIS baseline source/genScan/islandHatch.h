@@ -0,0 +1,58 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+islandHatch.h defines the hatch schemes which cut the hatch field
+into pieces and hatch each piece on its own: scheme 4, island
+(chessboard) hatching, and scheme 5, stripe hatching.
+
+Island hatching tiles the offset regions of a region group with
+square islands of the region profile's islandSize, the grid turned
+by islandRotation and moved along both of its axes by islandShift
+on each layer, so island borders do not stack up through the part.
+Islands alternate between the layer's hatch angle and that angle
+plus 90 degrees, like the squares of a chessboard.  They are
+scanned in a strided order, every islandScanStride'th island of
+every islandScanStride'th row in each pass, so consecutive islands
+are never neighbours and the heat of one has spread before the
+next island beside it is scanned.
+
+Stripe hatching cuts the field into stripes of stripeWidth across
+the hatch lines, so no mark is longer than the stripe (plus
+stripeOverlap, by which neighbouring stripes overlap).  The stripes
+are scanned in order along the hatch lines, each zig-zagging across
+the field, and each starting at the side where the last one ended.
+
+Each piece is the intersection of its outline with the offset
+regions, found with Clipper.  Hatch lines sit on a grid common to
+the whole layer, so pieces of the same angle line up.  Pieces are
+independent until they are joined, so they are hatched on a pool
+of worker threads; a single large layer then uses every core.  The
+output does not depend on the number of threads
+//============================================================*/
+
+#pragma once
+
+#include <vector>
+
+#include "ScanPath.h"
+
+using namespace std;
+
+// hatches the offset regions (see hatch) as square islands.  layerNum sets the grid's shift; the other arguments
+// are those of hatch
+path hatchIslands(layer &L, const vector<int> &regionIndex, regionProfile &rProfile, double offset, double hatchAngle, int layerNum, bool outputIntegerIDs);
+
+// hatches the offset regions (see hatch) in stripes across the hatch lines.  The arguments are those of hatch
+path hatchStripes(layer &L, const vector<int> &regionIndex, regionProfile &rProfile, double offset, double hatchAngle, bool outputIntegerIDs);
@@ -0,0 +1,137 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+laserSchedule.cpp implements the longest-first assignment of the
+paths of concurrent trajectories to lasers, described in
+laserSchedule.h
+//============================================================*/
+
+#include "laserSchedule.h"
+
+#include <algorithm>
+
+laserScheduler::laserScheduler(AMconfig &configData)
+{
+	lasers = configData.laserList;
+	for (size_t l = 0; l < lasers.size(); l++) { laserIndex[lasers[l].laserID] = (int)l; }
+	if (lasers.empty()) { return; }
+
+	// only Independent styles name a single laser that can be swapped; FollowMe styles tie a pair of lasers together
+	size_t numStyles = configData.segmentStyleList.size();
+	for (size_t s = 0; s < numStyles; s++)
+	{
+		segmentStyle ss = configData.segmentStyleList[s];	// a copy, since the list grows below
+		if ((ss.laserMode != "Independent") || (ss.leadLaser.travelerID == "")) { continue; }
+		string styleKey = configData.outputIntegerIDs ? to_string(ss.integerID) : ss.ID;
+		vector<string> &versions = laserStyles[styleKey];
+		for (size_t l = 0; l < lasers.size(); l++)
+		{
+			if (lasers[l].laserID == ss.leadLaser.travelerID)
+			{	// the style already uses this laser
+				versions.push_back(styleKey);
+				continue;
+			}
+			segmentStyle copy = ss;
+			copy.integerID = configData.segmentStyleList.size() + 1;  // auto-populate a unique integerID for LabView
+			copy.ID = ss.ID + "_" + lasers[l].laserID;
+			copy.leadLaser.travelerID = lasers[l].laserID;
+			configData.segmentStyleList.push_back(copy);
+			versions.push_back(configData.outputIntegerIDs ? to_string(copy.integerID) : copy.ID);
+		}
+		// each version leads to the others, so a path already given a laser can be moved again
+		vector<string> allVersions = versions;
+		for (size_t l = 0; l < allVersions.size(); l++) { laserStyles[allVersions[l]] = allVersions; }
+	}
+}
+
+// a path waiting for a laser, with its estimated time and the box holding all of its moves
+struct scheduledPath
+{
+	size_t index;
+	double time;
+	double minX, maxX, minY, maxY;
+};
+
+bool laserScheduler::assignLasers(vector<trajectory> &trajectoryList, const scanTimeEstimator &timer, string *unreachable) const
+{
+	vector<double> load(lasers.size());
+	vector<scheduledPath> pending;
+	for (vector<trajectory>::iterator tr = trajectoryList.begin(); tr != trajectoryList.end(); ++tr)
+	{
+		if (tr->pathProcessingMode != "concurrent") { continue; }
+		fill(load.begin(), load.end(), 0.0);
+		pending.clear();
+
+		for (size_t p = 0; p < tr->vecPath.size(); p++)
+		{
+			const path &P = tr->vecPath[p];
+			if (P.vecSg.empty()) { continue; }
+			double time = timer.pathTime(P).total();
+
+			// a path can move only if every mark has a version of its style for each laser
+			bool movable = false, pinned = false;
+			for (vector<segment>::const_iterator sg = P.vecSg.begin(); sg != P.vecSg.end(); ++sg)
+			{
+				if (sg->isMark == 0) { continue; }
+				if (laserStyles.find(sg->idSegStyl) == laserStyles.end()) { pinned = true; break; }
+				movable = true;
+			}
+			if (pinned || !movable)
+			{	// stays where its styles put it, but that laser is busy meanwhile
+				unordered_map<string, int>::const_iterator it = laserIndex.find(timer.pathLaser(P));
+				if (it != laserIndex.end()) { load[it->second] += time; }
+				continue;
+			}
+
+			scheduledPath sp;
+			sp.index = p;
+			sp.time = time;
+			sp.minX = sp.maxX = P.vecSg[0].start.x;
+			sp.minY = sp.maxY = P.vecSg[0].start.y;
+			for (vector<segment>::const_iterator sg = P.vecSg.begin(); sg != P.vecSg.end(); ++sg)
+			{
+				sp.minX = min(sp.minX, sg->end.x);
+				sp.maxX = max(sp.maxX, sg->end.x);
+				sp.minY = min(sp.minY, sg->end.y);
+				sp.maxY = max(sp.maxY, sg->end.y);
+			}
+			pending.push_back(sp);
+		}
+
+		// longest first, in build order among equals, so the schedule is repeatable
+		stable_sort(pending.begin(), pending.end(), [](const scheduledPath &a, const scheduledPath &b) { return a.time > b.time; });
+		for (vector<scheduledPath>::const_iterator sp = pending.begin(); sp != pending.end(); ++sp)
+		{
+			int best = -1;
+			for (size_t l = 0; l < lasers.size(); l++)
+			{
+				if (!lasers[l].reaches(sp->minX, sp->maxX, sp->minY, sp->maxY)) { continue; }
+				if ((best < 0) || (load[l] < load[best])) { best = (int)l; }
+			}
+			path &P = tr->vecPath[sp->index];
+			if (best < 0)
+			{
+				*unreachable = "No laser on tab 9 can reach all of the " + P.type + " path for region " + P.tag + " in trajectory " + to_string(tr->trajectoryNum) + "\n";
+				return false;
+			}
+			load[best] += sp->time;
+			for (vector<segment>::iterator sg = P.vecSg.begin(); sg != P.vecSg.end(); ++sg)
+			{
+				if (sg->isMark != 0) { sg->idSegStyl = laserStyles.find(sg->idSegStyl)->second[best]; }
+			}
+		}
+	}
+	return true;
+}
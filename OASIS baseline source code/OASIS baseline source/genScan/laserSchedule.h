@@ -0,0 +1,58 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+laserSchedule.h divides the paths of concurrent trajectories among
+the lasers listed on the optional lasers tab of the config file.
+
+Each path's time comes from the scan time estimate.  Paths are taken
+longest first and given to the least-loaded laser whose reachable
+field holds the whole path, which keeps the busiest laser (and so the
+layer) short.  A path is moved to its laser by switching its marks to
+that laser's copy of their SegmentStyle; the copies are added to the
+style list once per build.  Paths using a FollowMe style stay on the
+lasers that style names, but still count toward those lasers' loads
+//============================================================*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "ScanPath.h"
+#include "scanTime.h"
+#include "readExcelConfig.h"
+
+using namespace std;
+
+class laserScheduler
+{
+public:
+	// adds a copy of each single-laser SegmentStyle for every other laser on the lasers tab.
+	// Must be created before anything indexes the style list, such as scanTimeEstimator
+	explicit laserScheduler(AMconfig &configData);
+
+	// true if the config file lists lasers to schedule
+	bool active() const { return !lasers.empty(); }
+
+	// assigns each path of the layer's concurrent trajectories to a laser.  Returns false, with a
+	// description in *unreachable, if a path lies outside the field of every laser it could use
+	bool assignLasers(vector<trajectory> &trajectoryList, const scanTimeEstimator &timer, string *unreachable) const;
+
+private:
+	vector<laserField> lasers;
+	unordered_map<string, int> laserIndex;	// traveler ID to lasers
+	unordered_map<string, vector<string>> laserStyles;	// SegmentStyle ID, as written to segments, to the ID of its version for each laser
+};
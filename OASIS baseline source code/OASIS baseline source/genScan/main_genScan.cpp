@@ -29,9 +29,9 @@ from the configuration files.
 
 #include <fstream>
 #include <iostream>
-#include <filesystem>
-#include <msxml6.h>
-#include <conio.h>
+#include <iomanip>
+#include <map>
+#include "xmlDOM.h"
 #include "writeScanXML.h"
 #include "ScanPath.h"
 
@@ -40,6 +40,14 @@ from the configuration files.
 #include "BasicExcel.hpp"
 #include "errorChecks.h"
 #include "io_functions.h"
+#include "runReport.h"
+#include "traceEvents.h"
+#include "memoryBudget.h"
+#include "shardManifest.h"
+#include "scanTime.h"
+#include "laserSchedule.h"
+#include "pathOrder.h"
+#include "islandHatch.h"
 
 
 using namespace std;
@@ -63,44 +71,37 @@ bool compareTrajNums(const trajectory &a, const trajectory &b)
 // function to clear the large variables re-used in each layer iteration
 void clearVars(layer* L, trajectory* T, path* tempPath)
 {
+	// the lists keep their capacity for the next layer
 	(*L).vList.clear();
 	(*L).s.rList.clear();
-	//
-	(*L).vList.shrink_to_fit();
-	(*L).s.rList.shrink_to_fit();
 
-	(*T).trajRegionIsHatched.clear();
+	(*T).regionGroups.clear();
 	(*T).trajRegionLinks.clear();
 	(*T).trajRegions.clear();
 	(*T).trajRegionTags.clear();
 	(*T).trajRegionTypes.clear();
 	(*T).vecPath.clear();
-	//
-	(*T).trajRegionIsHatched.shrink_to_fit();
-	(*T).trajRegionLinks.shrink_to_fit();
-	(*T).trajRegions.shrink_to_fit();
-	(*T).trajRegionTags.shrink_to_fit();
-	(*T).trajRegionTypes.shrink_to_fit();
-	(*T).vecPath.shrink_to_fit();
 
 	(*tempPath).vecSg.clear();
-	//
-	(*tempPath).vecSg.shrink_to_fit();
+
+	// short-lived working lists of the previous layer (hatch intersections etc.) are discarded in one step
+	layerArena().reset();
 }
 
 
 int main(int argc, char **argv)
 // Required argument for genScan.exe:
 // <filename>.xls = full path to configuration file (surrounded by "").  If not specified, error will be reported
+// Optional argument:
+// --batch = never wait for a keypress (used on headless batch nodes)
+// --shard <id> --layers <first>-<last> = process only this range of layers and record them in the shard's manifest
 {
 	// To enhance memory management, this program is called from an external script. Every time this program is called, 
 	// it reads the last layer number generated from a *cfg file, generates a specific number of layers, and write the 
 	// final layer number in the *cfg file for next time (or write if it is finished).
 
 	// Determine where we are (current path)
-	TCHAR filePath[MAX_PATH + 1] = "";
-	GetCurrentDirectory(MAX_PATH, filePath);
-	string currentPath = &filePath[0];
+	string currentPath = currentDirectory();
 
 	double a_min = 0.0;
 	double a_max = 0.0;
@@ -112,30 +113,46 @@ int main(int argc, char **argv)
 	double fullHatchOffset;
 	// Define variables re-used in each layer iteration
 	layer L;
+	hatchBoundaryCache hatchBoundaries;	// hatch-line intercepts of the layer's regions at each hatch angle
 	trajectory T;
 	path tempPath;
 
 	// Begin by parsing the command-line arguments, if any.
 	// argc indicates the number of command-line arguments entered by the user
 	string configFilename = "";
+	shardRange shard;
 	if (argc > 1)
 	{
 		configFilename = argv[1];
+		for (int a = 2; a < argc; a++) {
+			if (string(argv[a]) == "--batch") { setInteractive(false); }
+			else if ((string(argv[a]) == "--shard") && (a + 1 < argc)) { shard.shardId = argv[++a]; }
+			else if ((string(argv[a]) == "--layers") && (a + 1 < argc)) {
+				if (!parseLayerRange(argv[++a], shard.firstLayer, shard.lastLayer)) {
+					cout << "Invalid layer range " << argv[a] << "; expected <first>-<last>" << endl;
+					pauseForUser();
+					return -1;
+				}
+			}
+		}
 	}
 	else
 	{
 		// no config file specified... most likely the user tried to run genLayer or genScan directly
 		string errMsg = "Please use createScanpaths.exe to handle layer and scan generation. genScan.exe and genLayer.exe are helper functions only\n";
-		system("pause");
+		pauseForUser();
 		return -1;
 	}
 
 	configData = AMconfigRead(configFilename);  // if file can't be read or is invalid, AMconfigRead will halt execution
 	configData.executableFolder = currentPath;  // assume we begin in the executable folder, slic3r folder is located
+#if TRACEEVENTS
+	openTraceFile(configData.projectFolder + pathSep + shardFilename(traceFilename, shard.shardId), "genScan");
+#endif
 
 	// Determine which layers to process in this function call
 	// First, get total layers to process from the Excel configuration file
-	string xmlFolder = configData.layerOutputFolder + "\\XMLdir\\";
+	string xmlFolder = configData.layerOutputFolder + pathSep + "XMLdir" + pathSep;
 	fileCount layerFileInfo = countLayerFiles(xmlFolder);	// provides number of XML files and min/max layer numbers
 	
 	// If there are no layer files in the folder, report an error and quit
@@ -149,7 +166,8 @@ int main(int argc, char **argv)
 	//
 	// Next, read the temporary config file to see which layers have already been done
 	int finished = 0; // flag to write if slicing of the part is complete.  Set to zero by default
-	sts cst = readStatus("gs_sts.cfg"); // read the ending layer number of the last iteration (or check if it is the first layer)
+	string statusFilename = shardFilename("gs_sts.cfg", shard.shardId);	// each shard keeps its own status file
+	sts cst = readStatus(statusFilename); // read the ending layer number of the last iteration (or check if it is the first layer)
 	int started = cst.started; // flag to check if slicing of the part has already started
 	//
 	// determine the starting layer
@@ -162,6 +180,23 @@ int main(int argc, char **argv)
 	{
 		sLayer = layerFileInfo.minLayer;
 	}
+	if (sLayer < shard.firstLayer)	// a shard begins at the start of its own range
+	{
+		sLayer = shard.firstLayer;
+	}
+	// the last layer this instance (or shard) will produce, across all calls
+	int lastLayer = min(configData.endingScanLayer, min(layerFileInfo.maxLayer, shard.lastLayer));
+	string manifestFile = manifestPath(configData.scanOutputFolder, "scan", shard.shardId);
+	if ((shard.shardId != "") && (sLayer > lastLayer) && (layerFileInfo.numFiles > 0))
+	{
+		// this shard's range lies entirely beyond the layers being scanned, so there is nothing to do
+		startManifest(manifestFile, shard.shardId, sLayer, sLayer - 1, layerFileInfo.maxLayer);
+		finishManifest(manifestFile);
+		stfile.open(statusFilename);
+		stfile << 1 << endl << sLayer - 1 << endl << 1 << endl << configData.scanOutputFolder << endl << cst.layerCostMB << endl;
+		stfile.close();
+		return 0;
+	}
 	if (sLayer > layerFileInfo.maxLayer)	// check if user-selected start layer# is greater than actual last layer file
 	{
 		// If the desired starting layer# is above the actual highest layer#, report an error and quit
@@ -176,7 +211,7 @@ int main(int argc, char **argv)
 	}
 	
 	// determine the final layer (fLayer) to be processed by this instance of genScan
-	int fLayer = sLayer + numLayersPerCall;	// final layer number for a particular call to this function
+	int fLayer = sLayer + maxLayersPerCall - 1;	// final layer number for a particular call to this function, unless the memory budget ends the batch sooner
 	if (fLayer >= configData.endingScanLayer)
 	{	// user wants to end below the highest layer
 		fLayer = configData.endingScanLayer;
@@ -187,16 +222,24 @@ int main(int argc, char **argv)
 		fLayer = layerFileInfo.maxLayer;
 		finished = 1;
 	}
-	int numLayer = layerFileInfo.numFiles;
+	if (fLayer >= shard.lastLayer)
+	{	// this shard's range ends here
+		fLayer = shard.lastLayer;
+		finished = 1;
+	}
+	if ((shard.shardId != "") && (started == 0))
+	{	// first call for this shard: begin its manifest
+		startManifest(manifestFile, shard.shardId, sLayer, lastLayer, layerFileInfo.maxLayer);
+	}
+	int numDigits = layerFileInfo.numDigits;	// layer numbers in the filenames are zero-padded to this width
+	memoryBudget layerMemory(cst.layerCostMB);	// tracks the working set per layer to size this batch
 
 	int close = 0;
 	string cmd;
 	double currentContourOffset = 0.0; // used to compute offset from part + inter-contour spacing for individual contours
 
-	//get viewer parameters
-	string vmd = "copy \"" + configData.layerOutputFolder + "\\vConfig.txt\"> NUL";
-	system(vmd.c_str());
-	ifstream vfile("vConfig.txt");
+	//get viewer parameters, written by genLayer into the layer folder
+	ifstream vfile(configData.layerOutputFolder + pathSep + "vConfig.txt");
 	char c;
 	double mag, xo, yo;
 	string line;
@@ -209,30 +252,40 @@ int main(int argc, char **argv)
 	for (int r = 0; r < configData.regionProfileList.size(); r++)
 	{	tagList.push_back(configData.regionProfileList[r].Tag);	}
 
-	// set up variables for cursor control
-	COORD cursorPosition;
-	HANDLE hStdout;
-	hStdout = GetStdHandle(STD_OUTPUT_HANDLE);
-	// Identify current cursor position
-	cursorPosition = GetConsoleCursorPosition(hStdout);
+	// set up progress display (rewritten in place on a console, one line per layer otherwise)
+	consoleProgress progress;
+
+	// add each laser's versions of the segment styles, if the config file lists lasers for concurrent trajectories
+	laserScheduler lasers(configData);
+
+	// set up the scan time estimate.  The first call starts a new CSV file; later calls continue its running total
+	scanTimeEstimator scanTimer(configData);
+	string scanTimeFile = configData.scanOutputFolder + pathSep + shardFilename(scanTimeFilename, shard.shardId);
+	bool newScanTimeFile = (started == 0);
+	int firstTimedLayer = sLayer, lastTimedLayer = 0;
+	scanTimeEstimate buildTime;
+	if (!newScanTimeFile) { buildTime = readScanTimeTotal(scanTimeFile, &firstTimedLayer, &lastTimedLayer); }
+	if (lastTimedLayer == 0) { firstTimedLayer = sLayer; }
 
 	//********************************************
 	// PROCESS SOME LAYERS
 	for (int i = sLayer; i <= fLayer; i++)
 	{
-		cout << "Processing layer " << i << " of " << layerFileInfo.maxLayer << endl;
-		// reset cursor position
-		SetConsoleCursorPosition(hStdout, cursorPosition);
+		TIME_STAGE("layer");
+		TRACE_SCOPE("layer", "genScan", i);
+		layerMemory.beginLayer();
+		progress.update("Processing layer " + to_string(i) + " of " + to_string(layerFileInfo.maxLayer));
 
 		clearVars(&L, &T, &tempPath);
+		hatchBoundaries.clear();
 		//generate the output filename by pre-pending appropriate numbers of zeroes
 		string zs;
-		for (int k = 0; k <(int)(to_string(numLayer)).size() - (int)(to_string(i)).size(); k++)
+		for (int k = 0; k < numDigits - (int)(to_string(i)).size(); k++)
 		{
 			zs = zs + "0";
 		};
 		string lfn = "layer_" + zs + to_string(i) + ".xml";
-		string fullLayerPath = configData.layerOutputFolder + "\\XMLdir\\" + lfn;
+		string fullLayerPath = configData.layerOutputFolder + pathSep + "XMLdir" + pathSep + lfn;
 		string svfn = "scan_" + zs + to_string(i) + ".svg";
 		string xfn = "scan_" + zs + to_string(i) + ".xml";
 
@@ -283,138 +336,129 @@ int main(int argc, char **argv)
 
 				// Iterate across the list of trajectories in trajList and generate scan paths for their regions
 				int numTrajectories = trajIndex.size();
+				vertex lastPosition;	// where the previous trajectory's paths end, to start ordering the next one from
+				bool hasLastPosition = false;
 				for (int tNum = 0; tNum != numTrajectories; ++tNum)
 				{	
-					// Iterate across the regions in trajectoryList[tNum].trajRegions.
-					// First check if the region's isHatched == TRUE.  If so, ignore this region.
-					// Otherwise, compare the region's tag against all other regions in this trajectory (of same hatch/contour type) to 
-					// generate a list of regions to be grouped under a single path.  Pass this list of region numbers to
-					// the hatching or contouring function and also mark these regions isHatched = TRUE.
+					TRACE_SCOPE("trajectory", "genScan", i, trajectoryList[tNum].trajectoryNum);
+					// Iterate across the groups of regions in trajectoryList[tNum].regionGroups.  identifyTrajectories groups the regions
+					// of a trajectory by type (contour or hatch) and tag; each group is passed to the hatching or contouring function.
 					int numRegions = trajectoryList[tNum].trajRegions.size();  // Number of regions within this trajectory
 					#if printTraj
 						cout << "Processing trajectory " << trajectoryList[tNum].trajectoryNum << " in position " << tNum << endl;
-						cout << "	This trajectory contains " << numRegions << " regions" << endl;
+						cout << "	This trajectory contains " << numRegions << " regions in " << trajectoryList[tNum].regionGroups.size() << " groups" << endl;
 					#endif
-					int regionIndex, rProfileNum;
-					string regionType, regionTag;
-					vector<string>::iterator temp3;
+					string regionTag;
 					regionProfile* rProfile;
-					vector<int> regionsWithinPath;  // list of regions to be hatched or contoured together (same trajectory, tag and type)
+					vector<size_t> groupStarts;		// position in vecPath of the first path of each group of regions, for path ordering
+					vector<int> groupAfter;			// for a hatch group, the group of the same tag's contours, which path ordering keeps ahead of it
+					map<string, int> contourGroupOf;
 
-					for (int rNum = 0; rNum != numRegions; ++rNum)
+					for (size_t gNum = 0; gNum != trajectoryList[tNum].regionGroups.size(); ++gNum)
 					{
+						const regionGroup &group = trajectoryList[tNum].regionGroups[gNum];
+						if (group.profile < 0) { continue; }	// verifyLayerStructure has already reported a tag with no region profile
+						const vector<int> &regionsWithinPath = group.regions;  // list of regions to be hatched or contoured together (same trajectory, tag and type)
+						auto contourGroup = contourGroupOf.find(group.tag);
+						groupAfter.push_back(((group.type == regionType::hatch) && (contourGroup != contourGroupOf.end())) ? contourGroup->second : -1);
+						if (group.type == regionType::contour) { contourGroupOf[group.tag] = (int)groupStarts.size(); }
+						groupStarts.push_back(trajectoryList[tNum].vecPath.size());
+						regionTag = group.tag;
+						rProfile = &(configData.regionProfileList[group.profile]); // Create shortcut to the region profile of regionTag
 						#if printTraj
-							cout << "	  Evaluating region number " << rNum << endl;
+							cout << "		Creating scanpath for trajectory " << trajectoryList[tNum].trajectoryNum << " > region tag " << regionTag << " > type " << regionTypeName(group.type) << ", " << regionsWithinPath.size() << " regions" << endl;
 						#endif
-						if (trajectoryList[tNum].trajRegionIsHatched[rNum] == false)
-						{
+
+						// If this group is a hatch rather than contour, compute the hatch angle
+						if (group.type == regionType::hatch) {
+							// compute hatch angle for this region as (starting angle + (#layers-1)*inter-later rotation angle )... all mod 360 degrees
+							// the double use of fmod(x, 360) converts negative hatch angles to the positive equivalent
+							hatchAngle = fmod(fmod((*rProfile).layer1hatchAngle + (i - 1)*((*rProfile).hatchLayerRotation), 360.0)+360.0, 360.0); // degrees
+						}
+
+						// Now that we know which regions to process, send those regions to the appropriate generator
+						//
+						// IF THIS IS A CONTOUR:
+						if ((group.type == regionType::contour) & ((*rProfile).contourStyleID != "") & ((*rProfile).numCntr > 0))
+						{	// Do contouring.
+							// Loop over the indicated number of contours, create a contour and increment the contour offset
+							TRACE_SCOPE("contour", "genScan", i, trajectoryList[tNum].trajectoryNum, regionTag);
 							#if printTraj
-								cout << "		This region has not yet been scanpathed... proceeding" << endl;
+								cout << "		  Creating contour scanpaths" << endl;
 							#endif
-							regionsWithinPath.clear();
-							//regionsWithinPath.push_back(rNum);
-							regionsWithinPath.push_back(trajectoryList[tNum].trajRegions[rNum]);  //push back the region# in trajectoryList[tNum_position].trajRegions[rNum]
-							trajectoryList[tNum].trajRegionIsHatched[rNum] = true;
-							regionType = trajectoryList[tNum].trajRegionTypes[rNum];
-							regionTag = trajectoryList[tNum].trajRegionTags[rNum];
-							// determine the regionProfile which corresponds to regionTag
-							temp3 = find(tagList.begin(), tagList.end(), regionTag);
-							rProfileNum = distance(tagList.begin(), temp3);
-							rProfile = &(configData.regionProfileList[rProfileNum]); // Create shortcut to the indicated region profile
-							#if printTraj							
-								cout << "		Creating scanpath for trajectory " << trajectoryList[tNum].trajectoryNum << " > region tag " << regionTag << " > type " << regionType << ", regionNum " << rNum << endl;
-							#endif
-
-							// If this region is a hatch rather than contour, compute the hatch angle and min/max hatch boundaries based on this angle
-							if (regionType != "contour") {
-								// compute hatch angle for this region as (starting angle + (#layers-1)*inter-later rotation angle )... all mod 360 degrees
-								// the double use of fmod(x, 360) converts negative hatch angles to the positive equivalent
-								hatchAngle = fmod(fmod((*rProfile).layer1hatchAngle + (i - 1)*((*rProfile).hatchLayerRotation), 360.0)+360.0, 360.0); // degrees
-								// Determine the min/max coordinates of the current layer along the primary hatching axis for this region
-								// Must repeat this for each region because hatch angles may differ, leading to alternate min/max hatch points
-								if (L.vList.size() > 0) {
-									findHatchBoundary(L.vList, hatchAngle, &a_min, &a_max);
-								}
-							}
-
-							// Iterate across all remaining regions to aggregate other regions with the same tag
-							for (int rNum2 = rNum+1; rNum2 < numRegions; ++rNum2)
+							for (int n = 0; n < (*rProfile).numCntr; n++)
 							{
-								#if printTraj
-									cout << "			Comparing type and tag for region number " << rNum2 << endl;
-								#endif
-								if ((regionType == trajectoryList[tNum].trajRegionTypes[rNum2]) &
-									(regionTag == trajectoryList[tNum].trajRegionTags[rNum2]))
-								{
-									regionsWithinPath.push_back(trajectoryList[tNum].trajRegions[rNum2]);
-									trajectoryList[tNum].trajRegionIsHatched[rNum2] = true;
-									#if printTraj
-										cout << "				Adding region tag " << regionTag << " > type " << regionType << ", regionNum " << rNum2 << endl;
-									#endif
-								} //end if regionType
-							} // end for rNum2
-
-							// Now that we know which regions to process, send those regions to the appropriate generator
-							//
-							// IF THIS IS A CONTOUR:
-							if ((regionType == "contour") & ((*rProfile).contourStyleID != "") & ((*rProfile).numCntr > 0))
-							{	// Do contouring.
-								// Loop over the indicated number of contours, create a contour and increment the contour offset
-								#if printTraj
-									cout << "		  Creating contour scanpaths" << endl;
-								#endif
-								for (int n = 0; n < (*rProfile).numCntr; n++)
-								{
-									currentContourOffset = (n*(*rProfile).resCntr + (*rProfile).offCntr); // offset = n*inter-contour spacing plus offset from part
-									tempPath = contour(L, regionsWithinPath, (*rProfile), currentContourOffset, BB, configData.outputIntegerIDs);
-									if ((tempPath.vecSg).size() > 0) {
-										(trajectoryList[tNum].vecPath).push_back(tempPath);
-									}
-								}
-							} // end contouring
-
-							//
-							// IF THIS IS A HATCH:
-							if ((regionType == "hatch") & ((*rProfile).hatchStyleID != "") & ((*rProfile).resHatch > 0))
-							{	
-								#if printTraj
-									cout << "			Creating hatch scanpaths for hatch angle " << hatchAngle << endl;
-									cout << "			  a_min = " << a_min << ", a_max = " << a_max << endl;
-								#endif
-								// Do hatching for all regions with this tag
-								// First compute the actual hatch offset relative to contours, if contouring is enabled for the region
-								if (((*rProfile).contourStyleID != "") & ((*rProfile).numCntr > 0))
-								{	// Contours are enabled in this region.  Add full contour offset to hatch offset
-									fullHatchOffset = (*rProfile).offHatch + (*rProfile).offCntr + (max(0, (*rProfile).numCntr - 1)*(*rProfile).resCntr);
-								}
-								else {
-									// Contours are not enabled in this region.  Only hatch offset matters
-									fullHatchOffset = (*rProfile).offHatch;
-								}
-								// Create the hatches via either basic or optimized hatch algorithm.
-								// Basic algo overlays parallel lines over all parts at once, and draws hatch lines through all parts
-								// Optimized algorithm attempts to minimize jumps by hatching in smaller pieces, focusing on regional clusters
-								if ((*rProfile).scHatch == 1) {
-									tempPath = hatchOPT(L, regionsWithinPath, (*rProfile), fullHatchOffset, hatchAngle, a_min, a_max, configData.outputIntegerIDs, BB);
-								}
-								else
-								{
-									tempPath = hatch   (L, regionsWithinPath, (*rProfile), fullHatchOffset, hatchAngle, a_min, a_max, configData.outputIntegerIDs, BB);
-								}
+								currentContourOffset = (n*(*rProfile).resCntr + (*rProfile).offCntr); // offset = n*inter-contour spacing plus offset from part
+								tempPath = contour(L, regionsWithinPath, (*rProfile), currentContourOffset, BB, configData.outputIntegerIDs);
 								if ((tempPath.vecSg).size() > 0) {
-									(trajectoryList[tNum].vecPath).push_back(tempPath);
+									(trajectoryList[tNum].vecPath).push_back(move(tempPath));
 								}
-							}  // end hatching
+							}
+						} // end contouring
 
+						//
+						// IF THIS IS A HATCH:
+						if ((group.type == regionType::hatch) & ((*rProfile).hatchStyleID != "") & ((*rProfile).resHatch > 0))
+						{	
+							TRACE_SCOPE((((*rProfile).scHatch == 1) || ((*rProfile).scHatch == 3)) ? "hatchOPT" : (((*rProfile).scHatch == 2) ? "hatchClip" : (((*rProfile).scHatch == 4) ? "hatchIslands" : (((*rProfile).scHatch == 5) ? "hatchStripes" : "hatch"))), "genScan", i, trajectoryList[tNum].trajectoryNum, regionTag);
+							#if printTraj
+								cout << "			Creating hatch scanpaths for hatch angle " << hatchAngle << endl;
+							#endif
+							// Do hatching for all regions with this tag
+							// First compute the actual hatch offset relative to contours, if contouring is enabled for the region
+							if (((*rProfile).contourStyleID != "") & ((*rProfile).numCntr > 0))
+							{	// Contours are enabled in this region.  Add full contour offset to hatch offset
+								fullHatchOffset = (*rProfile).offHatch + (*rProfile).offCntr + (max(0, (*rProfile).numCntr - 1)*(*rProfile).resCntr);
+							}
+							else {
+								// Contours are not enabled in this region.  Only hatch offset matters
+								fullHatchOffset = (*rProfile).offHatch;
+							}
+							// Determine the min/max intercepts of hatch lines through the vertices of these regions.  Hatch angles may differ
+							// between groups, so the projections are kept per hatch angle and reused by later groups of this layer
+							hatchBoundaries.hatchBoundary(L, regionsWithinPath, hatchAngle, (*rProfile).resHatch, fullHatchOffset, &a_min, &a_max);
 							#if printTraj
-								cout << "		End if (trajectoryList[tNum].trajRegionIsHatched[rNum] == false)" << endl;
+								cout << "			  a_min = " << a_min << ", a_max = " << a_max << endl;
 							#endif
-						} // if trajRegionIsHatched
+							// Create the hatches via either basic or optimized hatch algorithm.
+							// Basic algo overlays parallel lines over all parts at once, and draws hatch lines through all parts
+							// Optimized algorithm attempts to minimize jumps by hatching in smaller pieces, focusing on regional clusters
+							// Clipper algorithm draws the same lines as basic hatching, but clips them against the parts with Clipper
+							// Island algorithm tiles the parts with small squares and hatches each one separately, in parallel
+							// Stripe algorithm cuts the hatch lines into stripes of limited length, hatched in parallel
+							if (((*rProfile).scHatch == 1) || ((*rProfile).scHatch == 3)) {
+								// scheme 3 refines the order and direction of the optimized algorithm's hatch islands
+								tempPath = hatchOPT(L, regionsWithinPath, (*rProfile), fullHatchOffset, hatchAngle, a_min, a_max, configData.outputIntegerIDs, BB, (*rProfile).scHatch == 3);
+							}
+							else if ((*rProfile).scHatch == 2) {
+								tempPath = hatchClip(L, regionsWithinPath, (*rProfile), fullHatchOffset, hatchAngle, a_min, a_max, configData.outputIntegerIDs, BB);
+							}
+							else if ((*rProfile).scHatch == 4) {
+								tempPath = hatchIslands(L, regionsWithinPath, (*rProfile), fullHatchOffset, hatchAngle, i, configData.outputIntegerIDs);
+							}
+							else if ((*rProfile).scHatch == 5) {
+								tempPath = hatchStripes(L, regionsWithinPath, (*rProfile), fullHatchOffset, hatchAngle, configData.outputIntegerIDs);
+							}
+							else
+							{
+								tempPath = hatch   (L, regionsWithinPath, (*rProfile), fullHatchOffset, hatchAngle, a_min, a_max, configData.outputIntegerIDs, BB);
+							}
+							if ((tempPath.vecSg).size() > 0) {
+								(trajectoryList[tNum].vecPath).push_back(move(tempPath));
+							}
+						}  // end hatching
 
-						#if printTraj
-							cout << "		End for (int rNum = 0; rNum != numRegions; ++rNum)" << endl;
-						#endif
-					} // for rNum
+					} // for gNum
+
+					// visit the region groups in the order which shortens the jumps between them
+					{
+						TRACE_SCOPE("pathOrder", "genScan", i, trajectoryList[tNum].trajectoryNum);
+						orderPathGroups(trajectoryList[tNum].vecPath, groupStarts, groupAfter, lastPosition, hasLastPosition);
+					}
+					if (trajectoryList[tNum].vecPath.size() > 0) {
+						lastPosition = trajectoryList[tNum].vecPath.back().vecSg.back().end;
+						hasLastPosition = true;
+					}
 
 					#if printTraj
 						cout << "		End for (int temp1 = 0; temp1 != numTrajectories; ++temp1)" << endl;
@@ -424,14 +468,65 @@ int main(int argc, char **argv)
 				#if printTraj
 				cout << "Trajectory loop completed; preparing to write XML and SVG files" << endl;
 				#endif
+				// share the paths of concurrent trajectories among the lasers
+				if (lasers.active())
+				{
+					TRACE_SCOPE("laserSchedule", "genScan", i);
+					if (!lasers.assignLasers(trajectoryList, scanTimer, &errorMsg)) {
+						updateErrorResults(errorData, true, "genScan", errorMsg, "", configData.configFilename, configData.configPath);
+					}
+				}
+#if STAGETIMING
+				// record the size of this layer and of its scanpaths for the run report
+				size_t numEdges = 0, numPaths = 0, numSegments = 0;
+				for (size_t r = 0; r < L.s.rList.size(); r++) { numEdges += L.s.rList[r].eList.size(); }
+				for (size_t t = 0; t < trajectoryList.size(); t++)
+				{
+					numPaths += trajectoryList[t].vecPath.size();
+					for (size_t p = 0; p < trajectoryList[t].vecPath.size(); p++) { numSegments += trajectoryList[t].vecPath[p].vecSg.size(); }
+				}
+				COUNT_LAYER(i, "vertices", L.vList.size());
+				COUNT_LAYER(i, "edges", numEdges);
+				COUNT_LAYER(i, "regions", L.s.rList.size());
+				COUNT_LAYER(i, "hatch_groups", hatchBoundaries.hatchGroups());
+				COUNT_LAYER(i, "hatch_angles", hatchBoundaries.hatchAngles());
+				COUNT_LAYER(i, "paths", numPaths);
+				COUNT_LAYER(i, "segments", numSegments);
+				pathOrderTotals jumps = takePathOrderTotals();	// jumps between contour rings and region groups
+				COUNT_LAYER(i, "ordered_jump_um", jumps.jumpAfter * 1000.0);
+				COUNT_LAYER(i, "ordering_saved_jump_um", (jumps.jumpBefore - jumps.jumpAfter) * 1000.0);
+#endif
+				// estimate how long the scanner will take on this layer, and record it in the scan time CSV
+				scanTimeEstimate layerTime;
+				{
+					TRACE_SCOPE("scanTime", "genScan", i);
+					layerTime = scanTimer.layerTime(trajectoryList);
+				}
+				buildTime.add(layerTime);
+				if (!appendScanTimeRow(scanTimeFile, i, layerTime, newScanTimeFile)) {
+					errorMsg = "Could not write the scan time estimate to " + scanTimeFile + "\n";
+					updateErrorResults(errorData, true, "genScan", errorMsg, "", configData.configFilename, configData.configPath);
+				}
+				newScanTimeFile = false;
+
 				// write the XML schema to a DOM and then to a file
-				string fullXMLpath = configData.scanOutputFolder + "\\XMLdir\\" + xfn;
-				createSCANxmlFile(fullXMLpath, i, configData, trajectoryList);
+				string fullXMLpath = configData.scanOutputFolder + pathSep + "XMLdir" + pathSep + xfn;
+				{
+					TRACE_SCOPE("createSCANxmlFile", "genScan", i);
+					createSCANxmlFile(fullXMLpath, i, configData, trajectoryList, scanTimeComment(i, layerTime, firstTimedLayer, buildTime));
+				}
+				if (shard.shardId != "") {
+					if (!addManifestEntry(manifestFile, i, i * L.thickness, configData.scanOutputFolder + pathSep + "XMLdir", xfn)) {
+						errorMsg = "Could not add " + fullXMLpath + " to the shard manifest\n";
+						updateErrorResults(errorData, true, "genScan", errorMsg, "", configData.configFilename, configData.configPath);
+					}
+				}
 
 				// if user wants to generate SVG files and we are either on the first layer or a multiple of the SVG interval, do so
 				if ( (configData.createScanSVG == 1) && ((i % configData.scanSVGinterval == 0) | (i==0)) ) {
 					//write SCAN output to SVG
-					string fullSVGpath = configData.scanOutputFolder + "\\SVGdir\\" + svfn;
+					string fullSVGpath = configData.scanOutputFolder + pathSep + "SVGdir" + pathSep + svfn;
+					TRACE_SCOPE("scan2SVG", "genScan", i);
 					scan2SVG(fullSVGpath, trajectoryList, 2000, mag, xo, yo);
 				}
 				#if printTraj
@@ -443,14 +538,40 @@ int main(int argc, char **argv)
 				#endif
 			}  // if bCont
 		}  // if succeeded
+
+		// end this batch early if another layer is expected to exceed the memory budget
+		layerMemory.endLayer(i);
+		if ((i < fLayer) && !layerMemory.roomForNextLayer())
+		{
+			fLayer = i;
+			finished = 0;
+			break;
+		}
 	}  // for i
 
+#if STAGETIMING
+	// save this instance's timing samples, layer counts and batch for the run report assembled by createScanpaths
+	layerMemory.recordBatch(sLayer, fLayer);
+	appendRunSamples(configData.projectFolder + pathSep + shardFilename(runSamplesFilename, shard.shardId), "genScan");
+#endif
+
+	if ((shard.shardId != "") && (finished == 1)) {
+		finishManifest(manifestFile);
+	}
+	if ((finished == 1) && !newScanTimeFile) {
+		// all layers are done: close the scan time CSV with the total for the build (or for this shard's layers)
+		appendScanTimeTotal(scanTimeFile, buildTime);
+		cout << "\nEstimated scan time for layers " << firstTimedLayer << "-" << fLayer << ": " << fixed << setprecision(1) << buildTime.total() << " s ("
+			<< setprecision(2) << buildTime.total() / 3600.0 << " hours); see " << scanTimeFile << endl;
+	}
+
 	//write details to the *.cfg file for next call 
-	stfile.open("gs_sts.cfg");
+	stfile.open(statusFilename);
 	stfile << 1 << endl;		// started
 	stfile << fLayer << endl;	// last layer completed
 	stfile << finished << endl;	// finished flag
 	stfile << configData.scanOutputFolder << endl;	// config file folder
+	stfile << layerMemory.layerCostMB() << endl;	// per-layer memory estimate for the next call
 	stfile.close();
 
 	return 0;
@@ -0,0 +1,330 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+pathOrder.cpp implements the tour ordering described in
+pathOrder.h, and its use for contour rings and region groups
+//============================================================*/
+
+#include "pathOrder.h"
+#include "constants.h"
+#include "runReport.h"
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+static pathOrderTotals orderTotals;	// accumulated by this process until taken for the run report
+
+static double distance(const vertex &a, const vertex &b)
+{
+	return sqrt((b.x - a.x)*(b.x - a.x) + (b.y - a.y)*(b.y - a.y));
+}
+
+tourOrder orderTour(const vector<tourStop> &stops, const vertex &start, double budget_ms, int maxPasses)
+{
+	TIME_STAGE("orderTour");
+	const double eps = 1e-9;	// ignore moves which gain less than this (mm), so rounding cannot cycle
+	chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + chrono::microseconds((long long)(budget_ms * 1000.0));
+	auto outOfTime = [&]() { return (budget_ms > 0.0) && (chrono::steady_clock::now() > deadline); };
+	int n = (int)stops.size();
+	tourOrder result;
+	result.entries.assign(n, 0);
+	if (n == 0) { return result; }
+
+	// choice c of stop s: a ring's entry vertex, or the direction of an open stop
+	auto numChoices = [&](int s) -> int { return stops[s].closed ? (int)stops[s].entries.size() : (stops[s].reversible ? 2 : 1); };
+	auto entryOf = [&](int s, int c) -> const vertex & { return (stops[s].closed || (c == 0)) ? stops[s].entries[c] : stops[s].exit; };
+	auto exitOf = [&](int s, int c) -> const vertex & { return stops[s].closed ? stops[s].entries[c] : ((c == 0) ? stops[s].exit : stops[s].entries[0]); };
+
+	vertex pos = start;
+	for (int s = 0; s < n; s++)
+	{
+		result.jumpBefore += distance(pos, entryOf(s, 0));
+		pos = exitOf(s, 0);
+	}
+
+	// stops which must come later than each stop
+	bool ordered = false;
+	vector<vector<int>> followers(n);
+	for (int s = 0; s < n; s++)
+	{
+		if (stops[s].after >= 0) { followers[stops[s].after].push_back(s); ordered = true; }
+	}
+
+	//*** 1. nearest neighbour, skipping stops whose possible entries are all further away than the best candidate,
+	// and stops whose predecessor has not been visited yet
+	vector<double> minX(n), maxX(n), minY(n), maxY(n);
+	for (int s = 0; s < n; s++)
+	{
+		minX[s] = maxX[s] = entryOf(s, 0).x;
+		minY[s] = maxY[s] = entryOf(s, 0).y;
+		for (int c = 1; c < numChoices(s); c++)
+		{
+			minX[s] = min(minX[s], entryOf(s, c).x);
+			maxX[s] = max(maxX[s], entryOf(s, c).x);
+			minY[s] = min(minY[s], entryOf(s, c).y);
+			maxY[s] = max(maxY[s], entryOf(s, c).y);
+		}
+	}
+	vector<int> remaining(n);
+	for (int s = 0; s < n; s++) { remaining[s] = s; }
+	vector<bool> visited(n, false);
+	vector<int> &t = result.stops;
+	t.reserve(n);
+	pos = start;
+	while (!remaining.empty())
+	{
+		if (outOfTime())
+		{	// visit the rest as given
+			t.insert(t.end(), remaining.begin(), remaining.end());
+			break;
+		}
+		size_t bestR = 0;
+		int bestChoice = 0;
+		double bestD2 = numeric_limits<double>::max();
+		for (size_t r = 0; r < remaining.size(); r++)
+		{
+			int s = remaining[r];
+			if ((stops[s].after >= 0) && !visited[stops[s].after]) { continue; }
+			double dx = max(0.0, max(minX[s] - pos.x, pos.x - maxX[s]));
+			double dy = max(0.0, max(minY[s] - pos.y, pos.y - maxY[s]));
+			if (dx*dx + dy*dy >= bestD2) { continue; }
+			for (int c = 0; c < numChoices(s); c++)
+			{
+				const vertex &v = entryOf(s, c);
+				double d2 = (v.x - pos.x)*(v.x - pos.x) + (v.y - pos.y)*(v.y - pos.y);
+				if (d2 < bestD2) { bestD2 = d2; bestR = r; bestChoice = c; }
+			}
+		}
+		int s = remaining[bestR];
+		result.entries[s] = bestChoice;
+		t.push_back(s);
+		visited[s] = true;
+		remaining.erase(remaining.begin() + bestR);
+		pos = exitOf(s, bestChoice);
+	}
+
+	//*** 2. improve with 2-opt, Or-opt and the choice of entries until nothing helps, or the pass or time limit is reached
+	vector<vertex> en(n), ex(n);
+	vector<double> sumF(n, 0.0), sumB(n, 0.0);	// running totals of the jumps between neighbours, forward and with the pair swapped
+	vector<int> fixedCount(n + 1, 0);				// running count of open stops which cannot run backwards
+	vector<int> posOf(n);							// tour position of each stop
+	auto refresh = [&]() {
+		for (int k = 0; k < n; k++)
+		{
+			posOf[t[k]] = k;
+			en[k] = entryOf(t[k], result.entries[t[k]]);
+			ex[k] = exitOf(t[k], result.entries[t[k]]);
+			fixedCount[k + 1] = fixedCount[k] + ((stops[t[k]].closed || stops[t[k]].reversible) ? 0 : 1);
+		}
+		for (int k = 1; k < n; k++)
+		{
+			sumF[k] = sumF[k - 1] + distance(ex[k - 1], en[k]);
+			sumB[k] = sumB[k - 1] + distance(ex[k], en[k - 1]);
+		}
+	};
+	// true if stop s must come before or after a stop at positions first..last-1
+	auto linked = [&](int s, int first, int last) {
+		if ((stops[s].after >= 0) && (posOf[stops[s].after] >= first) && (posOf[stops[s].after] < last)) { return true; }
+		for (int f : followers[s]) { if ((posOf[f] >= first) && (posOf[f] < last)) { return true; } }
+		return false;
+	};
+	bool improved = true;
+	for (int pass = 0; improved && ((maxPasses <= 0) || (pass < maxPasses)) && !outOfTime(); pass++)
+	{
+		improved = false;
+
+		// 2-opt: reverse the order of the stops at positions i..j.  If every stop in the run can be run backwards, they all are,
+		// which keeps the jumps inside the run; otherwise each keeps its direction and the jumps inside the run are swapped
+		refresh();
+		for (int i = 0; i < n - 1; i++)
+		{
+			if (outOfTime()) { break; }
+			const vertex prevEx = (i == 0) ? start : ex[i - 1];
+			for (int j = i + 1; j < n; j++)
+			{
+				if (ordered && linked(t[j], i, j)) { break; }	// reversing this run, or any longer one, would break the order
+				bool flip = (fixedCount[j + 1] == fixedCount[i]);
+				double before = distance(prevEx, en[i]) + (sumF[j] - sumF[i]);
+				double after = flip ? distance(prevEx, ex[j]) + (sumF[j] - sumF[i]) : distance(prevEx, en[j]) + (sumB[j] - sumB[i]);
+				if (j + 1 < n)
+				{
+					before += distance(ex[j], en[j + 1]);
+					after += distance(flip ? en[i] : ex[i], en[j + 1]);
+				}
+				if (after < before - eps)
+				{
+					reverse(t.begin() + i, t.begin() + j + 1);
+					for (int k = i; flip && (k <= j); k++)
+					{
+						if (!stops[t[k]].closed) { result.entries[t[k]] ^= 1; }
+					}
+					refresh();
+					improved = true;
+				}
+			}
+		}
+
+		// Or-opt: move the run of len stops at position i to just before position p (p == n is the end)
+		for (int len = 1; len <= 3; len++)
+		{
+			for (int i = 0; i + len <= n; i++)
+			{
+				if (outOfTime()) { break; }
+				int last = i + len - 1;
+				const vertex prevEx = (i == 0) ? start : ex[i - 1];
+				double removeGain = distance(prevEx, en[i]);
+				if (last + 1 < n) { removeGain += distance(ex[last], en[last + 1]) - distance(prevEx, en[last + 1]); }
+				// the run may move back to just after the last predecessor of its stops, or on to just before the first follower
+				int pMin = 0, pMax = n;
+				for (int k = i; ordered && (k <= last); k++)
+				{
+					int s = t[k];
+					if ((stops[s].after >= 0) && (posOf[stops[s].after] < i)) { pMin = max(pMin, posOf[stops[s].after] + 1); }
+					for (int f : followers[s]) { if (posOf[f] > last) { pMax = min(pMax, posOf[f]); } }
+				}
+				for (int p = pMin; p <= pMax; p++)
+				{
+					if ((p >= i) && (p <= last + 1)) { continue; }	// inside the run, or its current place
+					const vertex before = (p == 0) ? start : ex[p - 1];
+					double addCost = distance(before, en[i]);
+					if (p < n) { addCost += distance(ex[last], en[p]) - distance(before, en[p]); }
+					if (addCost < removeGain - eps)
+					{
+						vector<int> run(t.begin() + i, t.begin() + last + 1);
+						t.erase(t.begin() + i, t.begin() + last + 1);
+						int at = (p > last) ? p - len : p;
+						t.insert(t.begin() + at, run.begin(), run.end());
+						refresh();
+						improved = true;
+						break;
+					}
+				}
+			}
+		}
+
+		// re-choose where (or which way round) each stop is entered, given its neighbours
+		for (int k = 0; k < n; k++)
+		{
+			int s = t[k];
+			if (numChoices(s) < 2) { continue; }
+			const vertex prevEx = (k == 0) ? start : ex[k - 1];
+			auto legs = [&](int c) { return distance(prevEx, entryOf(s, c)) + ((k + 1 < n) ? distance(exitOf(s, c), en[k + 1]) : 0.0); };
+			int bestChoice = result.entries[s];
+			double best = legs(bestChoice);
+			for (int c = 0; c < numChoices(s); c++)
+			{
+				double d = legs(c);
+				if (d < best - eps) { best = d; bestChoice = c; }
+			}
+			if (bestChoice != result.entries[s])
+			{
+				result.entries[s] = bestChoice;
+				en[k] = entryOf(s, bestChoice);
+				ex[k] = exitOf(s, bestChoice);
+				improved = true;
+			}
+		}
+	}
+
+	pos = start;
+	for (int k = 0; k < n; k++)
+	{
+		result.jumpAfter += distance(pos, entryOf(t[k], result.entries[t[k]]));
+		pos = exitOf(t[k], result.entries[t[k]]);
+	}
+	return result;
+}
+
+void orderRings(vector<vector<edge>> &rings)
+{
+	// each ring may be entered at the start of any of its edges
+	vector<tourStop> stops;
+	vector<size_t> ringOf;
+	for (size_t r = 0; r < rings.size(); r++)
+	{
+		if (rings[r].empty()) { continue; }
+		tourStop stop;
+		stop.closed = true;
+		stop.entries.reserve(rings[r].size());
+		for (size_t e = 0; e < rings[r].size(); e++) { stop.entries.push_back(rings[r][e].s); }
+		stops.push_back(move(stop));
+		ringOf.push_back(r);
+	}
+	if (stops.size() < 2) { return; }
+
+	// start where the rings as given would have started
+	tourOrder order = orderTour(stops, stops[0].entries[0], pathOrderBudget_ms, pathOrderMaxPasses);
+	vector<vector<edge>> ordered;
+	ordered.reserve(stops.size());
+	for (size_t k = 0; k < order.stops.size(); k++)
+	{
+		int s = order.stops[k];
+		vector<edge> &ring = rings[ringOf[s]];
+		rotate(ring.begin(), ring.begin() + order.entries[s], ring.end());
+		ordered.push_back(move(ring));
+	}
+	rings = move(ordered);
+	orderTotals.jumpBefore += order.jumpBefore;
+	orderTotals.jumpAfter += order.jumpAfter;
+}
+
+void orderPathGroups(vector<path> &paths, const vector<size_t> &groupStarts, const vector<int> &groupAfter, const vertex &start, bool hasStart)
+{
+	// a group is entered at the start of its first segment and left at the end of its last
+	vector<tourStop> stops;
+	vector<size_t> groupOf;
+	vector<int> stopOf(groupStarts.size(), -1);
+	for (size_t g = 0; g < groupStarts.size(); g++)
+	{
+		size_t first = groupStarts[g], end = (g + 1 < groupStarts.size()) ? groupStarts[g + 1] : paths.size();
+		size_t last = end;
+		for (size_t p = first; p < end; p++) { if (!paths[p].vecSg.empty()) { last = p; } }
+		if (last == end) { continue; }	// nothing to mark
+		while (paths[first].vecSg.empty()) { first++; }
+		tourStop stop;
+		stop.entries.push_back(paths[first].vecSg.front().start);
+		stop.exit = paths[last].vecSg.back().end;
+		if (groupAfter[g] >= 0) { stop.after = stopOf[groupAfter[g]]; }	// -1 if that group has nothing to mark
+		stopOf[g] = (int)stops.size();
+		stops.push_back(move(stop));
+		groupOf.push_back(g);
+	}
+	if (stops.size() < 2) { return; }
+
+	tourOrder order = orderTour(stops, hasStart ? start : stops[0].entries[0], pathOrderBudget_ms, pathOrderMaxPasses);
+	vector<path> ordered;
+	ordered.reserve(paths.size());
+	ordered.insert(ordered.end(), make_move_iterator(paths.begin()), make_move_iterator(paths.begin() + groupStarts[0]));	// ahead of any group
+	auto appendGroup = [&](size_t g) {
+		size_t end = (g + 1 < groupStarts.size()) ? groupStarts[g + 1] : paths.size();
+		ordered.insert(ordered.end(), make_move_iterator(paths.begin() + groupStarts[g]), make_move_iterator(paths.begin() + end));
+	};
+	// groups with nothing to mark stay in front, then the rest in tour order
+	vector<bool> inTour(groupStarts.size(), false);
+	for (size_t k = 0; k < order.stops.size(); k++) { inTour[groupOf[order.stops[k]]] = true; }
+	for (size_t g = 0; g < groupStarts.size(); g++) { if (!inTour[g]) { appendGroup(g); } }
+	for (size_t k = 0; k < order.stops.size(); k++) { appendGroup(groupOf[order.stops[k]]); }
+	paths = move(ordered);
+	orderTotals.jumpBefore += order.jumpBefore;
+	orderTotals.jumpAfter += order.jumpAfter;
+}
+
+pathOrderTotals takePathOrderTotals()
+{
+	pathOrderTotals t = orderTotals;
+	orderTotals = pathOrderTotals();
+	return t;
+}
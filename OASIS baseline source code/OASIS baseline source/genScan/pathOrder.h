@@ -0,0 +1,86 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+pathOrder.h defines the ordering stage which shortens the jumps
+between the pieces of a trajectory: the offset rings of a contour
+path, and the region groups (paths of one type and tag) of a
+trajectory.
+
+Pieces are "stops" of a tour.  A closed stop (a ring) may be entered
+at any of its vertices and is left where it was entered; an open
+stop (a group of paths) has a fixed start and end, unless it is
+reversible (a hatchOPT island), when it may also be run backwards.
+orderTour builds a nearest-neighbour tour from the scanner's
+position, then improves it with 2-opt (reversing a run of stops,
+and running reversible stops backwards) and Or-opt (moving a run of
+up to three stops), re-choosing each stop's entry between passes,
+until no move helps or the pass or time limit is reached.  A stop
+may have to follow another (a tag's hatch follows its contours when
+both are in one trajectory); the tour and every move keep that
+order.  Only the order of stops and their entries change; every
+mark is kept.
+
+The jump lengths before and after ordering are totalled per process
+so genScan can list them for each layer in the run report
+//============================================================*/
+
+#pragma once
+
+#include <vector>
+
+#include "ScanPath.h"
+
+using namespace std;
+
+// one piece of a tour.  For a closed stop, entries holds every vertex it may be entered (and left) at;
+// an open stop is entered at entries[0] and left at exit, or the other way round if it is reversible.
+// after, if not -1, is a stop given earlier in the list which the tour must also visit earlier
+struct tourStop
+{
+	vector<vertex> entries;
+	vertex exit;
+	bool closed = false;
+	bool reversible = false;
+	int after = -1;
+};
+
+// order of the stops and the entry chosen in each: an index into entries for a closed stop, or 1 if an open stop is run backwards
+struct tourOrder
+{
+	vector<int> stops;
+	vector<int> entries;		// by stop number, not tour position
+	double jumpBefore = 0.0;	// jump length (mm) visiting the stops as given, each entered at entries[0]
+	double jumpAfter = 0.0;		// jump length (mm) of the ordered tour
+};
+
+// orders the stops to shorten the jumps from start through all of them.  Improvement stops after maxPasses passes
+// (0 = no limit) or budget_ms milliseconds (0 = no limit).  Without a time limit the result is the same on every run
+tourOrder orderTour(const vector<tourStop> &stops, const vertex &start, double budget_ms, int maxPasses = 0);
+
+// re-orders the offset rings of a contour and rotates each to start at its chosen entry.  Each ring's edges must run head to tail
+void orderRings(vector<vector<edge>> &rings);
+
+// re-orders the region groups of a trajectory.  Group g holds the paths from groupStarts[g] up to the next group's start;
+// paths keep their order within a group.  groupAfter[g] is an earlier group which must stay ahead of group g (a tag's
+// contours ahead of its hatch), or -1.  start is the scanner position before the first path, if hasStart is true
+void orderPathGroups(vector<path> &paths, const vector<size_t> &groupStarts, const vector<int> &groupAfter, const vertex &start, bool hasStart);
+
+// jump lengths (mm) before and after ordering, accumulated by orderRings and orderPathGroups since the last call
+struct pathOrderTotals
+{
+	double jumpBefore = 0.0;
+	double jumpAfter = 0.0;
+};
+pathOrderTotals takePathOrderTotals();
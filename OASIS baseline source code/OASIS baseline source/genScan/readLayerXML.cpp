@@ -20,6 +20,7 @@ scanpath generation
 
 #include "readLayerXML.h"
 #include "ScanPath.h"
+#include "runReport.h"
 
 HRESULT VariantFromString(PCWSTR wszValue, VARIANT &Variant)
 {
@@ -36,7 +37,11 @@ CleanUp:
 
 HRESULT CreateAndInitDOM(IXMLDOMDocument **ppDoc)
 {
+#ifdef _WIN32
 	HRESULT hr = CoCreateInstance(__uuidof(DOMDocument60), NULL, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(ppDoc));
+#else
+	HRESULT hr = createDOMDocument(ppDoc);	// portable DOM subset from xmlDOM.h
+#endif
 	if (SUCCEEDED(hr))
 	{
 		(*ppDoc)->put_async(VARIANT_FALSE);
@@ -110,10 +115,10 @@ CleanUp:
 
 layer traverseDOM()
 {	// Parses values in the Domain Object Model into a layer structure
+	TIME_STAGE("traverseDOM");
 	layer L;
-	slice s;
 	vector<region> rList;
-	vector<vertex> vertexList;
+	vector<vertex> &vertexList = L.vList;	// vertices are read straight into the layer
 	vector<edge> eList;
 	L.thickness = 0.0;  // initialize a value
 
@@ -123,6 +128,9 @@ layer traverseDOM()
 	IXMLDOMNode *node = NULL;
 	IXMLDOMNode *node2 = NULL;
 	IXMLDOMNode *node3 = NULL;
+	IXMLDOMNodeList *ncList = NULL;
+	IXMLDOMNode *vtx = NULL;
+	IXMLDOMNode *regionNode = NULL;
 	BSTR rootName = NULL;
 	BSTR nodeName = NULL;
 	BSTR nodeText;
@@ -153,15 +161,14 @@ layer traverseDOM()
 #if printDOM
 	printf("\t+%S\n", nodeName);
 #endif
-	IXMLDOMNodeList *ncList = NULL;
 	CHK_HR(node->get_childNodes(&ncList));
 	long ncLength;
 	CHK_HR(ncList->get_length(&ncLength));
 	// get vertex type
 	int i;
 	int j;
-	IXMLDOMNode *vtx = NULL;
 	vertexList.clear();
+	vertexList.reserve(ncLength / 2);	// only the odd-numbered children are vertices
 	for (i = 0; i < ncLength; i++)
 	{
 		CHK_HR(ncList->nextNode(&vtx));
@@ -194,7 +201,6 @@ layer traverseDOM()
 			vertexList.push_back(v);
 		}
 	}
-	L.vList = vertexList;
 
 	//get layer information
 	CHK_HR(rchildList->get_item(5, &node));
@@ -205,7 +211,6 @@ layer traverseDOM()
 	CHK_HR(node->get_childNodes(&ncList));
 	CHK_HR(ncList->get_length(&ncLength));
 	rList.clear();
-	IXMLDOMNode *regionNode = NULL;
 	for (i = 0; i < ncLength; i++)
 	{
 		region r;
@@ -261,6 +266,7 @@ layer traverseDOM()
 			CHK_HR((rcNode)->get_baseName(&nodeName));			
 			IXMLDOMNode *edgeNode = NULL;
 			eList.clear();
+			eList.reserve(rcLength / 2);	// edges are the odd-numbered children after the first four values
 			for (j = 0; j < rcLength; j++)
 			{
 				edge e;
@@ -293,12 +299,11 @@ layer traverseDOM()
 					eList.push_back(e);
 				}
 			}
-			r.eList = eList;
-			rList.push_back(r);			
+			r.eList = move(eList);	// eList is cleared before the next region
+			rList.push_back(move(r));
 		}	
 	}
-	s.rList = rList;
-	L.s = s;
+	L.s.rList = move(rList);
 	SAFE_RELEASE(pRoot);
 	SAFE_RELEASE(rchildList);
 	SAFE_RELEASE(node);
@@ -321,7 +326,7 @@ CleanUp:
 	return L;
 }
 
-int verifyLayerStructure(AMconfig &configData, string layerFilename, layer lyr, vector<string> tagList)
+int verifyLayerStructure(AMconfig &configData, string layerFilename, const layer &lyr, const vector<string> &tagList)
 {	// Evaluates key values within the layer structure read from XML against region-tags and other expectations
 	// We aggregate all errors and only halt at the end if an error was encountered
 	// Currently we only check region metadata; we don't verify that all the vertices are real-valued or are properly closed
@@ -340,7 +345,7 @@ int verifyLayerStructure(AMconfig &configData, string layerFilename, layer lyr,
 	for (int r = 0; r < lyr.s.rList.size(); r++) {
 
 		// is region tag in config file region profile list?
-		std::vector<string>::iterator it;
+		std::vector<string>::const_iterator it;
 		it = std::find(tagList.begin(), tagList.end(), lyr.s.rList[r].tag);
 		if (it == tagList.end()) {
 			// region tag not found in config file list
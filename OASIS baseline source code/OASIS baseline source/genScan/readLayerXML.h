@@ -25,9 +25,8 @@ layer xml file to an internal data structure.
 #ifndef READXML_H
 #define READXML_H
 #include <vector>
-#include <msxml6.h>
+#include "xmlDOM.h"
 #include "Layer.h"
-#include <comdef.h>
 
 #include "readExcelConfig.h"
 #include "errorChecks.h"
@@ -65,6 +64,6 @@ int loadDOM(PCWSTR wszValue);
 layer traverseDOM();
 
 // Verify key values in the layer structure parsed from the layer DOM
-int verifyLayerStructure(AMconfig &configData, string layerFilename, layer lyr, vector<string> tagList);
+int verifyLayerStructure(AMconfig &configData, string layerFilename, const layer &lyr, const vector<string> &tagList);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+scanArena.cpp implements the per-layer memory arena of genScan
+(see scanArena.h)
+//============================================================*/
+
+#include "scanArena.h"
+
+using namespace std;
+
+scanArena::~scanArena()
+{
+	for (size_t i = 0; i < blocks.size(); i++) { delete[] blocks[i].data; }
+}
+
+void *scanArena::allocate(size_t bytes, size_t align)
+{
+	liveAllocations++;
+	for (;;)
+	{
+		if (current < blocks.size())
+		{
+			size_t start = (offset + align - 1) & ~(align - 1);
+			if (start + bytes <= blocks[current].size)
+			{
+				offset = start + bytes;
+				size_t inUse = offset;
+				for (size_t i = 0; i < current; i++) { inUse += blocks[i].size; }
+				if (inUse > highWaterBytes) { highWaterBytes = inUse; }
+				return blocks[current].data + start;
+			}
+			// move on to the next block.  A kept block that is too small for this request is skipped
+			current++;
+			offset = 0;
+			continue;
+		}
+		block b;
+		b.size = (bytes > scanArenaBlockBytes) ? bytes : scanArenaBlockBytes;
+		b.data = new char[b.size];
+		blocks.push_back(b);
+	}
+}
+
+void scanArena::deallocate()
+{
+	if (liveAllocations > 0 && --liveAllocations == 0)
+	{
+		current = 0;
+		offset = 0;
+	}
+}
+
+void scanArena::reset()
+{
+	liveAllocations = 0;
+	current = 0;
+	offset = 0;
+}
+
+size_t scanArena::capacity() const
+{
+	size_t bytes = 0;
+	for (size_t i = 0; i < blocks.size(); i++) { bytes += blocks[i].size; }
+	return bytes;
+}
+
+scanArena &layerArena()
+{
+	static scanArena arena;
+	return arena;
+}
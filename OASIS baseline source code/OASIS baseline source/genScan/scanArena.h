@@ -0,0 +1,92 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+scanArena.h defines a monotonic memory arena for the short-lived
+working lists genScan builds while it processes one layer (hatch
+intersections, duplicate lists, trajectory lookups).
+
+Allocations are carved from large blocks and never freed one by
+one.  The arena rewinds in O(1) when its last live allocation is
+released, and genScan also resets it between layers (clearVars).
+Blocks are kept, so once the largest layer has been seen no more
+memory is requested from the heap.
+
+Use arenaVector<T> in place of vector<T> for such lists.  An
+arenaVector must not outlive the layer it was created for
+//============================================================*/
+
+#pragma once
+
+#include <vector>
+#include <stddef.h>
+
+using namespace std;
+
+// size of each block requested from the heap; larger requests get a block of their own
+static const size_t scanArenaBlockBytes = 1 << 20;
+
+class scanArena
+{
+public:
+	scanArena() : current(0), offset(0), liveAllocations(0), highWaterBytes(0) {}
+	~scanArena();
+	// return bytes of storage aligned to align (a power of two)
+	void *allocate(size_t bytes, size_t align);
+	// release one allocation.  Nothing is freed until the last live allocation is released, when the arena rewinds
+	void deallocate();
+	// rewind to the start of the first block, discarding all allocations
+	void reset();
+	// bytes held in blocks, and the most bytes in use at once since the arena was created
+	size_t capacity() const;
+	size_t highWater() const { return highWaterBytes; }
+private:
+	struct block
+	{
+		char *data;
+		size_t size;
+	};
+	vector<block> blocks;
+	size_t current;				// block currently being filled
+	size_t offset;				// first free byte in blocks[current]
+	size_t liveAllocations;
+	size_t highWaterBytes;
+	scanArena(const scanArena &);				// not copyable
+	scanArena &operator=(const scanArena &);
+};
+
+// the arena shared by genScan's per-layer working lists
+scanArena &layerArena();
+
+// standard allocator that takes its storage from a scanArena (layerArena() by default)
+template <typename T>
+struct arenaAllocator
+{
+	typedef T value_type;
+	scanArena *arena;
+	arenaAllocator() : arena(&layerArena()) {}
+	explicit arenaAllocator(scanArena &a) : arena(&a) {}
+	template <typename U> arenaAllocator(const arenaAllocator<U> &other) : arena(other.arena) {}
+	T *allocate(size_t n) { return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T))); }
+	void deallocate(T *, size_t) { arena->deallocate(); }
+};
+
+template <typename T, typename U>
+bool operator==(const arenaAllocator<T> &a, const arenaAllocator<U> &b) { return a.arena == b.arena; }
+template <typename T, typename U>
+bool operator!=(const arenaAllocator<T> &a, const arenaAllocator<U> &b) { return a.arena != b.arena; }
+
+// vector whose storage lives in layerArena()
+template <typename T>
+using arenaVector = vector<T, arenaAllocator<T>>;
@@ -0,0 +1,269 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+scanTime.cpp implements the scan time estimate described in
+scanTime.h.  The SegmentStyle lookup is built once per build, and
+each layer is then a single pass over its segments
+//============================================================*/
+
+#include "scanTime.h"
+#include "constants.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+void scanTimeEstimate::add(const scanTimeEstimate &t)
+{
+	markTime += t.markTime;
+	jumpTime += t.jumpTime;
+	delayTime += t.delayTime;
+	overlapTime += t.overlapTime;
+	markLength += t.markLength;
+	jumpLength += t.jumpLength;
+	marks += t.marks;
+	jumps += t.jumps;
+}
+
+scanTimeEstimator::scanTimeEstimator(const AMconfig &configData)
+{
+	// segments carry either the string or the auto-generated integer ID of their style, depending on outputIntegerIDs
+	styles.reserve(configData.segmentStyleList.size());
+	for (size_t s = 0; s < configData.segmentStyleList.size(); s++)
+	{
+		const segmentStyle &ss = configData.segmentStyleList[s];
+		styleTiming st;
+		if ((ss.vpIntID >= 1) && (ss.vpIntID <= (int)configData.VPlist.size()))
+		{
+			// vpIntID is the 1-based position of the style's profile in VPlist.  Delays are in microseconds; negative
+			// delays (laser-on may lead the scanner) overlap motion and add no time
+			const velocityProfile &vp = configData.VPlist[ss.vpIntID - 1];
+			st.velocity = vp.velocity;
+			st.laserOnDelay = max(0.0, vp.laserOnDelay) * 1e-6;
+			st.laserOffDelay = max(0.0, vp.laserOffDelay) * 1e-6;
+			st.jumpDelay = max(0.0, vp.jumpDelay) * 1e-6;
+			st.markDelay = max(0.0, vp.markDelay) * 1e-6;
+			st.polygonDelay = max(0.0, vp.polygonDelay) * 1e-6;
+		}
+		st.laser = ss.leadLaser.travelerID;
+		styleIndex[configData.outputIntegerIDs ? to_string(ss.integerID) : ss.ID] = (int)styles.size();
+		styles.push_back(st);
+	}
+}
+
+const scanTimeEstimator::styleTiming *scanTimeEstimator::findStyle(const string &idSegStyl) const
+{
+	unordered_map<string, int>::const_iterator it = styleIndex.find(idSegStyl);
+	return (it == styleIndex.end()) ? NULL : &styles[it->second];
+}
+
+static double segmentLength(const vertex &a, const vertex &b)
+{
+	return sqrt((b.x - a.x)*(b.x - a.x) + (b.y - a.y)*(b.y - a.y));
+}
+
+scanTimeEstimate scanTimeEstimator::pathTime(const path &P, vertex *position, bool *hasPosition, const styleTiming **lastJump) const
+{
+	scanTimeEstimate t;
+	if (P.vecSg.size() == 0) { return t; }
+	bool sky = (P.SkyWritingMode > 0);
+	double runIn = skywritingRunIn_us * 1e-6;
+	double runOut = skywritingRunOut_us * 1e-6;
+
+	// alternating hatch and jump segments use just two styles, so remember the last lookup of each kind
+	const string *markID = NULL, *jumpID = NULL;
+	const styleTiming *markStyle = NULL, *jumpStyle = NULL;
+
+	// jump from wherever the previous path ended, with this path's jump profile if it has one
+	if (*hasPosition)
+	{
+		const styleTiming *travel = *lastJump;
+		for (size_t k = 0; k < P.vecSg.size(); k++)
+		{
+			if (P.vecSg[k].isMark == 0) { travel = findStyle(P.vecSg[k].idSegStyl); break; }
+		}
+		double len = segmentLength(*position, P.vecSg[0].start);
+		if ((len > 0.0) && (travel != NULL))
+		{
+			t.jumps++;
+			t.jumpLength += len;
+			if (travel->velocity > 0.0) { t.jumpTime += len / travel->velocity; }
+			t.delayTime += travel->jumpDelay;
+		}
+	}
+
+	// the scan file gives the path's start and then only the end of each segment, so each segment runs from the previous end
+	const styleTiming *prevMark = NULL;	// style of the previous segment, if it was a mark
+	bool prevWasMark = false;
+	vertex from = P.vecSg[0].start;
+	for (vector<segment>::const_iterator sg = P.vecSg.begin(); sg != P.vecSg.end(); ++sg)
+	{
+		double len = segmentLength(from, sg->end);
+		from = sg->end;
+		if (sg->isMark != 0)
+		{
+			if ((markID == NULL) || (*markID != sg->idSegStyl)) { markID = &sg->idSegStyl; markStyle = findStyle(sg->idSegStyl); }
+			t.marks++;
+			t.markLength += len;
+			if (markStyle != NULL)
+			{
+				if (markStyle->velocity > 0.0) { t.markTime += len / markStyle->velocity; }
+				if (!prevWasMark) { t.delayTime += sky ? runIn : markStyle->laserOnDelay; }
+				else if (P.SkyWritingMode == 1) { t.delayTime += runOut + runIn; }
+				else { t.delayTime += markStyle->polygonDelay; }
+			}
+			prevMark = markStyle;
+			prevWasMark = true;
+		}
+		else
+		{
+			if ((jumpID == NULL) || (*jumpID != sg->idSegStyl)) { jumpID = &sg->idSegStyl; jumpStyle = findStyle(sg->idSegStyl); }
+			if (prevWasMark && (prevMark != NULL)) { t.delayTime += sky ? runOut : max(prevMark->markDelay, prevMark->laserOffDelay); }
+			t.jumps++;
+			t.jumpLength += len;
+			if (jumpStyle != NULL)
+			{
+				if (jumpStyle->velocity > 0.0) { t.jumpTime += len / jumpStyle->velocity; }
+				t.delayTime += jumpStyle->jumpDelay;
+				*lastJump = jumpStyle;
+			}
+			prevWasMark = false;
+		}
+	}
+	if (prevWasMark && (prevMark != NULL)) { t.delayTime += sky ? runOut : max(prevMark->markDelay, prevMark->laserOffDelay); }
+
+	*position = P.vecSg.back().end;
+	*hasPosition = true;
+	return t;
+}
+
+scanTimeEstimate scanTimeEstimator::pathTime(const path &P) const
+{
+	vertex position;
+	bool hasPosition = false;
+	const styleTiming *lastJump = NULL;
+	return pathTime(P, &position, &hasPosition, &lastJump);
+}
+
+string scanTimeEstimator::pathLaser(const path &P) const
+{
+	for (vector<segment>::const_iterator sg = P.vecSg.begin(); sg != P.vecSg.end(); ++sg)
+	{
+		if (sg->isMark != 0)
+		{
+			const styleTiming *st = findStyle(sg->idSegStyl);
+			return (st == NULL) ? string() : st->laser;
+		}
+	}
+	return string();
+}
+
+scanTimeEstimate scanTimeEstimator::layerTime(const vector<trajectory> &trajectoryList) const
+{
+	scanTimeEstimate layerTotal;
+	vertex position;
+	bool hasPosition = false;
+	const styleTiming *lastJump = NULL;
+	for (vector<trajectory>::const_iterator tr = trajectoryList.begin(); tr != trajectoryList.end(); ++tr)
+	{
+		bool concurrent = (tr->pathProcessingMode == "concurrent");
+		double sumPaths = 0.0, busiestLaser = 0.0;
+		unordered_map<string, double> laserTime;	// concurrent paths on the same laser still run one after another
+		for (vector<path>::const_iterator p = tr->vecPath.begin(); p != tr->vecPath.end(); ++p)
+		{
+			scanTimeEstimate pt = pathTime(*p, &position, &hasPosition, &lastJump);
+			sumPaths += pt.total();
+			layerTotal.add(pt);
+			if (concurrent)
+			{
+				string laser = pathLaser(*p);
+				double busy = laser.empty() ? pt.total() : (laserTime[laser] += pt.total());
+				busiestLaser = max(busiestLaser, busy);
+			}
+		}
+		if (concurrent) { layerTotal.overlapTime += sumPaths - busiestLaser; }
+	}
+	return layerTotal;
+}
+
+string scanTimeComment(int layerNum, const scanTimeEstimate &layerTime, int firstLayer, const scanTimeEstimate &cumulativeTime)
+{
+	ostringstream text;
+	text << fixed << setprecision(3) << "Estimated scan time for layer " << layerNum << ": " << layerTime.total() << " s (marks " << layerTime.markTime
+		<< " s, jumps " << layerTime.jumpTime << " s, delays " << layerTime.delayTime << " s";
+	if (layerTime.overlapTime > 0.0) { text << ", less " << layerTime.overlapTime << " s for concurrent paths"; }
+	text << ").  Layers " << firstLayer << "-" << layerNum << ": " << cumulativeTime.total() << " s";
+	return text.str();
+}
+
+//**************************
+// scan time CSV file
+
+static void writeScanTimeFields(ofstream &out, const scanTimeEstimate &t)
+{
+	out << fixed << setprecision(6) << t.total() << "," << t.markTime << "," << t.jumpTime << "," << t.delayTime << "," << t.overlapTime << ","
+		<< setprecision(3) << t.markLength << "," << t.jumpLength << "," << t.marks << "," << t.jumps << "\n";
+}
+
+bool appendScanTimeRow(const string &csvFile, int layerNum, const scanTimeEstimate &t, bool startNewFile)
+{
+	ofstream out(csvFile, startNewFile ? ios::trunc : ios::app);
+	if (!out) { return false; }
+	if (startNewFile) { out << "layer,estimate_s,mark_s,jump_s,delay_s,overlap_s,mark_mm,jump_mm,marks,jumps\n"; }
+	out << layerNum << ",";
+	writeScanTimeFields(out, t);
+	return (bool)out;
+}
+
+scanTimeEstimate readScanTimeTotal(const string &csvFile, int *firstLayer, int *lastLayer)
+{
+	scanTimeEstimate total;
+	bool found = false;
+	*firstLayer = 0;
+	*lastLayer = 0;
+	ifstream in(csvFile);
+	string line;
+	while (getline(in, line))
+	{
+		// layer rows begin with a digit; the heading and total rows are skipped
+		if (line.empty() || !isdigit((unsigned char)line[0])) { continue; }
+		istringstream fields(line);
+		int layerNum;
+		double estimate;
+		char c;
+		scanTimeEstimate t;
+		if (fields >> layerNum >> c >> estimate >> c >> t.markTime >> c >> t.jumpTime >> c >> t.delayTime >> c >> t.overlapTime
+			>> c >> t.markLength >> c >> t.jumpLength >> c >> t.marks >> c >> t.jumps)
+		{
+			*firstLayer = found ? min(*firstLayer, layerNum) : layerNum;
+			*lastLayer = found ? max(*lastLayer, layerNum) : layerNum;
+			found = true;
+			total.add(t);
+		}
+	}
+	return total;
+}
+
+bool appendScanTimeTotal(const string &csvFile, const scanTimeEstimate &t)
+{
+	ofstream out(csvFile, ios::app);
+	if (!out) { return false; }
+	out << "total,";
+	writeScanTimeFields(out, t);
+	return (bool)out;
+}
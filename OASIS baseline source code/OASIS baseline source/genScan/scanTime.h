@@ -0,0 +1,112 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+scanTime.h defines an analytical estimate of how long the scanner
+will take to execute a layer's scanpaths.
+
+Each segment's SegmentStyle gives its velocity profile.  Marks and
+jumps take their length divided by the profile's velocity, and the
+profile's delays (microseconds) are charged as a scan card applies
+them:
+	laserOnDelay	before the first mark after a jump
+	markDelay		after the last mark before a jump (or
+					laserOffDelay, if that is longer)
+	polygonDelay	between consecutive marks
+	jumpDelay		after each jump
+With skywriting (modes 1-3) the laser delays at the ends of a run
+of marks are replaced by the run-in and run-out moves set in
+constants.h; mode 1 also applies them at every corner.  Paths in a
+"concurrent" trajectory overlap, so only the busiest laser counts;
+paths whose styles name no laser are taken to run on lasers of
+their own.
+
+genScan writes the estimate for each layer to a comment in its scan
+file and a row of scanTimeFilename, with a build total at the end
+//============================================================*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "ScanPath.h"
+#include "readExcelConfig.h"
+
+using namespace std;
+
+// estimated scan time for a path, layer or build; times in seconds, lengths in mm
+struct scanTimeEstimate
+{
+	double markTime = 0.0;		// marking at the velocity of each mark's profile
+	double jumpTime = 0.0;		// jumps, including those between paths
+	double delayTime = 0.0;		// laser-on/off, mark, polygon and jump delays plus skywriting run-in/out
+	double overlapTime = 0.0;	// time saved by running the paths of concurrent trajectories together
+	double markLength = 0.0;
+	double jumpLength = 0.0;
+	long long marks = 0;
+	long long jumps = 0;
+
+	double total() const { return markTime + jumpTime + delayTime - overlapTime; }
+	void add(const scanTimeEstimate &t);
+};
+
+class scanTimeEstimator
+{
+public:
+	// resolves every SegmentStyle in configData to its velocity profile, once per build
+	explicit scanTimeEstimator(const AMconfig &configData);
+
+	// estimate for all trajectories of a layer, in build order
+	scanTimeEstimate layerTime(const vector<trajectory> &trajectoryList) const;
+
+	// estimate for a single path, excluding the jump to its start
+	scanTimeEstimate pathTime(const path &P) const;
+
+	// lead laser of the path's first mark, or "" if its styles name none
+	string pathLaser(const path &P) const;
+
+private:
+	// velocity (mm/s) and delays (s) of one SegmentStyle's velocity profile
+	struct styleTiming
+	{
+		double velocity = 0.0;
+		double laserOnDelay = 0.0;
+		double laserOffDelay = 0.0;
+		double jumpDelay = 0.0;
+		double markDelay = 0.0;
+		double polygonDelay = 0.0;
+		string laser;				// lead laser's traveler ID
+	};
+
+	vector<styleTiming> styles;
+	unordered_map<string, int> styleIndex;	// SegmentStyle ID, as written to segments (string or integer ID), to styles
+
+	const styleTiming *findStyle(const string &idSegStyl) const;
+	// time for one path; *position is where the scanner starts and is left at the path's end
+	scanTimeEstimate pathTime(const path &P, vertex *position, bool *hasPosition, const styleTiming **lastJump) const;
+};
+
+// text of the scan file comment giving a layer's estimate and the running total for layers firstLayer to layerNum
+string scanTimeComment(int layerNum, const scanTimeEstimate &layerTime, int firstLayer, const scanTimeEstimate &cumulativeTime);
+
+// append one layer's estimate to a scan time CSV file, writing the column headings first if startNewFile is true
+bool appendScanTimeRow(const string &csvFile, int layerNum, const scanTimeEstimate &t, bool startNewFile);
+
+// sum the layer rows of a scan time CSV file, and report the first and last layer numbers found
+scanTimeEstimate readScanTimeTotal(const string &csvFile, int *firstLayer, int *lastLayer);
+
+// append the build total row to a scan time CSV file
+bool appendScanTimeTotal(const string &csvFile, const scanTimeEstimate &t);
@@ -21,8 +21,10 @@ is formatted as per ALSAM 3024 documentation
 
 #include "writeScanXML.h"
 #include <sstream>
-#include "simple_svg_1.0.0.hpp"
+#include <unordered_map>
+#include "svgStream.h"
 #include "constants.h"
+#include "runReport.h"
 
 
 // Helper that allocates the BSTR param for the caller.
@@ -174,15 +176,35 @@ CleanUp:
 	return hr;
 }
 
+// key of a group of regions within identifyTrajectories: position of the trajectory in tl, type and tag
+struct regionGroupKey
+{
+	size_t trajectory;
+	regionType type;
+	string tag;
+	bool operator==(const regionGroupKey &k) const { return (trajectory == k.trajectory) && (type == k.type) && (tag == k.tag); }
+};
+
+struct regionGroupKeyHash
+{
+	size_t operator()(const regionGroupKey &k) const
+	{
+		return hash<string>()(k.tag) ^ ((k.trajectory * 2 + (k.type == regionType::hatch ? 1 : 0)) * 0x9E3779B97F4A7C15ULL);
+	}
+};
+
 vector<trajectory> identifyTrajectories(AMconfig &configData, layer &L, int layerNum)
 {
 	// This routine identifies trajectories found in the current layer (corresponding to actual parts, not single stripes), and
 	// adds in one or more trajectories for single-stripes, if they are included in this layer.
 	// L.s is the slice structure which contains a list of regions, rList.
-	trajectory t;  // placeholder for a single trajectory and its regions
+	// Regions are also grouped by trajectory, type and tag, as genScan contours or hatches them, in one pass over the regions
 	vector<trajectory> tl;	// output:  list of all trajectories and their regions
-	vector<int> tlValues; // temp variable which lists the trajNum values in tl for easy reference
-	int index;
+	unordered_map<int, size_t> tlIndex;	// position in tl of each trajectory#
+	unordered_map<regionGroupKey, size_t, regionGroupKeyHash> groupIndex;	// position of each group in its trajectory's regionGroups
+	unordered_map<string, int> profileIndex;	// region profile of each tag; the first profile with a tag is used
+	for (int p = (int)configData.regionProfileList.size() - 1; p >= 0; p--) { profileIndex[configData.regionProfileList[p].Tag] = p; }
+	groupIndex.reserve(L.s.rList.size());
 	#if printTrajectories
 		cout << "Total number of regions " << L.s.rList.size() << endl;
 	#endif
@@ -203,92 +225,58 @@ vector<trajectory> identifyTrajectories(AMconfig &configData, layer &L, int laye
 			stripeTraj.trajectoryNum = stripeTrajectoriesThisLayer[st];
 			stripeTraj.pathProcessingMode = "sequential";
 			path stripePath = singleStripes(layerNum, stripeTrajectoriesThisLayer[st], configData);  // define marks and jumps for the stripe path within a particular trajectory#
-			stripeTraj.vecPath.push_back(stripePath);
+			stripeTraj.vecPath.push_back(move(stripePath));
 			// add stripe trajectory to trajectoryList.  stripes get written first, in trajectory# order
-			tl.push_back(stripeTraj);
-			tlValues.push_back(stripeTraj.trajectoryNum);
+			tlIndex.emplace(stripeTraj.trajectoryNum, tl.size());
+			tl.push_back(move(stripeTraj));
 		}
 	}
 
 	// 2. Iterate across the regions found in a layer and record their trajectory#'s.
 	// Within r we refer to contourTraj and hatchTraj to identify trajectories
-	for (vector<region>::iterator r = L.s.rList.begin(); r != L.s.rList.end(); ++r)
-	{	
-		#if printTrajectories
-			cout << "Looking for contourTraj#" << (*r).contourTraj << endl;
-		#endif
-		// 1a. See if r.contourTraj exists in tl.trajNum values.
-		std::vector<int>::iterator it = std::find(tlValues.begin(), tlValues.end(), (*r).contourTraj);
-		if (it != tlValues.end())
-		{	// this trajectory# already exists in tl.  Add the region# to that trajectory's region list
-			index = std::distance(tlValues.begin(), it);
-			tl[index].trajRegions.push_back(std::distance(L.s.rList.begin(), r));
-			tl[index].trajRegionTypes.push_back("contour");
-			tl[index].trajRegionTags.push_back((*r).tag);
-			tl[index].trajRegionIsHatched.push_back(false);
-			tl[index].trajRegionLinks.push_back(&*r);
-			#if printTrajectories
-				cout << "  Added region " << std::distance(L.s.rList.begin(), r) << " to trajectory " << tl[index].trajectoryNum << endl;
-			#endif
-		}
-		else
-		{	// r.contourTraj not found; create new trajectory entry.
-			// first add the new trajectory# to the list of trajectories
-			tlValues.push_back((*r).contourTraj);
-			t.trajectoryNum = (*r).contourTraj;
-			t.trajRegions.clear();
-			t.trajRegionTypes.clear();
-			t.trajRegionTags.clear();
-			t.trajRegionIsHatched.clear();
-			t.trajRegionLinks.clear();
-			t.trajRegions.push_back(std::distance(L.s.rList.begin(), r));
-			t.trajRegionTypes.push_back("contour");
-			t.trajRegionTags.push_back((*r).tag);
-			t.trajRegionIsHatched.push_back(false);
-			t.trajRegionLinks.push_back(&*r);
-			tl.push_back(t);
+	for (int r = 0; r < (int)L.s.rList.size(); r++)
+	{
+		region &rg = L.s.rList[r];
+		// the region's contours, then its hatch
+		for (int pass = 0; pass < 2; pass++)
+		{
+			regionType type = (pass == 0) ? regionType::contour : regionType::hatch;
+			int trajNum = (pass == 0) ? rg.contourTraj : rg.hatchTraj;
 			#if printTrajectories
-				cout << "  Defined trajectory number " << t.trajectoryNum << endl;
+				cout << "Looking for " << regionTypeName(type) << "Traj#" << trajNum << endl;
 			#endif
-		}
-
-		// 2a. See if r.hatchTraj exists in tl.trajNum values
-		#if printTrajectories
-			cout << "Looking for hatchTraj#" << (*r).hatchTraj << endl;
-		#endif
-		it = std::find(tlValues.begin(), tlValues.end(), (*r).hatchTraj);
-		if (it != tlValues.end())
-		{	// this trajectory# already exists in tl.  Add the region# to that trajectory's region list
-			index = std::distance(tlValues.begin(), it);
-			tl[index].trajRegions.push_back(std::distance(L.s.rList.begin(), r));
-			tl[index].trajRegionTypes.push_back("hatch");
-			tl[index].trajRegionTags.push_back((*r).tag);
-			tl[index].trajRegionIsHatched.push_back(false);
-			tl[index].trajRegionLinks.push_back(&*r);
+			// See if trajNum exists in tl.  If not, create a new trajectory entry
+			auto found = tlIndex.emplace(trajNum, tl.size());
+			if (found.second)
+			{
+				tl.emplace_back();
+				tl.back().trajectoryNum = trajNum;
+				#if printTrajectories
+					cout << "  Defined trajectory number " << trajNum << endl;
+				#endif
+			}
+			size_t index = found.first->second;
+			trajectory &t = tl[index];
+			// Add the region# to that trajectory's region list, and to the group of regions with the same type and tag
+			t.trajRegions.push_back(r);
+			t.trajRegionTypes.push_back(type);
+			t.trajRegionTags.push_back(rg.tag);
+			t.trajRegionLinks.push_back(&rg);
+			auto group = groupIndex.emplace(regionGroupKey{ index, type, rg.tag }, t.regionGroups.size());
+			if (group.second)
+			{
+				regionGroup g;
+				g.type = type;
+				g.tag = rg.tag;
+				auto p = profileIndex.find(rg.tag);
+				if (p != profileIndex.end()) { g.profile = p->second; }
+				t.regionGroups.push_back(move(g));
+			}
+			t.regionGroups[group.first->second].regions.push_back(r);
 			#if printTrajectories
-				cout << "  Added region " << std::distance((*L).s.rList.begin(), r) << " to trajectory " << tl[index].trajectoryNum << endl;
+				cout << "  Added region " << r << " to trajectory " << t.trajectoryNum << endl;
 			#endif
 		}
-		else
-		{	// r.hatchTraj not found; create new trajectory entry.
-			// first add the new trajectory# to the list of trajectories
-			tlValues.push_back((*r).hatchTraj);
-			t.trajectoryNum = (*r).hatchTraj;
-			t.trajRegions.clear();
-			t.trajRegionTypes.clear();
-			t.trajRegionTags.clear();
-			t.trajRegionIsHatched.clear();
-			t.trajRegionLinks.clear();
-			t.trajRegions.push_back(std::distance(L.s.rList.begin(), r));
-			t.trajRegionTypes.push_back("hatch");
-			t.trajRegionTags.push_back((*r).tag);
-			t.trajRegionIsHatched.push_back(false);
-			t.trajRegionLinks.push_back(&*r);
-			tl.push_back(t);
-			#if printTrajectories
-				cout << "  Defined trajectory number " << t.trajectoryNum << endl;
-			#endif
-		}  // end else hatchTraj
 	}  // end for r
 	
 	// 3. After generating tl, match each trajectory# to a processing instruction in trajProcList, or assign "sequential" if not found
@@ -308,8 +296,9 @@ vector<trajectory> identifyTrajectories(AMconfig &configData, layer &L, int laye
 }
 
 
-void createSCANxmlFile(string fullXMLpath, int layerNum, AMconfig &configData, vector<trajectory> &trajectoryList)
+void createSCANxmlFile(string fullXMLpath, int layerNum, AMconfig &configData, vector<trajectory> &trajectoryList, const string &headerComment)
 {
+	TIME_STAGE("createSCANxmlFile");
 	// 1. initialization and setup
 
 	// Define temporary variables
@@ -327,11 +316,15 @@ void createSCANxmlFile(string fullXMLpath, int layerNum, AMconfig &configData, v
 	// Create processing instruction and comment elements.
 	CHK_HR(CreateAndAddPINode(pXMLDomScan, L"xml", L"version='1.0'"));
 	CHK_HR(CreateAndAddCommentNode(pXMLDomScan, L"Scan file created using MSXML 6.0."));
+	if (headerComment != "") {
+		// e.g. the estimated scan time for this layer
+		wstring wsComment(headerComment.begin(), headerComment.end());
+		CHK_HR(CreateAndAddCommentNode(pXMLDomScan, wsComment.c_str()));
+	}
 	// Create the root element, which will be called Layer and is linked by pRoot
 	CHK_HR(CreateElement(pXMLDomScan, L"Layer", &pRoot));
 
 	// 2. Add the header to XML
-	// TO DO:  add the comment that indicates min / max values across the build(TBD)
 	addXMLheader(pRoot, layerNum, configData.layerThickness_mm, configData.dosingFactor);
 	
 	// 3. Add the velocity profile list to XML
@@ -914,24 +907,20 @@ CleanUp:
 
 void scan2SVG(string fn, vector<trajectory> &tList, int dim, double mag, double xo, double yo)
 {
-	svg::Dimensions dimensions(dim, dim);
-	svg::Document doc(fn, svg::Layout(dimensions, svg::Layout::TopLeft));
-	int numTrajectories = tList.size();
+	TIME_STAGE("scan2SVG");
+	svgStream doc(fn, dim, dim);
 	vertex s, f;
 	double sx, sy, fx, fy;
-	int flip = 0;
-	int start = 0;
 
-	// iterate over all trajectories
-	for (int t = 0; t != numTrajectories; ++t)
+	// iterate over all trajectories.  Each path is drawn as one SVG element, in which consecutive marks form polylines
+	for (size_t t = 0; t < tList.size(); ++t)
 	{
-		for (int i = 0; i < (int)(tList[t].vecPath).size(); i++)
+		for (size_t i = 0; i < tList[t].vecPath.size(); i++)
 		{
-			vector<segment> SP = (tList[t].vecPath[i]).vecSg;
-			string type = (tList[t].vecPath[i]).type;
-			string tag = (tList[t].vecPath[i]).tag;
+			const vector<segment> &SP = tList[t].vecPath[i].vecSg;
+			if (SP.empty()) { continue; }
 			s = SP[0].start;
-			for (vector<segment>::iterator it = SP.begin(); it != SP.end(); ++it)
+			for (vector<segment>::const_iterator it = SP.begin(); it != SP.end(); ++it)
 			{
 				f = (*it).end;
 				sx = s.x * mag + xo;
@@ -940,17 +929,16 @@ void scan2SVG(string fn, vector<trajectory> &tList, int dim, double mag, double
 				fy = f.y * mag + yo;
 				if ((*it).isMark == 1) // show only marks, not jumps
 				{
-					svg::Line line(svg::Point(sx, dim - sy), svg::Point(fx, dim - fy), svg::Stroke(0.25, svg::Color::Black));
-					doc << line;
+					doc.line(sx, dim - sy, fx, dim - fy, "black", 0.25);
 				}
-				//else { cout << "encounteredJump" << endl; }  // testing purposes
 				s = f;
 			}
+			doc.endPath();
 		}
 	}
 
-	doc.save();
-};
+	doc.close();
+}
 
 PCWSTR d2lp(double in)
 {
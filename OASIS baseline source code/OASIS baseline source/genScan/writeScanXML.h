@@ -22,12 +22,10 @@ data structure to an xml file.
 #ifndef WRITEXML_H
 #define WRITEXML_H
 #include <vector>
-#include <msxml6.h>
+#include "xmlDOM.h"
 #include "ScanPath.h"
 #include "readLayerXML.h"
-#include <comdef.h>
 #include <string>
-#include <windows.h>
 
 #include "readExcelConfig.h"
 
@@ -81,11 +79,10 @@ HRESULT CreateAndAddElementNode(IXMLDOMDocument *pDom, PCWSTR wszName, PCWSTR ws
 // Identify the trajectory numbers in a particular layer and the regions within each trajectory
 vector<trajectory> identifyTrajectories(AMconfig &configData, layer &L, int layerNum);
 
-// Manage the creation and writing of an XML SCAN file
-void createSCANxmlFile(string fullXMLpath, int layerNum, AMconfig &configData, vector<trajectory> &trajectoryList);
+// Manage the creation and writing of an XML SCAN file.  headerComment, if given, is added as a comment ahead of the Layer element
+void createSCANxmlFile(string fullXMLpath, int layerNum, AMconfig &configData, vector<trajectory> &trajectoryList, const string &headerComment = "");
 
 // Create file header for XML SCAN file.
-// TO DO:  generate min/max values to be included in header comment or other field
 void addXMLheader(IXMLDOMElement *pRoot, int layerNum, double thickness, double dosingfactor);
 
 // Create the velocity profile list section for an XML SCAN file
@@ -99,6 +96,7 @@ void addXMLtrajectory(IXMLDOMElement *trajList, trajectory &T);
 
 // Write scan output in SVG format.
 // Takes as input the output filename, a trajectory set and the dimensions of the SVG file
+// The marks of each path are streamed to the file as polylines (see svgStream.h)
 void scan2SVG(string fn, vector<trajectory> &tList, int dim, double mag, double xo, double yo);
 
 LPCWSTR d2lp(double in);
@@ -18,7 +18,9 @@ This file contains functions to read and write to XML-style Excel
 files, identified by .xls extension (rather than the current .xlsx)
 
 The current project uses only the read function and none of the 
-file creation or write functions
+file creation or write functions.  Configuration files are read via
+BasicExcel::LoadWorksheets, a read-only addition to the original package
+which memory-maps the workbook and decodes only the requested tabs
 
 Note several major limitations of this package:
 	- only handles .xls, not .xlsx format
@@ -26,6 +28,21 @@ Note several major limitations of this package:
 	- does not properly read fields containing functions.  All input fields must be hard coded
 //============================================================*/
 
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+#include <cstring>
 #include "BasicExcel.hpp"
 
 namespace YCompoundFiles
@@ -34,7 +51,7 @@ namespace YCompoundFiles
 // PURPOSE: Manage a file by treating it as blocks of data of a certain size.
 Block::Block() : 
 	blockSize_(512), fileSize_(0), indexEnd_(0),
-	filename_(0) {}
+	filename_(0), mappedData_(0), mappedFile_(0), mappedMap_(0) {}
 
 bool Block::Create(const wchar_t* filename)
 // PURPOSE: Create a new block file and open it.
@@ -93,10 +110,80 @@ bool Block::Open(const wchar_t* filename, ios_base::openmode mode)
 	return true;
 }
 
+bool Block::OpenMapped(const wchar_t* filename)
+// PURPOSE: Open an existing block file read-only as a memory-mapped view.
+// EXPLAIN: Read() then copies blocks straight out of the view instead of seeking and reading the stream,
+// EXPLAIN: and the OS only pages in the blocks which are actually referenced.
+// PROMISE: Return true if file is successfully mapped, false if otherwise.
+{
+	Close();
+#ifdef _WIN32
+	HANDLE hFile = CreateFileW(filename, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) return false;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(hFile, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+	HANDLE hMap = CreateFileMappingW(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (hMap == NULL)
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+	const char* view = (const char*)MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0);
+	if (view == NULL)
+	{
+		CloseHandle(hMap);
+		CloseHandle(hFile);
+		return false;
+	}
+	mappedFile_ = hFile;
+	mappedMap_ = hMap;
+	fileSize_ = (size_t)size.QuadPart;
+#else
+	size_t filenameLength = wcslen(filename);
+	vector<char> name(filenameLength*MB_CUR_MAX+1, 0);
+	wcstombs(&*(name.begin()), filename, name.size()-1);
+	int fd = open(&*(name.begin()), O_RDONLY);
+	if (fd < 0) return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+	void* view = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);	// the mapping keeps its own reference to the file
+	if (view == MAP_FAILED) return false;
+	fileSize_ = (size_t)st.st_size;
+#endif
+	mappedData_ = (const char*)view;
+	mode_ = ios_base::in;
+
+	// Calculate last index + 1
+	indexEnd_ = fileSize_/blockSize_ + (fileSize_ % blockSize_ ? 1 : 0);
+	return true;
+}
+
 bool Block::Close()
 // PURPOSE: Close the opened block file.
 // PROMISE: Return true if file is successfully closed, false if otherwise.
 {
+	if (mappedData_)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(mappedData_);
+		CloseHandle((HANDLE)mappedMap_);
+		CloseHandle((HANDLE)mappedFile_);
+#else
+		munmap((void*)mappedData_, fileSize_);
+#endif
+		mappedData_ = 0;
+		mappedFile_ = 0;
+		mappedMap_ = 0;
+	}
 	file_.close();
 	file_.clear();
 	filename_.clear(); 
@@ -110,7 +197,7 @@ bool Block::IsOpen()
 // PURPOSE: Check if the block file is still opened.
 // PROMISE: Return true if file is still opened, false if otherwise.
 {
-	return file_.is_open();
+	return mappedData_ != 0 || file_.is_open();
 }
 
 bool Block::Read(size_t index, char* block)
@@ -119,6 +206,16 @@ bool Block::Read(size_t index, char* block)
 // PROMISE: Return true if data are successfully read, false if otherwise.
 {
 	if (!(mode_ & ios_base::in)) return false;
+	if (mappedData_)
+	{
+		if (index >= indexEnd_) return false;
+		// A short final block is zero-padded to the full block size
+		size_t offset = index * blockSize_;
+		size_t available = (fileSize_ - offset < blockSize_) ? fileSize_ - offset : blockSize_;
+		memcpy(block, mappedData_ + offset, available);
+		if (available < blockSize_) memset(block + available, 0, blockSize_ - available);
+		return true;
+	}
 	if (index < indexEnd_)
 	{
 		file_.seekg(index * blockSize_);
@@ -512,6 +609,27 @@ bool CompoundFile::Open(const wchar_t* filename, ios_base::openmode mode)
 	return true;
 }
 
+bool CompoundFile::OpenMapped(const wchar_t* filename)
+// PURPOSE: Open an existing compound file read-only through a memory-mapped view.
+// PROMISE: Return true if file is successfully opened, false if otherwise.
+{
+	Close();
+	if (!file_.OpenMapped(filename)) return false;
+
+	// Load header
+	if (!LoadHeader()) return false;
+
+	// Load BAT information
+	LoadBAT();
+
+	// Load properties
+	propertyTrees_ = new PropertyTree;
+	LoadProperties();
+	currentDirectory_ = propertyTrees_;
+
+	return true;
+}
+
 bool CompoundFile::Close()
 // PURPOSE: Close the opened compound file.
 // PURPOSE: Reset BAT indices, SBAT indices, properties and properties tree information.
@@ -934,6 +1052,17 @@ bool CompoundFile::Open(const char* filename, ios_base::openmode mode)
 	return ret;
 }
 
+bool CompoundFile::OpenMapped(const char* filename)
+{
+	size_t filenameLength = strlen(filename);
+	wchar_t* wname = new wchar_t[filenameLength+1];
+	mbstowcs(wname, filename, filenameLength);
+	wname[filenameLength] = 0;
+	bool ret = OpenMapped(wname);
+	delete[] wname;
+	return ret;
+}
+
 int CompoundFile::ChangeDirectory(const char* path)
 {
 	size_t pathLength = strlen(path);
@@ -4494,8 +4623,8 @@ bool CanStoreAsRKValue(double value)
 /************************************************************************************************************/
 
 /************************************************************************************************************/
-BasicExcel::BasicExcel() {};
-BasicExcel::BasicExcel(const char* filename) 
+BasicExcel::BasicExcel() : usedRangeOnly_(false) {};
+BasicExcel::BasicExcel(const char* filename) : usedRangeOnly_(false)
 {
 	Load(filename);
 }
@@ -4508,6 +4637,7 @@ BasicExcel::~BasicExcel()
 // Create a new Excel workbook with a given number of spreadsheets (Minimum 1)
 void BasicExcel::New(int sheets)
 {
+	usedRangeOnly_ = false;
 	workbook_ = Workbook();
 	worksheets_.clear();
 
@@ -4527,6 +4657,7 @@ bool BasicExcel::Load(const char* filename)
 	if (file_.IsOpen()) file_.Close();
 	if (file_.Open(filename))
 	{
+		usedRangeOnly_ = false;
 		workbook_ = Workbook();
 		worksheets_.clear();
 
@@ -4539,6 +4670,73 @@ bool BasicExcel::Load(const char* filename)
 	else return false;
 }
 
+// Returns true if a BOUNDSHEET name matches one of the requested (ANSI) sheet names.
+static bool IsRequestedSheet(const SmallString& name, const vector<string>& sheetNames)
+{
+	size_t maxNames = sheetNames.size();
+	for (size_t i=0; i<maxNames; ++i)
+	{
+		const string& wanted = sheetNames[i];
+		if (!(name.unicode_ & 1))
+		{
+			if (name.name_ && wanted == name.name_) return true;
+		}
+		else if (name.wname_)
+		{
+			size_t j = 0;
+			while (j < wanted.size() && name.wname_[j] == (wchar_t)(unsigned char)wanted[j]) ++j;
+			if (j == wanted.size() && name.wname_[j] == L'\0') return true;
+		}
+	}
+	return false;
+}
+
+// Read-only load of the named worksheets from a memory-mapped workbook.
+// Only the workbook globals (sheet directory, shared strings) and the requested sheets are decoded; the BOF offset
+// stored in each BOUNDSHEET record is used to jump straight to a requested sheet, so unused sheets, charts and VB
+// modules are never parsed.  Every bound sheet still gets a (possibly empty) Worksheet so that indices line up for GetWorksheet.
+bool BasicExcel::LoadWorksheets(const char* filename, const vector<string>& sheetNames)
+{
+	if (file_.IsOpen()) file_.Close();
+	if (!file_.OpenMapped(filename)) return false;
+
+	usedRangeOnly_ = true;
+	workbook_ = Workbook();
+	worksheets_.clear();
+	yesheets_.clear();
+
+	vector<char> data;
+	file_.ReadFile("Workbook", data);
+	if (data.size() < 4) return false;
+	const char* stream = &*(data.begin());
+
+	// The workbook globals substream always comes first
+	short code;
+	BOF bof;
+	LittleEndian::Read(stream, code, 0, 2);
+	if (code != CODE::BOF) return false;
+	bof.Read(stream);
+	if (bof.type_ != WORKBOOK_GLOBALS) return false;
+	workbook_.Read(stream);
+
+	size_t maxBoundSheets = workbook_.boundSheets_.size();
+	worksheets_.resize(maxBoundSheets);
+	for (size_t i=0; i<maxBoundSheets; ++i)
+	{
+		if (!IsRequestedSheet(workbook_.boundSheets_[i].name_, sheetNames)) continue;
+
+		size_t pos = (size_t)workbook_.boundSheets_[i].BOFpos_;
+		if (workbook_.boundSheets_[i].BOFpos_ < 0 || pos + 4 > data.size()) continue;
+		LittleEndian::Read(stream, code, (int)pos, 2);
+		if (code != CODE::BOF) continue;
+		bof.Read(stream+pos);
+		if (bof.type_ != WORKSHEET) continue;
+		worksheets_[i].Read(stream+pos);
+	}
+	UpdateYExcelWorksheet();
+	return true;
+}
+
 // Save current Excel workbook to opened file.
 bool BasicExcel::Save()
 {
@@ -4570,6 +4768,7 @@ bool BasicExcel::Save()
 // Save current Excel workbook to a file.
 bool BasicExcel::SaveAs(const char* filename)
 {
+	if (usedRangeOnly_) return false;	// a partial (LoadWorksheets) workbook cannot be written back
 	if (file_.IsOpen()) file_.Close();
 
 	if (!file_.Create(filename)) return false;
@@ -5616,6 +5815,40 @@ void BasicExcelWorksheet::UpdateCells()
 
 	maxRows_ = dimension.lastUsedRowIndexPlusOne_;
 	maxCols_ = dimension.lastUsedColIndexPlusOne_;
+	if (excel_->usedRangeOnly_)
+	{
+		// Size to the cells which actually hold values.  Formatted but empty (BLANK/MULBLANK) cells can
+		// stretch DIMENSIONS to the bottom of a template sheet; Cell() still grows the matrix on demand.
+		maxRows_ = 0;
+		maxCols_ = 0;
+		size_t maxRowBlocks = rRowBlocks.size();
+		for (size_t i=0; i<maxRowBlocks; ++i)
+		{
+			vector<Worksheet::CellTable::RowBlock::CellBlock>& rCellBlocks = rRowBlocks[i].cellBlocks_;
+			size_t maxCells = rCellBlocks.size();
+			for (size_t j=0; j<maxCells; ++j)
+			{
+				size_t lastCol;
+				switch (rCellBlocks[j].type_)
+				{
+					case CODE::BOOLERR:
+					case CODE::LABELSST:
+					case CODE::NUMBER:
+					case CODE::RK:
+						lastCol = rCellBlocks[j].ColIndex();
+						break;
+					case CODE::MULRK:
+						lastCol = rCellBlocks[j].mulrk_.lastColIndex_;
+						break;
+					default:
+						continue;
+				}
+				size_t row = rCellBlocks[j].RowIndex();
+				if (row+1 > maxRows_) maxRows_ = row+1;
+				if (lastCol+1 > maxCols_) maxCols_ = lastCol+1;
+			}
+		}
+	}
 
 	// Resize the cells to the size of the worksheet
 	vector<BasicExcelCell> cellCol(maxCols_);
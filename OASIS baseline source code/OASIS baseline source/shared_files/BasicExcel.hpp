@@ -58,6 +58,7 @@
 #include <iomanip>
 #include <fstream>
 #include <map>
+#include <string>
 #include <vector>
 using namespace std;
 
@@ -79,6 +80,7 @@ public:
 // File handling functions
 	bool Create(const wchar_t* filename);
 	bool Open(const wchar_t* filename, ios_base::openmode mode=ios_base::in | ios_base::out);
+	bool OpenMapped(const wchar_t* filename);
 	bool Close();
 	bool IsOpen();
 
@@ -106,6 +108,9 @@ protected:
 	size_t blockSize_;
 	size_t indexEnd_;
 	size_t fileSize_;
+	const char* mappedData_;	// start of the read-only file view when opened with OpenMapped, else 0
+	void* mappedFile_;			// platform file/mapping handles owned by the view (see OpenMapped)
+	void* mappedMap_;
 };
 
 struct LittleEndian
@@ -257,6 +262,7 @@ public:
 	// Compound File functions
 	bool Create(const wchar_t* filename);
 	bool Open(const wchar_t* filename, ios_base::openmode mode=ios_base::in | ios_base::out);
+	bool OpenMapped(const wchar_t* filename);	// read-only, memory-mapped open
 	bool Close();
 	bool IsOpen();
 
@@ -282,6 +288,7 @@ public:
 	// ANSI char functions
 	bool Create(const char* filename);
 	bool Open(const char* filename, ios_base::openmode mode=ios_base::in | ios_base::out);
+	bool OpenMapped(const char* filename);
 	int ChangeDirectory(const char* path);
 	int MakeDirectory(const char* path);
 	int PresentWorkingDirectory(char* path);
@@ -1123,6 +1130,7 @@ public:
 public: // File functions.
 	void New(int sheets=3);	///< Create a new Excel workbook with a given number of spreadsheets (Minimum 1).
 	bool Load(const char* filename);	///< Load an Excel workbook from a file.
+	bool LoadWorksheets(const char* filename, const vector<string>& sheetNames);	///< Read-only load of a memory-mapped workbook which decodes only the named worksheets, sized to their used cell ranges. Other sheets are present but empty. Do not Save/SaveAs afterwards.
 	bool Save();	///< Save current Excel workbook to opened file.
 	bool SaveAs(const char* filename);	///< Save current Excel workbook to a file.
 
@@ -1167,6 +1175,7 @@ private: // Internal functions
 	void UpdateWorksheets();		///< Update worksheets_ using information from yesheets_.
 
 public:
+	bool usedRangeOnly_;					///< True after LoadWorksheets; worksheets are sized to cells holding values rather than to their DIMENSIONS record.
 	CompoundFile file_;						///< Compound file handler.
 	Workbook workbook_;						///< Raw Workbook.
 	vector<Worksheet> worksheets_;			///< Raw Worksheets.
@@ -19,7 +19,9 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 // Including SDKDDKVer.h defines the highest available Windows platform.
 // If you wish to build your application for a previous Windows platform, include WinSDKVer.h and
 // set the _WIN32_WINNT macro to the platform you wish to support before including SDKDDKVer.h.
+#ifdef _WIN32
 #include <SDKDDKVer.h>
+#endif
 
 #include <string>
 
@@ -38,10 +40,30 @@ static const int scanCoordPrecision = 3;
 // Intricate STL files require high LAYER-file resolution to avoid artifacts which will crop up later in SCAN generation.
 // Six digits appears to be the minimum which works for any layer file, whereas just three digits is fine for scan files
 
-static const int numLayersPerCall = 25;
-// number of layers to be processed per call to genLayer.exe or genScan.exe
-// Increasing this number will increase memory requirements between calls, 
-// but fewer calls will make it run faster.  For large files, memory usage increases linearly with layer count
+static const int svgCoordPrecision = 2;
+static const size_t svgBufferSize = 1 << 20;
+// SVG files are streamed to disk through a buffer of svgBufferSize bytes, with coordinates (pixels) rounded to
+// svgCoordPrecision decimal places.  Lines that meet after rounding are joined into one polyline
+
+static const double layerMemoryBudget_MB = 1024.0;
+static const double layerMemorySafetyFactor = 1.5;
+static const int maxLayersPerCall = 1000;
+// genLayer.exe and genScan.exe process layers until their working set plus layerMemorySafetyFactor times the largest
+// per-layer cost seen so far would exceed layerMemoryBudget_MB, then return so createScanpaths can relaunch them (see memoryBudget.h).
+// At least one layer and at most maxLayersPerCall layers are processed per call.  Small parts run in very few calls,
+// while large lattice layers are split into smaller batches.  The batch sizes chosen are listed in the run report
+
+#ifdef _WIN32
+static const string slic3rExecutable = "slic3r_130\\slic3r.exe";
+#else
+static const string slic3rExecutable = "slic3r_130/Slic3r";
+#endif
+// location of the Slic3r 1.3.0 executable (or launcher script), relative to the folder containing genLayer
+
+#ifndef _WIN32
+static const string zipExecutable = "/usr/bin/zip";
+#endif
+// command-line zip tool used by createScanpaths to build the .scn archive.  Windows builds use zip.cpp instead
 
 static const bool outputCoordSystem = false;
 // if true, genLayer will indicate the coordinate system ("Cartesian") for every single vertex in layer XML files
@@ -52,6 +74,51 @@ static const bool outputCoordSystem = false;
 // in which case the file will be created in the same folder as generateScanpaths.exe
 static const string errorReportFilename = "ALSAM_Scanpath_errors.txt";
 
+// names of the files created in the project folder when stage timing is enabled (see STAGETIMING in runReport.h).
+// genLayer and genScan append raw timing samples and per-layer counts to runSamplesFilename on every call;
+// createScanpaths summarizes them into runReportFilename (JSON) and then deletes the samples file
+static const string runSamplesFilename = "run_samples.txt";
+static const string runReportFilename = "run_report.json";
+
+// name of the Chrome trace-event file created in the project folder when TRACEEVENTS is set (see traceEvents.h)
+static const string traceFilename = "scanpath_trace.json";
+
+// name of the subfolder of the layer and scan output folders which holds per-shard manifests (see shardManifest.h)
+static const string shardFolderName = "shards";
+
+// name of the CSV file in the scan output folder which lists the estimated scan time of each layer (see scanTime.h)
+static const string scanTimeFilename = "scan_time_estimate.csv";
+
+// skywriting (modes 1-3 on RTC5 cards) replaces the laser-on/off and mark delays at the ends of a mark with acceleration
+// run-in and run-out moves.  Their length is set on the scan card rather than in the configuration file, so the scan
+// time estimate charges these typical values, in microseconds
+static const double skywritingRunIn_us = 100.0;
+static const double skywritingRunOut_us = 100.0;
+
+// the path ordering stage (see pathOrder.h) improves a tour of contour rings or region groups for at most
+// pathOrderMaxPasses passes and, if pathOrderBudget_ms is above 0, at most that many milliseconds per tour.
+// With the time limit at 0 the same config and layer files give the same scan order on every machine
+static const int pathOrderMaxPasses = 50;
+static const double pathOrderBudget_ms = 0.0;
+
+// hatchOPT with tour refinement (hatch scheme 3) improves the order and direction of its hatch islands for at most
+// hatchRefineMaxPasses passes and, if hatchRefineBudget_ms is above 0, at most that many milliseconds per path.
+// With the time limit at 0 the output is identical on every run, however fast the machine
+static const int hatchRefineMaxPasses = 50;
+static const double hatchRefineBudget_ms = 0.0;
+
+// island hatching (hatch scheme 4, see islandHatch.h) uses islands of this width, in mm, when a region profile gives none.
+// Islands are hatched on one worker thread per islandsPerThread islands, up to the number of cores, and scanned so that
+// consecutive islands are islandScanStride squares apart
+static const double defaultIslandSize = 5.0;
+static const size_t islandsPerThread = 16;
+static const long long islandScanStride = 3;
+
+// stripe hatching (hatch scheme 5) uses stripes of this width, in mm, when a region profile gives none.  Stripes are
+// hatched on one worker thread per stripesPerThread stripes, up to the number of cores
+static const double defaultStripeWidth = 10.0;
+static const size_t stripesPerThread = 2;
+
 // intersectRange defines how "close enough" an edge must be to a hatch line be to be considered intersecting, in mm.
 // This allows a small amount of leeway in findIntersection (between hatches & edges) due to floating point precision
 static const double intersectRange = 0.00002;
@@ -22,6 +22,7 @@ It is utilized by all three projects within the ALSAM3024 solution
 
 #include "errorChecks.h"
 #include "constants.h"
+#include "platform.h"
 
 // Function to check configuration-file for errors.
 // Should be called after reading the file into an AMconfig structure.
@@ -54,6 +55,31 @@ void evaluateConfigFile(AMconfig &configData, errorCheckStructure &errorData)
 	// Evaluate config-file tabs in reverse order, because lists such as segment styles were concatenated as the tabs were read,
 	// which means that the elements from later tabs can't be differentiated from earlier tabs unless we check in reverse
 
+	//*** 9. Laser checks:  (if any are present)
+	//	laser IDs are unique
+	//	each laser ID is the traveler ID of at least one segment style
+	//	no field has a min limit above its max
+	for (size_t i = 0; i < configData.laserList.size(); i++) {
+		const laserField &laser = configData.laserList[i];
+		for (size_t j = 0; j < i; j++) {
+			if (laser.laserID == configData.laserList[j].laserID) {
+				updateErrorResults(errorData, haltNow, "evaluateConfigFile", "Laser " + laser.laserID + " is listed more than once on tab 9", "", configData.configFilename, configData.configPath);
+			}
+		}
+		bool usedByStyle = false;
+		for (size_t s = 0; s < configData.segmentStyleList.size(); s++) {
+			if ((configData.segmentStyleList[s].leadLaser.travelerID == laser.laserID) || (configData.segmentStyleList[s].trailLaser.travelerID == laser.laserID)) {
+				usedByStyle = true;
+			}
+		}
+		if (!usedByStyle) {
+			updateErrorResults(errorData, haltNow, "evaluateConfigFile", "Laser " + laser.laserID + " on tab 9 is not the lead or trail laser of any segment style on tab 4", "", configData.configFilename, configData.configPath);
+		}
+		if ((laser.xMin > laser.xMax) || (laser.yMin > laser.yMax)) {
+			updateErrorResults(errorData, haltNow, "evaluateConfigFile", "Laser " + laser.laserID + " on tab 9 has a min limit above its max", "", configData.configFilename, configData.configPath);
+		}
+	}
+
 	//*** 8. Single-stripe checks:  (if any are present)
 	//	jump velocity profile exists
 	//  all ss's exist
@@ -193,7 +219,7 @@ void evaluateConfigFile(AMconfig &configData, errorCheckStructure &errorData)
 			}
 		}
 		if (configData.regionProfileList[i].hatchStyleID != "") {
-			// hatch checks: hatch spacing > 0; hatch offset >=0; skywriting mode >=0
+			// hatch checks: hatch spacing > 0; hatch offset >=0; skywriting mode >=0; island size > 0 for island hatching; stripe width > 0 and overlap >=0 for stripe hatching
 			if (configData.regionProfileList[i].resHatch <= 0) {
 				updateErrorResults(errorData, haltNow, "evaluateConfigFile", "Hatch spacing <= 0 for region " + configData.regionProfileList[i].Tag, "", configData.configFilename, configData.configPath);
 			}
@@ -203,6 +229,15 @@ void evaluateConfigFile(AMconfig &configData, errorCheckStructure &errorData)
 			if (configData.regionProfileList[i].hatchSkywriting < 0) {
 				updateErrorResults(errorData, haltNow, "evaluateConfigFile", "Hatch skywriting mode is <0, not a recognized mode, for region " + configData.regionProfileList[i].Tag, "", configData.configFilename, configData.configPath);
 			}
+			if ((configData.regionProfileList[i].scHatch == 4) && (configData.regionProfileList[i].islandSize <= 0)) {
+				updateErrorResults(errorData, haltNow, "evaluateConfigFile", "Island size <= 0 for region " + configData.regionProfileList[i].Tag, "", configData.configFilename, configData.configPath);
+			}
+			if ((configData.regionProfileList[i].scHatch == 5) && (configData.regionProfileList[i].stripeWidth <= 0)) {
+				updateErrorResults(errorData, haltNow, "evaluateConfigFile", "Stripe width <= 0 for region " + configData.regionProfileList[i].Tag, "", configData.configFilename, configData.configPath);
+			}
+			if ((configData.regionProfileList[i].scHatch == 5) && (configData.regionProfileList[i].stripeOverlap < 0)) {
+				updateErrorResults(errorData, haltNow, "evaluateConfigFile", "Stripe overlap < 0 for region " + configData.regionProfileList[i].Tag, "", configData.configFilename, configData.configPath);
+			}
 		}
 	}
 	
@@ -277,6 +312,9 @@ void evaluateConfigFile(AMconfig &configData, errorCheckStructure &errorData)
 	if (configData.dosingFactor < 1.0) {
 		updateErrorResults(errorData, haltNow, "evaluateConfigFile", "Dosing factor is < 1.0 on config file tab 2", "", configData.configFilename, configData.configPath);
 	}
+	if (configData.simplifyTolerance_um < 0) {
+		updateErrorResults(errorData, haltNow, "evaluateConfigFile", "Outline simplification tolerance is < 0 on config file tab 2", "", configData.configFilename, configData.configPath);
+	}
 	
 	// REVIEW WORD DOC FOR ANY ADDITIONAL CHECKS
 }
@@ -305,7 +343,7 @@ void updateErrorResults(errorCheckStructure &errorData, bool haltNow, string fun
 		cout << "Execution will be cancelled" << endl;
 
 		// attempt to write findings to error file in the config folder
-		string fullErrFilepath = configPath + "\\" + errorReportFilename;
+		string fullErrFilepath = configPath + pathSep + errorReportFilename;
 		ofstream errFile(fullErrFilepath.c_str());
 		if (!errFile) {
 			// Could not open the error output file
@@ -316,10 +354,7 @@ void updateErrorResults(errorCheckStructure &errorData, bool haltNow, string fun
 			cout << "See " << fullErrFilepath.c_str() << " for more information" << endl;
 			errFile << "ALSAM scanpath-generation error report\n";
 			// List config filename and current timestamp in the file
-			time_t now = time(0);
-			char str[26];
-			ctime_s(str, sizeof str, &now);   // convert time to string form
-			errFile << str << endl;
+			errFile << timestampString() << endl;
 			errFile << "Configuration file: " << configFilename << "\n\nError(s) identified:\n";
 			for (int x = 0; x < errorData.fullErrorList.size(); x++) {
 				errFile << errorData.fullErrorList[x].c_str() << endl;
@@ -327,7 +362,7 @@ void updateErrorResults(errorCheckStructure &errorData, bool haltNow, string fun
 			errFile.close();
 		}
 		// halt or quit execution
-		system("pause");
+		pauseForUser();
 		exit(-1);
 	}
 }
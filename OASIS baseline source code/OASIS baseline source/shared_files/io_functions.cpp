@@ -21,34 +21,12 @@ used by createScanpaths.cpp and/or supportFunctions.cpp
 #include "readExcelConfig.h"
 
 using namespace std;
-namespace fs = std::experimental::filesystem;
 
 
-COORD GetConsoleCursorPosition(HANDLE hConsoleOutput)
-{
-	CONSOLE_SCREEN_BUFFER_INFO cbsi;
-	if (GetConsoleScreenBufferInfo(hConsoleOutput, &cbsi))
-	{
-		return cbsi.dwCursorPosition;
-	}
-	else
-	{
-		// The function failed. Call GetLastError() for details.
-		COORD invalid = { 0, 0 };
-		return invalid;
-	}
-}
-
 bool dirExists(const std::string& dirName_in)
 {
-	DWORD ftyp = GetFileAttributesA(dirName_in.c_str());
-	if (ftyp == INVALID_FILE_ATTRIBUTES)
-		return false;  //something is wrong with your path!
-
-	if (ftyp & FILE_ATTRIBUTE_DIRECTORY)
-		return true;   // this is a directory!
-
-	return false;    // this is not a directory!
+	error_code ec;
+	return fs::is_directory(dirName_in, ec);  // false if the path is missing, inaccessible or not a directory
 }
 
 double find_max(vector<double>in)
@@ -84,6 +62,7 @@ sts readStatus(string filename)
 		s.lastLayer = 0;
 		s.finished = 0;
 		s.dn = "NULL";
+		s.layerCostMB = 0.0;
 	}
 	else
 	{
@@ -96,6 +75,7 @@ sts readStatus(string filename)
 		s.finished = atoi(line.c_str());
 		getline(file, line);
 		s.dn = line;
+		if (getline(file, line)) { s.layerCostMB = atof(line.c_str()); }
 	}
 	return s;
 }
@@ -122,6 +102,8 @@ fileCount countLayerFiles(string path)
 				if (has_only_digits(fname2))
 				{
 					output.numFiles += 1;
+					if ((int)fname2.size() > output.numDigits)
+						output.numDigits = fname2.size();
 					if (atoi(fname2.c_str()) < output.minLayer)
 						output.minLayer = atoi(fname2.c_str());
 					if (atoi(fname2.c_str()) > output.maxLayer)
@@ -150,6 +132,8 @@ fileCount countScanFiles(string path)
 				if (has_only_digits(fname2))
 				{
 					output.numFiles += 1;
+					if ((int)fname2.size() > output.numDigits)
+						output.numDigits = fname2.size();
 					if (atoi(fname2.c_str()) < output.minLayer)
 						output.minLayer = atoi(fname2.c_str());
 					if (atoi(fname2.c_str()) > output.maxLayer)
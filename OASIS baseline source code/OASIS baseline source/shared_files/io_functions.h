@@ -24,16 +24,12 @@ to manipulate the user inputs through CSV files
 #include <string>
 #include <stdlib.h>
 #include <stdio.h>
-#include <msxml6.h>
-#include <comdef.h>
-#include <tchar.h>
-#include <conio.h>
 #include <sstream>
 #include <fstream>
 #include <math.h>
-#include <filesystem>
 
 #include "readExcelConfig.h"
+#include "platform.h"
 
 // structure to read/write the genLayer or genScan *.cfg file to get information about the last layer proessed, if any
 struct sts
@@ -42,11 +38,9 @@ struct sts
 	int lastLayer;	// last layer number done in the current call
 	int finished;	// whether part is finished
 	string dn = "NULL";	// directory of the config file
+	double layerCostMB = 0.0;	// largest per-layer memory cost seen by the previous call (see memoryBudget.h)
 };
 
-//identify current cursor position, to enable it to be reset between layers
-COORD GetConsoleCursorPosition(HANDLE hConsoleOutput);
-
 //check if directory exists
 bool dirExists(const std::string& dirName_in);
 
@@ -68,6 +62,7 @@ struct fileCount
 	int numFiles = 0;
 	int minLayer = 1;
 	int maxLayer = 0;
+	int numDigits = 0;	// width of the (zero-padded) layer number in the filenames
 };
 
 //counts the number of layer xml files in a particular directory (prefaced with "layer_" and ending in .xml)
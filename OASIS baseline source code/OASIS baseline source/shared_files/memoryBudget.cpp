@@ -0,0 +1,108 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+memoryBudget.cpp contains the working-set queries and the per-layer
+memory tracker used to size each batch of layers (see memoryBudget.h)
+//============================================================*/
+
+#include "memoryBudget.h"
+#include "constants.h"
+#include "runReport.h"
+#include <algorithm>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+
+#pragma comment(lib, "psapi.lib")
+#else
+#include <fstream>
+#endif
+
+static const double bytesPerMB = 1024.0 * 1024.0;
+
+#ifdef _WIN32
+double workingSetMB()
+{
+	PROCESS_MEMORY_COUNTERS pmc;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) { return 0.0; }
+	return pmc.WorkingSetSize / bytesPerMB;
+}
+
+double peakWorkingSetMB()
+{
+	PROCESS_MEMORY_COUNTERS pmc;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) { return 0.0; }
+	return pmc.PeakWorkingSetSize / bytesPerMB;
+}
+#else
+// Linux reports the resident set (VmRSS) and its high-water mark (VmHWM) in kB in /proc/self/status
+static double procStatusMB(const string& field)
+{
+	ifstream status("/proc/self/status");
+	string key;
+	double kb;
+	while (status >> key) {
+		if (key == field + ":") {
+			if (status >> kb) { return kb / 1024.0; }
+			break;
+		}
+		status.ignore(1024, '\n');
+	}
+	return 0.0;
+}
+
+double workingSetMB()
+{
+	return procStatusMB("VmRSS");
+}
+
+double peakWorkingSetMB()
+{
+	return procStatusMB("VmHWM");
+}
+#endif
+
+memoryBudget::memoryBudget(double priorLayerCostMB) : startWorkingSetMB(0.0), startPeakMB(0.0), maxLayerCostMB(priorLayerCostMB)
+{
+}
+
+void memoryBudget::beginLayer()
+{
+	startWorkingSetMB = workingSetMB();
+	startPeakMB = peakWorkingSetMB();
+}
+
+void memoryBudget::endLayer(int layerNum)
+{
+	double endWorkingSetMB = workingSetMB();
+	double endPeakMB = peakWorkingSetMB();
+	// Windows only reports the peak over the life of the process.  If the peak rose during this layer, it is this layer's peak;
+	// otherwise the layer's own peak is unknown (but no higher than the earlier peak), so fall back to the working set at the end of the layer
+	double layerPeakMB = (endPeakMB > startPeakMB) ? endPeakMB : endWorkingSetMB;
+	double layerCost = layerPeakMB - startWorkingSetMB;
+	if (layerCost > maxLayerCostMB) { maxLayerCostMB = layerCost; }
+	COUNT_LAYER(layerNum, "peak_rss_kb", layerPeakMB * 1024.0);
+	COUNT_LAYER(layerNum, "layer_cost_kb", max(layerCost, 0.0) * 1024.0);
+}
+
+bool memoryBudget::roomForNextLayer() const
+{
+	return workingSetMB() + layerMemorySafetyFactor * maxLayerCostMB <= layerMemoryBudget_MB;
+}
+
+void memoryBudget::recordBatch(int firstLayer, int lastLayer) const
+{
+	recordLayerBatch(firstLayer, lastLayer, layerMemoryBudget_MB, peakWorkingSetMB(), maxLayerCostMB);
+}
@@ -0,0 +1,59 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+memoryBudget.h defines the per-layer memory tracker which genLayer and
+genScan use to decide how many layers to process before returning
+control to createScanpaths.
+
+Each instance is relaunched by createScanpaths until all layers are
+done, which releases any memory retained between layers.  Rather than
+a fixed number of layers per call, the tracker measures the process
+working set (RSS) around each layer and ends the batch once the next
+layer is predicted to push the process past layerMemoryBudget_MB
+(see constants.h).  The largest per-layer cost observed so far is
+passed to the next instance through the status file
+//============================================================*/
+
+#pragma once
+
+#include <string>
+
+using namespace std;
+
+// current working set (resident memory) of this process, in MB
+double workingSetMB();
+
+// highest working set reached by this process so far, in MB
+double peakWorkingSetMB();
+
+class memoryBudget
+{
+public:
+	// priorLayerCostMB is the largest per-layer cost seen by the previous instance (0 if none), read from the status file
+	explicit memoryBudget(double priorLayerCostMB);
+	// call at the start and end of each layer.  endLayer records the layer's peak RSS and cost for the run report
+	void beginLayer();
+	void endLayer(int layerNum);
+	// true if the working set plus the expected cost of one more layer fits within layerMemoryBudget_MB
+	bool roomForNextLayer() const;
+	// largest per-layer cost (MB) observed by this or the previous instance; written to the status file for the next instance
+	double layerCostMB() const { return maxLayerCostMB; }
+	// record this instance's batch (layer range, budget and high-water mark) for the run report
+	void recordBatch(int firstLayer, int lastLayer) const;
+private:
+	double startWorkingSetMB;	// working set when the current layer began
+	double startPeakMB;			// process peak working set when the current layer began
+	double maxLayerCostMB;		// largest amount by which any single layer raised the working set above its starting value
+};
@@ -0,0 +1,366 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+platform.cpp contains the Windows and POSIX implementations of the
+path, file, process and console functions declared in platform.h
+//============================================================*/
+
+#include "platform.h"
+#include <iostream>
+#include <ctime>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <unistd.h>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <sys/wait.h>
+	#include <spawn.h>
+	#include <limits.h>
+	extern char** environ;
+#endif
+
+using namespace std;
+
+static bool interactiveMode = true;
+
+string parentFolder(const string& path)
+{
+	size_t slashPos = path.find_last_of(pathSeparators);
+	if (slashPos == string::npos) { return ""; }
+	return path.substr(0, slashPos);
+}
+
+string filenameOnly(const string& path)
+{
+	size_t slashPos = path.find_last_of(pathSeparators);
+	if (slashPos == string::npos) { return path; }
+	return path.substr(slashPos + 1);
+}
+
+string currentDirectory()
+{
+	error_code ec;
+	return fs::current_path(ec).string();
+}
+
+bool setCurrentDirectory(const string& folder)
+{
+	error_code ec;
+	fs::current_path(folder, ec);
+	return !ec;
+}
+
+string executableFolder()
+{
+#ifdef _WIN32
+	char filePath[MAX_PATH + 1] = "";
+	DWORD len = GetModuleFileNameA(NULL, filePath, MAX_PATH);
+	if (len == 0 || len >= MAX_PATH) { return currentDirectory(); }
+	return parentFolder(string(filePath, len));
+#else
+	char filePath[PATH_MAX + 1] = "";
+	ssize_t len = readlink("/proc/self/exe", filePath, PATH_MAX);
+	if (len <= 0) { return currentDirectory(); }
+	return parentFolder(string(filePath, (size_t)len));
+#endif
+}
+
+bool fileExists(const string& path)
+{
+	error_code ec;
+	return fs::is_regular_file(path, ec);
+}
+
+string matchFileCase(const string& path)
+{
+#ifdef _WIN32
+	return path;	// the Windows filesystem is not case-sensitive
+#else
+	if (fileExists(path)) { return path; }
+	string folder = parentFolder(path);
+	string name = filenameOnly(path);
+	error_code ec;
+	for (fs::directory_iterator it(folder == "" ? "." : folder, ec), end; !ec && it != end; it.increment(ec))
+	{
+		string candidate = it->path().filename().string();
+		if ((candidate.size() == name.size()) && equal(candidate.begin(), candidate.end(), name.begin(),
+			[](unsigned char a, unsigned char b) { return tolower(a) == tolower(b); })) {
+			return it->path().string();
+		}
+	}
+	return path;	// no match; the caller reports the missing file
+#endif
+}
+
+void deleteFile(const string& path)
+{
+	error_code ec;
+	fs::remove(path, ec);
+}
+
+int deleteFilesWithExtension(const string& folder, const string& extension)
+{
+	int count = 0;
+	error_code ec;
+	vector<fs::path> matches;
+	for (fs::directory_iterator p(folder.empty() ? "." : folder, ec), end; !ec && p != end; p.increment(ec))
+	{
+		if (p->path().extension() == extension) { matches.push_back(p->path()); }
+	}
+	for (size_t i = 0; i < matches.size(); i++)
+	{
+		if (fs::remove(matches[i], ec)) { count++; }
+	}
+	return count;
+}
+
+int moveFilesWithExtension(const string& folder, const string& extension, const string& destinationFolder)
+{
+	int count = 0;
+	error_code ec;
+	vector<fs::path> matches;
+	for (fs::directory_iterator p(folder.empty() ? "." : folder, ec), end; !ec && p != end; p.increment(ec))
+	{
+		if (p->path().extension() == extension) { matches.push_back(p->path()); }
+	}
+	for (size_t i = 0; i < matches.size(); i++)
+	{
+		fs::path destination = fs::path(destinationFolder) / matches[i].filename();
+		fs::rename(matches[i], destination, ec);
+		if (ec)
+		{
+			// rename fails across drives / file systems, so fall back to copy and delete
+			ec.clear();
+			fs::copy_file(matches[i], destination, fs::copy_options::overwrite_existing, ec);
+			if (!ec) { fs::remove(matches[i], ec); }
+		}
+		if (!ec) { count++; }
+	}
+	return count;
+}
+
+bool createFolder(const string& folder)
+{
+	error_code ec;
+	fs::create_directories(folder, ec);
+	return fs::is_directory(folder, ec);
+}
+
+bool deleteFolder(const string& folder)
+{
+	error_code ec;
+	fs::remove_all(folder, ec);
+	return !ec;
+}
+
+bool mappedFile::open(const string& path)
+{
+	close();
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE) { return false; }
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || (fileSize.QuadPart == 0)) {
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL) {
+		CloseHandle(file);
+		return false;
+	}
+	view = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	fileHandle = file;
+	mappingHandle = mapping;
+	length = (size_t)fileSize.QuadPart;
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) { return false; }
+	struct stat fileInfo;
+	if ((fstat(fd, &fileInfo) != 0) || (fileInfo.st_size == 0)) {
+		::close(fd);
+		return false;
+	}
+	void* mapped = mmap(NULL, (size_t)fileInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);	// the mapping keeps its own reference to the file
+	if (mapped == MAP_FAILED) { return false; }
+	madvise(mapped, (size_t)fileInfo.st_size, MADV_SEQUENTIAL);
+	view = (const char*)mapped;
+	length = (size_t)fileInfo.st_size;
+#endif
+	return true;
+}
+
+void mappedFile::close()
+{
+	if (view == nullptr) { return; }
+#ifdef _WIN32
+	UnmapViewOfFile(view);
+	CloseHandle((HANDLE)mappingHandle);
+	CloseHandle((HANDLE)fileHandle);
+	fileHandle = nullptr;
+	mappingHandle = nullptr;
+#else
+	munmap((void*)view, length);
+#endif
+	view = nullptr;
+	length = 0;
+}
+
+bool runProcess(const vector<string>& args, int& exitCode)
+{
+	exitCode = -1;
+	if (args.size() == 0) { return false; }
+#ifdef _WIN32
+	// build a command line with each argument quoted
+	string commandLine;
+	for (size_t i = 0; i < args.size(); i++)
+	{
+		commandLine += (i > 0 ? " \"" : "\"") + args[i] + "\"";
+	}
+	vector<char> cmdLine(commandLine.begin(), commandLine.end());
+	cmdLine.push_back('\0');
+
+	STARTUPINFOA si;
+	PROCESS_INFORMATION pi;
+	ZeroMemory(&si, sizeof(si));
+	si.cb = sizeof(si);
+	ZeroMemory(&pi, sizeof(pi));
+	if (!CreateProcessA(
+		NULL,			// lpApplicationName
+		&cmdLine[0],	// Command line (needs to include app path as first argument)
+		NULL,			// Process handle not inheritable
+		NULL,			// Thread handle not inheritable
+		FALSE,			// Set handle inheritance to FALSE
+		0,				// Opens file in a same window
+		NULL,			// Use parent's environment block
+		NULL,			// Use parent's starting directory
+		&si,			// Pointer to STARTUPINFO structure
+		&pi				// Pointer to PROCESS_INFORMATION structure
+		)) {
+		return false;
+	}
+	// Wait until child process exits, then check its return code
+	WaitForSingleObject(pi.hProcess, INFINITE);
+	DWORD exit_code = 0;
+	if (FALSE == GetExitCodeProcess(pi.hProcess, &exit_code))
+	{
+		cerr << "GetExitCodeProcess() failure: " << GetLastError() << "\n";
+		exit_code = (DWORD)-1;
+	}
+	CloseHandle(pi.hProcess);
+	CloseHandle(pi.hThread);
+	exitCode = (int)exit_code;
+	return true;
+#else
+	vector<char*> argv;
+	for (size_t i = 0; i < args.size(); i++) { argv.push_back(const_cast<char*>(args[i].c_str())); }
+	argv.push_back(NULL);
+	cout.flush();
+	pid_t pid;
+	if (posix_spawn(&pid, argv[0], NULL, NULL, &argv[0], environ) != 0) { return false; }
+	// Wait until child process exits, then check its return code
+	int status = 0;
+	if (waitpid(pid, &status, 0) < 0) { return true; }
+	if (WIFEXITED(status)) { exitCode = WEXITSTATUS(status); }
+	return true;	// exitCode stays -1 if the process was terminated by a signal
+#endif
+}
+
+void setInteractive(bool interactive)
+{
+	interactiveMode = interactive;
+}
+
+bool isInteractive()
+{
+	return interactiveMode;
+}
+
+void pauseForUser()
+{
+	if (!interactiveMode) { return; }
+#ifdef _WIN32
+	system("pause");
+#else
+	if (!isatty(STDIN_FILENO)) { return; }
+	cout << "Press Enter to continue . . . " << flush;
+	string line;
+	getline(cin, line);
+#endif
+}
+
+void clearConsole()
+{
+	if (!interactiveMode) { return; }
+#ifdef _WIN32
+	system("cls");
+#else
+	if (isatty(STDOUT_FILENO)) { cout << "\033[2J\033[H" << flush; }
+#endif
+}
+
+string timestampString()
+{
+	time_t now = time(0);
+	char str[26];
+#ifdef _WIN32
+	ctime_s(str, sizeof str, &now);
+#else
+	ctime_r(&now, str);
+#endif
+	return string(str);
+}
+
+consoleProgress::consoleProgress()
+{
+#ifdef _WIN32
+	CONSOLE_SCREEN_BUFFER_INFO cbsi;
+	inPlace = (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &cbsi) != 0);
+	cursorX = inPlace ? cbsi.dwCursorPosition.X : 0;
+	cursorY = inPlace ? cbsi.dwCursorPosition.Y : 0;
+#else
+	inPlace = (isatty(STDOUT_FILENO) != 0);
+#endif
+}
+
+void consoleProgress::update(const string& message)
+{
+	if (!inPlace)
+	{
+		cout << message << "\n";
+		return;
+	}
+#ifdef _WIN32
+	// write the message, then move the cursor back so that the next update overwrites it
+	cout << message << flush;
+	COORD cursorPosition = { cursorX, cursorY };
+	SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), cursorPosition);
+#else
+	// return to the start of the line and clear it before writing the message
+	cout << "\r\033[K" << message << flush;
+#endif
+}
@@ -0,0 +1,132 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+platform.h collects the operating-system specific operations used by
+createScanpaths, genLayer and genScan: paths, file and folder handling,
+launching child processes, console progress output and pauses for the
+user.  Windows builds use the Win32 API as before; other platforms
+(e.g. Linux batch nodes) use POSIX calls and std::filesystem.
+
+Pauses only wait for the user in interactive mode.  createScanpaths
+turns interactive mode off with --batch and passes --batch on to
+genLayer and genScan
+//============================================================*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Visual Studio 2015 (the .sln build) only provides the experimental filesystem library; C++17 builds use std::filesystem
+#include <filesystem>
+#if (__cplusplus >= 201703L) || (defined(_HAS_CXX17) && _HAS_CXX17)
+namespace fs = std::filesystem;
+#else
+namespace fs = std::experimental::filesystem;
+#endif
+
+using namespace std;
+
+// separator used when building paths, and the set of separators accepted when splitting them
+#ifdef _WIN32
+static const string pathSep = "\\";
+#else
+static const string pathSep = "/";
+#endif
+static const string pathSeparators = "\\/";
+
+// folder portion of a path (everything before the last separator), or "" if there is no separator
+string parentFolder(const string& path);
+
+// filename portion of a path (everything after the last separator)
+string filenameOnly(const string& path);
+
+// current working directory, and change it.  setCurrentDirectory returns false on failure
+string currentDirectory();
+bool setCurrentDirectory(const string& folder);
+
+// folder containing the running executable
+string executableFolder();
+
+// true if path names an existing file (not a folder)
+bool fileExists(const string& path);
+
+// path of an existing file whose name matches path apart from case (e.g. part.stl for Part.STL), else path itself.
+// Configuration-file entries are lower-cased when read, which only matters on case-sensitive filesystems
+string matchFileCase(const string& path);
+
+// delete a file; a missing file is not an error
+void deleteFile(const string& path);
+
+// delete or move every file in a folder with the given extension (e.g. ".svg").  Returns the number of files affected
+int deleteFilesWithExtension(const string& folder, const string& extension);
+int moveFilesWithExtension(const string& folder, const string& extension, const string& destinationFolder);
+
+// create a folder (and any missing parents), or delete a folder and everything in it.  Return false on failure
+bool createFolder(const string& folder);
+bool deleteFolder(const string& folder);
+
+// read-only view of an entire file, memory-mapped so that large files (e.g. STL meshes) are read without copying.
+// The view stays valid until close() or destruction
+class mappedFile
+{
+public:
+	mappedFile() {}
+	~mappedFile() { close(); }
+	mappedFile(const mappedFile&) = delete;
+	mappedFile& operator=(const mappedFile&) = delete;
+	bool open(const string& path);	// returns false if the file is missing, empty or can't be mapped
+	void close();
+	const char* data() const { return view; }
+	size_t size() const { return length; }
+private:
+	const char* view = nullptr;
+	size_t length = 0;
+#ifdef _WIN32
+	void* fileHandle = nullptr;		// HANDLEs, kept as void* so that windows.h isn't needed here
+	void* mappingHandle = nullptr;
+#endif
+};
+
+// launch an executable with the given arguments (args[0] is the executable path) and wait for it to finish.
+// Returns false if the process could not be started; otherwise exitCode holds its exit code (-1 if it did not exit normally)
+bool runProcess(const vector<string>& args, int& exitCode);
+
+// interactive mode (the default) lets pauseForUser wait for a key press.  Batch mode never waits
+void setInteractive(bool interactive);
+bool isInteractive();
+
+// wait for the user to press a key before continuing, in interactive mode only.  Replaces system("pause")
+void pauseForUser();
+
+// clear the console window, in interactive mode only
+void clearConsole();
+
+// current local date and time in the same form as ctime(), including the trailing newline
+string timestampString();
+
+// rewrites a single line of progress output (e.g. "Processing layer 12 of 400") in place.
+// On a console the line is overwritten on each update; when output is redirected to a file each update is a new line
+class consoleProgress
+{
+public:
+	consoleProgress();
+	void update(const string& message);
+private:
+	bool inPlace;		// true if output is a console which supports overwriting the line
+#ifdef _WIN32
+	short cursorX, cursorY;	// cursor position at which each update is written
+#endif
+};
@@ -28,6 +28,7 @@ ALSAM3024 projects.
 #include "readExcelConfig.h"
 #include "BasicExcel.hpp"
 #include "errorChecks.h"
+#include "platform.h"
 
 using namespace YExcel;
 
@@ -105,21 +106,28 @@ bool parseToBool(BasicExcelCell* unknownInput)
 	return result;
 }
 
+double parseToDouble(BasicExcelCell* unknownInput, double blankValue)
+{
+	// Parses a numeric cell value returned from BasicExcel, for optional columns.
+	// Blank cells return blankValue rather than the 0 that GetDouble() gives them
+	if ((unknownInput->Type() == BasicExcelCell::UNDEFINED) || (parseToString(unknownInput) == "")) { return blankValue; }
+	return unknownInput->GetDouble();
+}
+
 void readGeneralParameters(BasicExcelWorksheet* sheet2, AMconfig* configData, string tabName)
 {	// Read the general parameters tab of an America Makes Excel configuration file.
 	// This is called by AMconfigRead
 
 	// First determine the path of the configuration file
-	size_t slashPos = (*configData).configFilename.find_last_of("\\");
-	string path = (*configData).configFilename.substr(0, slashPos);
+	string path = parentFolder((*configData).configFilename);
 	//
 	// Read folder name and layer thickness
 	std::string folderName = sheet2->Cell(3, 2)->GetString();	// Name of the desired folder to contain both layer and scan outputs
 	// Determine the path of the configuration file, and pre-pend this to folderName
-	(*configData).projectFolder = path + "\\" + folderName;
+	(*configData).projectFolder = path + pathSep + folderName;
 	// Define layer and scan sub-folders based on folderName
-	(*configData).layerOutputFolder = (*configData).projectFolder + "\\" + "LayerFiles";
-	(*configData).scanOutputFolder  = (*configData).projectFolder + "\\" + "ScanFiles";
+	(*configData).layerOutputFolder = (*configData).projectFolder + pathSep + "LayerFiles";
+	(*configData).scanOutputFolder  = (*configData).projectFolder + pathSep + "ScanFiles";
 
 	// Read layer thickness and dosing factor
 	(*configData).layerThickness_mm = sheet2->Cell(5, 2)->GetDouble();
@@ -131,6 +139,9 @@ void readGeneralParameters(BasicExcelWorksheet* sheet2, AMconfig* configData, st
 	// Read and parse whether to create a zip file containing scan files
 	(*configData).createScanZIPfile = parseToBool(sheet2->Cell(8, 2));
 
+	// Read the optional outline simplification tolerance, in microns.  Blank = 0 = no simplification
+	(*configData).simplifyTolerance_um = sheet2->Cell(9, 2)->GetDouble();
+
 	// Read SVG output controls for layer files
 	(*configData).createLayerSVG = parseToBool(sheet2->Cell(13, 2));
 	(*configData).layerSVGinterval = sheet2->Cell(14, 2)->GetInteger();
@@ -329,6 +340,12 @@ void readRegionProfiles(BasicExcelWorksheet* sheet5, AMconfig* configData, strin
 		regionRow.scHatch = sheet5->Cell(rowNum, 11)->GetInteger();
 		regionRow.layer1hatchAngle = sheet5->Cell(rowNum, 12)->GetDouble();
 		regionRow.hatchLayerRotation = sheet5->Cell(rowNum, 13)->GetDouble();
+		// Island columns Q-S and stripe columns T-U follow the hatch-direction and note columns (O, P), which are not read
+		regionRow.islandSize = parseToDouble(sheet5->Cell(rowNum, 16), defaultIslandSize);
+		regionRow.islandRotation = sheet5->Cell(rowNum, 17)->GetDouble();
+		regionRow.islandShift = sheet5->Cell(rowNum, 18)->GetDouble();
+		regionRow.stripeWidth = parseToDouble(sheet5->Cell(rowNum, 19), defaultStripeWidth);
+		regionRow.stripeOverlap = sheet5->Cell(rowNum, 20)->GetDouble();
 		//
 		// Add this row to the region-profile structure
 		(*configData).regionProfileList.push_back(regionRow);
@@ -381,7 +398,7 @@ void readPartFiles(BasicExcelWorksheet* sheet6, AMconfig* configData, string tab
 	string temp = parseToString(sheet6->Cell(rowNum, 0));
 	while (temp != "")
 	{	// Filename is populated.  Add config-file path to filename, save it, and read the rest of the row
-		ipf.fn = (*configData).configPath + "\\" + temp;
+		ipf.fn = matchFileCase((*configData).configPath + pathSep + temp);
 		// Read part offset values
 		ipf.x_offset = sheet6->Cell(rowNum, 1)->GetDouble();
 		ipf.y_offset = sheet6->Cell(rowNum, 2)->GetDouble();
@@ -528,6 +545,35 @@ void readStripes(BasicExcelWorksheet* sheet8, AMconfig* configData, string tabNa
 	return;
 }
 
+void readLasers(BasicExcelWorksheet* sheet9, AMconfig* configData)
+{
+	// Read the optional laser list on tab 9, one laser per row starting at row 5:  laser ID, then the x min, x max,
+	// y min and y max of its reachable field in mm (a blank limit leaves the field unbounded on that side).
+	// The list ends at the first row without a laser ID
+	try {
+		int rowNum = 4;
+		string temp = parseToString(sheet9->Cell(rowNum, 0));  // column A
+		while (temp != "")
+		{
+			laserField laser;
+			laser.laserID = temp;
+			laser.xMin = parseToDouble(sheet9->Cell(rowNum, 1), laser.xMin);
+			laser.xMax = parseToDouble(sheet9->Cell(rowNum, 2), laser.xMax);
+			laser.yMin = parseToDouble(sheet9->Cell(rowNum, 3), laser.yMin);
+			laser.yMax = parseToDouble(sheet9->Cell(rowNum, 4), laser.yMax);
+			(*configData).laserList.push_back(laser);
+			rowNum += 1;
+			temp = parseToString(sheet9->Cell(rowNum, 0));	// Read next laser ID to decide whether to proceed
+		}
+	}
+	catch (...) {
+		// Lasers tab is not usable; paths keep the lasers named by their segment styles
+		(*configData).laserList.clear();
+	}
+
+	return;
+}
+
 AMconfig AMconfigRead(const std::string& configFilename)
 {
 	// Read the America Makes configuration file specified by configFilename and store in an AMconfig structure.
@@ -544,12 +590,12 @@ AMconfig AMconfigRead(const std::string& configFilename)
 	string functionWithIssue;
 	// save config filename and path in configData
 	configData.configFilename = configFilename.c_str();  // full path to the file along with the filename itself
-	size_t slashPos = configFilename.find_last_of("\\");
-	configData.configPath = configFilename.substr(0, slashPos);
+	configData.configPath = parentFolder(configFilename);
 	// try and load the file via BasicExcel
 	try {
 		bool openFileSuccess;
-		openFileSuccess = excelFile.Load(configFilename.c_str());	// load the indicated Excel file.  Note - try/catch won't properly handle a runtime error in this module
+		// memory-map the indicated Excel file and decode only the tabs in configTabNames.  Note - try/catch won't properly handle a runtime error in this module
+		openFileSuccess = excelFile.LoadWorksheets(configFilename.c_str(), configTabNames);
 		if (!openFileSuccess) {
 			errorMsg = "Unable to open the configuration file - it may be open in Excel (please close and re-try)";
 			updateErrorResults(errorData, haltNow, "AMconfigRead", errorMsg, "", configData.configFilename, configData.configPath);
@@ -681,6 +727,11 @@ AMconfig AMconfigRead(const std::string& configFilename)
 		updateErrorResults(errorData, haltNow, "AMconfigRead", errorMsg, tabName, configData.configFilename, configData.configPath);
 	}
 
+	// Read the optional laser list on tab 9.  Older config files omit this tab, which leaves laserList empty
+	tabName = configTabNames[8];
+	oneSheet = excelFile.GetWorksheet(tabName.c_str());
+	if (oneSheet != 0) { readLasers(oneSheet, &configData); }
+
 	//***********************************************************************
 	// CONFIG FILE READ COMPLETE
 	// We will not call the error check function here, because that would repeat all checks each time the file is read (every 25 genLayer/genScan iterations)
@@ -24,21 +24,18 @@ to read the Excel-based America Makes configuration input
 #include <string>
 #include <stdlib.h>
 #include <stdio.h>
-#include <msxml6.h>
-#include <comdef.h>
-#include <tchar.h>
-#include <conio.h>
 #include <sstream>
 #include <fstream>
 #include <math.h>
 #include <algorithm>
 #include <vector>
 #include <cctype>
+#include <limits>
 #include "BasicExcel.hpp"
 
 using namespace YExcel;
 
-const vector<string> configTabNames = { "1.Header", "2.General", "3.VelocityProfiles", "4.SegmentStyles", "5.Regions", "6.Parts", "7.PathProcessing", "8.Stripes" };
+const vector<string> configTabNames = { "1.Header", "2.General", "3.VelocityProfiles", "4.SegmentStyles", "5.Regions", "6.Parts", "7.PathProcessing", "8.Stripes", "9.Lasers" };
 
 // Structure to contain data on each STL file indicated in the configuration file
 struct ipFile
@@ -129,9 +126,19 @@ struct regionProfile
 	double offHatch = 0.0;		// offset of the hatches as measured from innermost contour, in um.  Positive = indented
 	double resHatch = 0.0;		// hatch center-to-center spacing (resolution) in um
 	int hatchSkywriting = 0;	// Skywriting mode for hatches.  0 = off
-	int scHatch = 0;			// hatch scheme selection.  0=basic hatching, 1=prototype optimization (minimize jumps)
+	int scHatch = 0;			// hatch scheme selection.  0=basic hatching, 1=prototype optimization (minimize jumps), 2=basic hatching clipped with Clipper,
+								//	3=prototype optimization with a refined island tour, 4=island (chessboard) hatching, 5=stripe hatching
 	double layer1hatchAngle = 0.0;	 // hatch angle to be used on layer 1 for this region
 	double hatchLayerRotation = 0.0; // incremental change in hatch angle (counter-clockwise) per layer
+	//
+	// Island parameters, used by hatch scheme 4 only.  Optional columns; a blank size reads as the default, other blank cells as 0
+	double islandSize = 0.0;		// width of the square islands, in mm.  Blank = defaultIslandSize
+	double islandRotation = 0.0;	// angle of the island grid (counter-clockwise from the x axis), in degrees
+	double islandShift = 0.0;		// distance the island grid moves along both of its axes per layer, in mm
+	//
+	// Stripe parameters, used by hatch scheme 5 only.  Optional columns; a blank width reads as the default, other blank cells as 0
+	double stripeWidth = 0.0;		// width of the stripes, measured along the hatch lines, in mm.  Blank = defaultStripeWidth
+	double stripeOverlap = 0.0;		// distance by which neighbouring stripes overlap, in mm
 };
 
 // Structure to hold definitions for trajectory processing (sequential or concurrent)
@@ -155,6 +162,19 @@ struct singleStripe
 	bool marked = false;		// if true, stripe has already been marked and can be ignored in future layers
 };
 
+// Structure to hold one laser from the optional lasers tab, for assigning the paths of concurrent trajectories.
+// The reachable field is a box on the build plate; a limit left blank is infinite, so the field is unbounded on that side
+struct laserField
+{
+	string laserID = "";	// traveler ID given to this laser's segments.  User-input string will be cast to lower case
+	double xMin = -numeric_limits<double>::infinity(), xMax = numeric_limits<double>::infinity();	// reachable x range, mm
+	double yMin = -numeric_limits<double>::infinity(), yMax = numeric_limits<double>::infinity();	// reachable y range, mm
+	bool reaches(double minX, double maxX, double minY, double maxY) const
+	{
+		return (minX >= xMin) && (maxX <= xMax) && (minY >= yMin) && (maxY <= yMax);
+	}
+};
+
 // *********************************************
 // Overall structure to store configuration data read from Excel (.xls) file.
 // The fields shown here are a subset of the entire file contents; just enough to create directories
@@ -178,6 +198,7 @@ struct AMconfig
 	double dosingFactor = 1.5;		// multiplier on layer thickness to indicate amount of powder applied to each layer
 	bool outputIntegerIDs = true;	// if true, the string ID's for Velocity Profiles and SegStyles will be replaced by auto-generated integer ID's for simplicity/consistency
 	bool createScanZIPfile = false; // if true, a zip file containing the scan XML files will be created in the SCAN folder.  NOT YET IMPLEMENTED
+	double simplifyTolerance_um = 0.0;	// genLayer removes outline vertices within this distance of the simplified outline (see simplifyLayer).  0 = off
 	//
 	bool createLayerSVG = false;	// if true, SVG files for layers will be created
 	int layerSVGinterval = -1;		// if createLayerSVG is true, this indicates the frequency of layer files.  -1=all
@@ -202,6 +223,9 @@ struct AMconfig
 	int stripeJumpSegStyleIntID = 0;// Integer ID corresponding to stripeJumpSegStyleID
 	int stripeSkywrtgMode = 0;		// Skywriting mode for stripes.  0 = off
 	vector<singleStripe> stripeList;// vector of individual line segments to be marked in addition to part files
+	//
+	// Optional laser section.  If empty, each path keeps the laser(s) named by its segment styles
+	vector<laserField> laserList;	// lasers among which genScan divides the paths of concurrent trajectories
 };
 
 // converts a string to lower case.  Used by some other routines, so called out in this header
@@ -230,5 +254,9 @@ void readTrajProcessing(BasicExcelWorksheet* sheet7, AMconfig* configData, strin
 // Otherwise, stripeList will contain one or more line-segment stripes and allStripesMarked will be false
 void readStripes(BasicExcelWorksheet* sheet8, AMconfig* configData, string tabName);
 
+// Helper function to read the optional lasers tab of an Excel configuration file.
+// If the tab is not included in the Excel file, laserList will be empty
+void readLasers(BasicExcelWorksheet* sheet9, AMconfig* configData);
+
 // Read an Excel configuration file and create an AMconfig structure
 AMconfig AMconfigRead(const std::string& configFilename);
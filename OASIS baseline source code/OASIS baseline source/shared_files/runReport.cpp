@@ -0,0 +1,238 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+runReport.cpp contains the stage timer and the functions which save
+timing samples and per-layer counts, and summarize them into the JSON
+run report (see runReport.h)
+//============================================================*/
+
+#include "runReport.h"
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+// samples recorded by this process, keyed by stage name (milliseconds per call)
+static map<string, vector<double>> stageSamples;
+// counts recorded by this process, keyed by layer number and then by counter name
+static map<int, map<string, double>> layerCounts;
+// layer batches recorded by this process: first layer, last layer, budget, high-water mark and largest layer cost
+static vector<vector<double>> layerBatches;
+
+#if STAGETIMING
+stageTimer::stageTimer(const char* stageName) : stage(stageName), start(chrono::steady_clock::now())
+{
+}
+
+stageTimer::~stageTimer()
+{
+	chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+	recordStageSample(stage, elapsed.count());
+}
+#endif
+
+void recordStageSample(const string& stageName, double milliseconds)
+{
+	stageSamples[stageName].push_back(milliseconds);
+}
+
+void recordLayerCount(int layerNum, const string& counterName, double value)
+{
+	layerCounts[layerNum][counterName] += value;
+}
+
+void recordLayerBatch(int firstLayer, int lastLayer, double budgetMB, double highWaterMB, double layerCostMB)
+{
+	layerBatches.push_back({ (double)firstLayer, (double)lastLayer, budgetMB, highWaterMB, layerCostMB });
+}
+
+bool appendRunSamples(const string& samplesFile, const string& programName)
+{
+	// one tab-separated sample per line:
+	//	S <program> <stage> <milliseconds>
+	//	L <program> <layer> <counter> <value>
+	//	B <program> <first layer> <last layer> <budget MB> <high-water MB> <layer cost MB>
+	ofstream fout(samplesFile, ios::app);
+	if (!fout.is_open()) { return false; }
+	fout << setprecision(6) << fixed;
+	for (map<string, vector<double>>::iterator st = stageSamples.begin(); st != stageSamples.end(); ++st)
+	{
+		for (size_t i = 0; i < st->second.size(); i++)
+		{
+			fout << "S\t" << programName << "\t" << st->first << "\t" << st->second[i] << "\n";
+		}
+	}
+	for (map<int, map<string, double>>::iterator ly = layerCounts.begin(); ly != layerCounts.end(); ++ly)
+	{
+		for (map<string, double>::iterator c = ly->second.begin(); c != ly->second.end(); ++c)
+		{
+			fout << "L\t" << programName << "\t" << ly->first << "\t" << c->first << "\t" << c->second << "\n";
+		}
+	}
+	for (size_t b = 0; b < layerBatches.size(); b++)
+	{
+		fout << "B\t" << programName;
+		for (size_t k = 0; k < layerBatches[b].size(); k++) { fout << "\t" << layerBatches[b][k]; }
+		fout << "\n";
+	}
+	fout.close();
+	stageSamples.clear();
+	layerCounts.clear();
+	layerBatches.clear();
+	return true;
+}
+
+// returns the p'th percentile (nearest rank) of an ascending-sorted vector
+static double percentile(const vector<double>& sorted, double p)
+{
+	if (sorted.size() == 0) { return 0.0; }
+	size_t rank = (size_t)ceil(p / 100.0 * sorted.size());
+	if (rank < 1) { rank = 1; }
+	return sorted[min(rank, sorted.size()) - 1];
+}
+
+// writes a JSON string, escaping quotes and backslashes
+static string jsonString(const string& s)
+{
+	string out = "\"";
+	for (size_t i = 0; i < s.size(); i++)
+	{
+		if (s[i] == '"' || s[i] == '\\') { out += '\\'; }
+		out += s[i];
+	}
+	return out + "\"";
+}
+
+bool writeRunReport(const string& samplesFile, const string& reportFile, const string& programName)
+{
+	// 1. Gather samples from the raw samples file (written by genLayer / genScan) and from this process
+	map<string, map<string, vector<double>>> allStages;				// program -> stage -> samples
+	map<string, map<int, map<string, double>>> allLayerCounts;		// program -> layer -> counter -> value
+	map<string, vector<vector<double>>> allBatches;					// program -> batches, in the order they ran
+	ifstream fin(samplesFile);
+	string line;
+	while (getline(fin, line))
+	{
+		istringstream ls(line);
+		string kind, program, name;
+		getline(ls, kind, '\t');
+		getline(ls, program, '\t');
+		if (kind == "S")
+		{
+			double ms;
+			getline(ls, name, '\t');
+			if (ls >> ms) { allStages[program][name].push_back(ms); }
+		}
+		else if (kind == "L")
+		{
+			int layerNum;
+			double value;
+			string layerField;
+			getline(ls, layerField, '\t');
+			getline(ls, name, '\t');
+			layerNum = atoi(layerField.c_str());
+			if (ls >> value) { allLayerCounts[program][layerNum][name] += value; }
+		}
+		else if (kind == "B")
+		{
+			vector<double> batch;
+			double value;
+			while (ls >> value) { batch.push_back(value); }
+			if (batch.size() == 5) { allBatches[program].push_back(batch); }
+		}
+	}
+	fin.close();
+	for (map<string, vector<double>>::iterator st = stageSamples.begin(); st != stageSamples.end(); ++st)
+	{
+		vector<double>& dest = allStages[programName][st->first];
+		dest.insert(dest.end(), st->second.begin(), st->second.end());
+	}
+	for (map<int, map<string, double>>::iterator ly = layerCounts.begin(); ly != layerCounts.end(); ++ly)
+	{
+		for (map<string, double>::iterator c = ly->second.begin(); c != ly->second.end(); ++c)
+		{
+			allLayerCounts[programName][ly->first][c->first] += c->second;
+		}
+	}
+
+	for (size_t b = 0; b < layerBatches.size(); b++) { allBatches[programName].push_back(layerBatches[b]); }
+
+	// 2. Write the report.  Programs, stages and counters are listed alphabetically and layers in ascending order so that reports can be compared across runs
+	ofstream fout(reportFile);
+	if (!fout.is_open()) { return false; }
+	fout << setprecision(3) << fixed;
+	fout << "{\n\t\"stages\": {";
+	for (map<string, map<string, vector<double>>>::iterator pg = allStages.begin(); pg != allStages.end(); ++pg)
+	{
+		fout << (pg == allStages.begin() ? "\n" : ",\n") << "\t\t" << jsonString(pg->first) << ": {";
+		for (map<string, vector<double>>::iterator st = pg->second.begin(); st != pg->second.end(); ++st)
+		{
+			vector<double> sorted = st->second;
+			sort(sorted.begin(), sorted.end());
+			double total = 0.0;
+			for (size_t i = 0; i < sorted.size(); i++) { total += sorted[i]; }
+			fout << (st == pg->second.begin() ? "\n" : ",\n") << "\t\t\t" << jsonString(st->first) << ": {"
+				<< "\"calls\": " << sorted.size()
+				<< ", \"total_ms\": " << total
+				<< ", \"mean_ms\": " << (sorted.size() > 0 ? total / sorted.size() : 0.0)
+				<< ", \"p50_ms\": " << percentile(sorted, 50)
+				<< ", \"p90_ms\": " << percentile(sorted, 90)
+				<< ", \"p99_ms\": " << percentile(sorted, 99)
+				<< ", \"max_ms\": " << (sorted.size() > 0 ? sorted.back() : 0.0) << "}";
+		}
+		fout << "\n\t\t}";
+	}
+	fout << "\n\t},\n\t\"layers\": {";
+	fout << setprecision(0);
+	for (map<string, map<int, map<string, double>>>::iterator pg = allLayerCounts.begin(); pg != allLayerCounts.end(); ++pg)
+	{
+		fout << (pg == allLayerCounts.begin() ? "\n" : ",\n") << "\t\t" << jsonString(pg->first) << ": [";
+		for (map<int, map<string, double>>::iterator ly = pg->second.begin(); ly != pg->second.end(); ++ly)
+		{
+			fout << (ly == pg->second.begin() ? "\n" : ",\n") << "\t\t\t{\"layer\": " << ly->first;
+			for (map<string, double>::iterator c = ly->second.begin(); c != ly->second.end(); ++c)
+			{
+				fout << ", " << jsonString(c->first) << ": " << c->second;
+			}
+			fout << "}";
+		}
+		fout << "\n\t\t]";
+	}
+	fout << "\n\t},\n\t\"batches\": {";
+	for (map<string, vector<vector<double>>>::iterator pg = allBatches.begin(); pg != allBatches.end(); ++pg)
+	{
+		fout << (pg == allBatches.begin() ? "\n" : ",\n") << "\t\t" << jsonString(pg->first) << ": [";
+		for (size_t b = 0; b < pg->second.size(); b++)
+		{
+			vector<double>& batch = pg->second[b];
+			fout << (b == 0 ? "\n" : ",\n") << setprecision(0)
+				<< "\t\t\t{\"first_layer\": " << batch[0]
+				<< ", \"last_layer\": " << batch[1]
+				<< ", \"layers\": " << batch[1] - batch[0] + 1
+				<< setprecision(1)
+				<< ", \"budget_mb\": " << batch[2]
+				<< ", \"high_water_mb\": " << batch[3]
+				<< ", \"layer_cost_mb\": " << batch[4] << "}";
+		}
+		fout << "\n\t\t]";
+	}
+	fout << "\n\t}\n}\n";
+	fout.close();
+	return !fout.fail();
+}
@@ -0,0 +1,83 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+runReport.h defines lightweight scoped stage timers and per-layer
+counters, and the functions which save them and summarize them in
+a machine-readable (JSON) run report in the project folder.  The
+report also lists each batch of layers processed by one instance of
+genLayer or genScan, with its memory budget and high-water mark.
+
+genLayer and genScan are relaunched every few layers, so each
+instance appends its raw samples to runSamplesFilename in the project
+folder; createScanpaths combines them into runReportFilename at the end
+of a run.  Set STAGETIMING to 0 to compile all instrumentation away
+//============================================================*/
+
+#pragma once
+
+// If STAGETIMING is set to 1, TIME_STAGE and COUNT_LAYER record timing samples and per-layer counts.
+// If set to 0, both macros expand to nothing and no timing code is compiled into the executables
+#define STAGETIMING 1
+
+#include <string>
+#include <vector>
+#include <chrono>
+
+using namespace std;
+
+#if STAGETIMING
+
+// times the enclosing scope and records the elapsed milliseconds as one sample of the named stage
+class stageTimer
+{
+public:
+	explicit stageTimer(const char* stageName);
+	~stageTimer();
+private:
+	const char* stage;	// stage name; must be a string literal (or otherwise outlive the timer)
+	chrono::steady_clock::time_point start;
+};
+
+#define STAGE_TIMER_CONCAT2(a, b) a##b
+#define STAGE_TIMER_CONCAT(a, b) STAGE_TIMER_CONCAT2(a, b)
+// time the rest of the enclosing scope under stageName, e.g. TIME_STAGE("hatch");
+#define TIME_STAGE(stageName) stageTimer STAGE_TIMER_CONCAT(stageTimer_, __LINE__)(stageName)
+// record a count (vertices, edges, regions, segments...) for a given layer number
+#define COUNT_LAYER(layerNum, counterName, value) recordLayerCount((layerNum), (counterName), (double)(value))
+
+#else
+
+#define TIME_STAGE(stageName)
+#define COUNT_LAYER(layerNum, counterName, value)
+
+#endif
+
+// record one timing sample (in milliseconds) for a stage.  Normally called by stageTimer
+void recordStageSample(const string& stageName, double milliseconds);
+
+// record a named count for a given layer.  Normally called via COUNT_LAYER
+void recordLayerCount(int layerNum, const string& counterName, double value);
+
+// record the layer range processed by this instance, the memory budget and the peak working set (MB), and the largest per-layer cost (MB).
+// Normally called via memoryBudget::recordBatch
+void recordLayerBatch(int firstLayer, int lastLayer, double budgetMB, double highWaterMB, double layerCostMB);
+
+// append all samples recorded by this process to the raw samples file, tagged with the program name (genLayer, genScan...),
+// then clear them.  Returns false if the file could not be written
+bool appendRunSamples(const string& samplesFile, const string& programName);
+
+// combine the raw samples file with samples recorded by this process and write the JSON run report:
+// per-stage call counts, totals and percentiles, per-layer counts and layer batches for each program.  Returns false if the report could not be written
+bool writeRunReport(const string& samplesFile, const string& reportFile, const string& programName);
@@ -0,0 +1,219 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+shardManifest.cpp writes, reads and checks the per-shard manifests
+used to split a build across machines (see shardManifest.h)
+//============================================================*/
+
+#include "shardManifest.h"
+#include "constants.h"
+#include "platform.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <map>
+#include <set>
+
+bool parseLayerRange(const string& text, int& firstLayer, int& lastLayer)
+{
+	size_t dashPos = text.find('-');
+	if ((dashPos == string::npos) || (dashPos == 0) || (dashPos == text.size() - 1)) { return false; }
+	string first = text.substr(0, dashPos);
+	string last = text.substr(dashPos + 1);
+	if ((first.find_first_not_of("0123456789") != string::npos) || (last.find_first_not_of("0123456789") != string::npos)) { return false; }
+	firstLayer = atoi(first.c_str());
+	lastLayer = atoi(last.c_str());
+	return (firstLayer >= 1) && (lastLayer >= firstLayer);
+}
+
+string shardFilename(const string& filename, const string& shardId)
+{
+	if (shardId == "") { return filename; }
+	size_t periodPos = filename.find_last_of('.');
+	if (periodPos == string::npos) { return filename + "_shard" + shardId; }
+	return filename.substr(0, periodPos) + "_shard" + shardId + filename.substr(periodPos);
+}
+
+string manifestPath(const string& outputFolder, const string& kind, const string& shardId)
+{
+	return outputFolder + pathSep + shardFolderName + pathSep + kind + "_manifest_shard" + shardId + ".txt";
+}
+
+string fileChecksum(const string& path)
+{
+	ifstream file(path, ios::binary);
+	if (!file) { return ""; }
+	unsigned long long hash = 14695981039346656037ULL;	// FNV-1a 64-bit offset basis
+	char buffer[65536];
+	while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+	{
+		streamsize n = file.gcount();
+		for (streamsize i = 0; i < n; i++)
+		{
+			hash ^= (unsigned char)buffer[i];
+			hash *= 1099511628211ULL;	// FNV-1a 64-bit prime
+		}
+	}
+	ostringstream out;
+	out << hex << setw(16) << setfill('0') << hash;
+	return out.str();
+}
+
+void startManifest(const string& path, const string& shardId, int firstLayer, int lastLayer, int totalLayers)
+{
+	createFolder(parentFolder(path));
+	ofstream out(path, ios::trunc);
+	out << "shard\t" << shardId << "\n";
+	out << "layers\t" << firstLayer << "\t" << lastLayer << "\n";
+	out << "total_layers\t" << totalLayers << "\n";
+}
+
+bool addManifestEntry(const string& path, int layer, double zHeight, const string& folder, const string& filename)
+{
+	string filePath = folder + pathSep + filename;
+	error_code ec;
+	unsigned long long bytes = fs::file_size(filePath, ec);
+	string checksum = fileChecksum(filePath);
+	if (ec || (checksum == "")) { return false; }
+	ofstream out(path, ios::app);
+	out << "layer\t" << layer << "\t" << setprecision(10) << zHeight << "\t" << filename << "\t" << bytes << "\t" << checksum << "\n";
+	return true;
+}
+
+void finishManifest(const string& path)
+{
+	ofstream out(path, ios::app);
+	out << "complete\n";
+}
+
+static shardManifest readManifest(const string& path)
+{
+	shardManifest m;
+	ifstream in(path);
+	string line, key;
+	while (getline(in, line))
+	{
+		istringstream fields(line);
+		fields >> key;
+		if (key == "shard") { fields >> m.shardId; }
+		else if (key == "layers") { fields >> m.firstLayer >> m.lastLayer; }
+		else if (key == "total_layers") { fields >> m.totalLayers; }
+		else if (key == "complete") { m.complete = true; }
+		else if (key == "layer")
+		{
+			manifestEntry e;
+			fields >> e.layer >> e.zHeight;
+			fields.ignore(1);	// filenames may contain spaces, so read up to the next tab
+			getline(fields, e.filename, '\t');
+			fields >> e.bytes >> e.checksum;
+			m.entries.push_back(e);
+		}
+	}
+	return m;
+}
+
+vector<shardManifest> readManifests(const string& outputFolder, const string& kind)
+{
+	vector<shardManifest> manifests;
+	string folder = outputFolder + pathSep + shardFolderName;
+	string prefix = kind + "_manifest_shard";
+	error_code ec;
+	for (fs::directory_iterator it(folder, ec), end; !ec && it != end; it.increment(ec))
+	{
+		string name = it->path().filename().string();
+		if ((name.compare(0, prefix.size(), prefix) == 0) && (it->path().extension() == ".txt"))
+		{
+			manifests.push_back(readManifest(it->path().string()));
+		}
+	}
+	// order by layer range so that problems are reported bottom-up
+	sort(manifests.begin(), manifests.end(), [](const shardManifest& a, const shardManifest& b) { return a.firstLayer < b.firstLayer; });
+	return manifests;
+}
+
+vector<manifestEntry> mergeManifests(const vector<shardManifest>& manifests, const string& xmlFolder, const string& prefix, vector<string>& problems)
+{
+	map<int, manifestEntry> byLayer;	// merged entries, keyed and sorted by layer number
+	map<int, string> layerShard;		// which shard produced each layer
+	if (manifests.size() == 0) { problems.push_back("No shard manifests were found"); }
+
+	for (size_t s = 0; s < manifests.size(); s++)
+	{
+		const shardManifest& m = manifests[s];
+		string shardName = "Shard " + m.shardId;
+		if (!m.complete) { problems.push_back(shardName + " has not finished (layers " + to_string(m.firstLayer) + "-" + to_string(m.lastLayer) + ")"); }
+		if (m.totalLayers != manifests[0].totalLayers) {
+			problems.push_back(shardName + " found " + to_string(m.totalLayers) + " layers in the build but shard " + manifests[0].shardId + " found " + to_string(manifests[0].totalLayers));
+		}
+		set<int> listed;
+		for (size_t e = 0; e < m.entries.size(); e++)
+		{
+			const manifestEntry& entry = m.entries[e];
+			listed.insert(entry.layer);
+			if (layerShard.count(entry.layer) > 0) {
+				problems.push_back("Layer " + to_string(entry.layer) + " was produced by both shard " + layerShard[entry.layer] + " and shard " + m.shardId);
+				continue;
+			}
+			layerShard[entry.layer] = m.shardId;
+			byLayer[entry.layer] = entry;
+
+			// the file must still be the one the shard wrote
+			string filePath = xmlFolder + pathSep + entry.filename;
+			error_code ec;
+			unsigned long long bytes = fs::file_size(filePath, ec);
+			if (ec) { problems.push_back(shardName + ": " + entry.filename + " is missing"); }
+			else if ((bytes != entry.bytes) || (fileChecksum(filePath) != entry.checksum)) {
+				problems.push_back(shardName + ": " + entry.filename + " has changed since it was written");
+			}
+		}
+		if (m.complete) {
+			for (int layer = m.firstLayer; layer <= m.lastLayer; layer++)
+			{
+				if (listed.count(layer) == 0) { problems.push_back(shardName + " does not list layer " + to_string(layer)); }
+			}
+		}
+	}
+
+	// the shards together must cover one contiguous range of layers
+	if (byLayer.size() > 0) {
+		int expected = byLayer.begin()->first;
+		for (map<int, manifestEntry>::iterator it = byLayer.begin(); it != byLayer.end(); ++it, ++expected)
+		{
+			if (it->first != expected) {
+				problems.push_back("No shard produced layers " + to_string(expected) + "-" + to_string(it->first - 1));
+				expected = it->first;
+			}
+		}
+	}
+
+	// and there should be no other numbered files in the folder (e.g. left over from an earlier run)
+	set<string> listedFiles;
+	for (map<int, manifestEntry>::iterator it = byLayer.begin(); it != byLayer.end(); ++it) { listedFiles.insert(it->second.filename); }
+	error_code ec;
+	for (fs::directory_iterator it(xmlFolder, ec), end; !ec && it != end; it.increment(ec))
+	{
+		string name = it->path().filename().string();
+		string stem = it->path().stem().string();
+		if ((it->path().extension() == ".xml") && (stem.compare(0, prefix.size(), prefix) == 0) && (stem.size() > prefix.size())
+			&& (stem.find_first_not_of("0123456789", prefix.size()) == string::npos) && (listedFiles.count(name) == 0)) {
+			problems.push_back(name + " is not listed in any shard manifest");
+		}
+	}
+
+	vector<manifestEntry> merged;
+	for (map<int, manifestEntry>::iterator it = byLayer.begin(); it != byLayer.end(); ++it) { merged.push_back(it->second); }
+	return merged;
+}
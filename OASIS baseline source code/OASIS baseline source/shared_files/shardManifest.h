@@ -0,0 +1,100 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+shardManifest.h supports splitting one build across several machines.
+Each machine runs createScanpaths with --shard <id> --layers <first>-<last>,
+and genLayer/genScan then generate only that range of layers into the
+shared layer and scan folders.  As each layer file is written, its layer
+number, z height, size and checksum are appended to a per-shard manifest
+in the "shards" subfolder of the output folder.  Shards coordinate only
+through these files, so any shared folder (or a local one) will do.
+
+createScanpaths --merge checks the manifests of all shards (complete,
+no gaps or conflicting layers, files unchanged) and then assembles
+layer_header.xml and the .scn archive.
+
+Manifests are tab-separated text:
+	shard	<id>
+	layers	<first>	<last>
+	total_layers	<n>
+	layer	<number>	<z height>	<filename>	<bytes>	<checksum>
+	...
+	complete
+//============================================================*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <climits>
+
+using namespace std;
+
+// layer range assigned to this instance.  shardId is "" for an ordinary (unsharded) run
+struct shardRange
+{
+	string shardId = "";
+	int firstLayer = 1;
+	int lastLayer = INT_MAX;
+};
+
+// parse a layer range of the form <first>-<last> (e.g. 101-200).  Returns false if text is not a valid range
+bool parseLayerRange(const string& text, int& firstLayer, int& lastLayer);
+
+// name of a per-shard working file, e.g. gl_sts.cfg becomes gl_sts_shard3.cfg for shard "3".  Unchanged for shardId ""
+string shardFilename(const string& filename, const string& shardId);
+
+// manifest file for one shard; kind is "layer" or "scan" and outputFolder is the layer or scan output folder
+string manifestPath(const string& outputFolder, const string& kind, const string& shardId);
+
+// 64-bit FNV-1a checksum of a file's contents as 16 hex digits, or "" if the file cannot be read
+string fileChecksum(const string& path);
+
+struct manifestEntry
+{
+	int layer = 0;
+	double zHeight = 0.0;
+	string filename;		// without folder
+	unsigned long long bytes = 0;
+	string checksum;
+};
+
+struct shardManifest
+{
+	string shardId;
+	int firstLayer = 0;
+	int lastLayer = -1;		// lastLayer < firstLayer for a shard whose range lies entirely above the build
+	int totalLayers = 0;	// total number of layers in the build, as seen by the shard
+	bool complete = false;	// true once every layer in the range has been written
+	vector<manifestEntry> entries;
+};
+
+// begin a new manifest for this shard (replacing any earlier one), recording its layer range
+void startManifest(const string& path, const string& shardId, int firstLayer, int lastLayer, int totalLayers);
+
+// append a layer file (located in folder) to the manifest, with its size and checksum.  Returns false if the file can't be read
+bool addManifestEntry(const string& path, int layer, double zHeight, const string& folder, const string& filename);
+
+// mark the manifest complete once the shard's last layer has been written
+void finishManifest(const string& path);
+
+// read every manifest of the given kind ("layer" or "scan") below outputFolder
+vector<shardManifest> readManifests(const string& outputFolder, const string& kind);
+
+// Check a set of manifests before merging: every shard is complete and agrees on the size of the build, each shard lists every layer in its range,
+// the shards together cover one contiguous range with no layer produced twice, every file in xmlFolder still
+// matches its size and checksum, and xmlFolder holds no other <prefix>NNN.xml files.
+// Returns the combined entries sorted by layer number; any problems found are appended to problems
+vector<manifestEntry> mergeManifests(const vector<shardManifest>& manifests, const string& xmlFolder, const string& prefix, vector<string>& problems);
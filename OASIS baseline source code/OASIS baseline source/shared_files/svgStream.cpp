@@ -0,0 +1,139 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+svgStream.cpp writes SVG documents straight to a buffered file;
+see svgStream.h
+//============================================================*/
+
+#include "svgStream.h"
+#include "constants.h"
+
+#include <cmath>
+
+svgStream::svgStream(const string &fn, int width, int height)
+{
+	scale = 1;
+	for (int d = 0; d < svgCoordPrecision; d++) { scale *= 10; }
+	out.open(fn, ios::out | ios::binary | ios::trunc);
+	pending.reserve(svgBufferSize + 256);
+	pending += "<?xml version=\"1.0\" standalone=\"no\"?>\n";
+	pending += "<svg width=\"" + to_string(width) + "px\" height=\"" + to_string(height) + "px\" xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\">\n";
+}
+
+svgStream::~svgStream()
+{
+	if (!closed) { close(); }
+}
+
+void svgStream::appendNumber(long long units)
+{
+	// digits are produced least significant first, then appended in reverse
+	char digits[32];
+	int n = 0;
+	bool negative = (units < 0);
+	if (negative) { units = -units; }
+	long long whole = units / scale;
+	long long fraction = units % scale;
+	bool anyFraction = false;
+	for (int d = 0; d < svgCoordPrecision; d++)
+	{
+		int digit = (int)(fraction % 10);
+		fraction /= 10;
+		if (anyFraction || (digit != 0))
+		{
+			digits[n++] = (char)('0' + digit);
+			anyFraction = true;
+		}
+	}
+	if (anyFraction) { digits[n++] = '.'; }
+	do
+	{
+		digits[n++] = (char)('0' + whole % 10);
+		whole /= 10;
+	} while (whole != 0);
+	if (negative) { digits[n++] = '-'; }
+	while (n > 0) { pending += digits[--n]; }
+}
+
+void svgStream::line(double x1, double y1, double x2, double y2, const string &color, double width)
+{
+	long long sx = llround(x1 * scale), sy = llround(y1 * scale);
+	long long fx = llround(x2 * scale), fy = llround(y2 * scale);
+	if ((sx == fx) && (sy == fy)) { return; }	// nothing to see at this resolution
+	long long w = llround(width * scale);
+
+	bool newSubpath = true;
+	bool newElement = false;
+	if (inPath && ((color != pathColor) || (w != pathWidth))) { endPath(); }
+	if (!inPath)
+	{
+		pending += "<path fill=\"none\" stroke=\"" + color + "\" stroke-width=\"";
+		appendNumber(w);
+		pending += "\" d=\"";
+		inPath = true;
+		pathColor = color;
+		pathWidth = w;
+		newElement = true;
+	}
+	else if ((sx == lastX) && (sy == lastY))
+	{
+		newSubpath = false;
+	}
+
+	if (newSubpath)
+	{
+		if (!newElement) { pending += '\n'; }	// one subpath per line of the file
+		pending += 'M';
+		appendNumber(sx);
+		pending += ' ';
+		appendNumber(sy);
+		pending += 'L';
+	}
+	else
+	{
+		pending += ' ';	// further points of a polyline are implicit line-to's
+	}
+	appendNumber(fx);
+	pending += ' ';
+	appendNumber(fy);
+	lastX = fx;
+	lastY = fy;
+
+	if (pending.size() >= svgBufferSize) { flush(); }
+}
+
+void svgStream::endPath()
+{
+	if (!inPath) { return; }
+	pending += "\"/>\n";
+	inPath = false;
+}
+
+void svgStream::flush()
+{
+	out.write(pending.data(), pending.size());
+	pending.clear();
+}
+
+bool svgStream::close()
+{
+	if (closed) { return !out.fail(); }
+	endPath();
+	pending += "</svg>\n";
+	flush();
+	out.close();
+	closed = true;
+	return !out.fail();
+}
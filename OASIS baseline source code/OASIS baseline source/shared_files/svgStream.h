@@ -0,0 +1,68 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+svgStream.h defines the writer used for the SVG previews of layers
+(genLayer) and scanpaths (genScan).  The document is streamed to
+disk as it is drawn rather than assembled in memory and saved at the
+end, so dense scan previews no longer need memory in proportion to
+their size.
+
+Lines are drawn as <path> elements.  A line which starts where the
+previous one ended, in the same stroke, extends that polyline; any
+other line starts a new subpath of the same element, and a change of
+stroke starts a new element.  Coordinates are rounded to
+svgCoordPrecision decimal places (see constants.h), and lines which
+round to a single point are left out
+//============================================================*/
+
+#pragma once
+
+#include <fstream>
+#include <string>
+
+using namespace std;
+
+class svgStream
+{
+public:
+	// create fn as a width x height (pixel) document, with its origin at the top left
+	svgStream(const string &fn, int width, int height);
+	~svgStream();
+
+	// false if the file could not be created or written
+	bool good() const { return out.good(); }
+
+	// draw a line from (x1, y1) to (x2, y2) in pixels, in an SVG color (e.g. "black") and stroke width
+	void line(double x1, double y1, double x2, double y2, const string &color, double width);
+
+	// end the current <path> element, so that the next line starts a new one
+	void endPath();
+
+	// finish and close the document.  Returns false if it could not be written completely
+	bool close();
+
+private:
+	ofstream out;
+	string pending;				// text not yet written to out, up to svgBufferSize bytes
+	long long scale;			// 10^svgCoordPrecision: coordinates are written in these units
+	bool inPath = false;		// a <path> element is open
+	bool closed = false;
+	string pathColor;			// stroke of the open <path>
+	long long pathWidth = 0;
+	long long lastX = 0, lastY = 0;	// end of the open polyline, in units of 1/scale pixel
+
+	void appendNumber(long long units);	// append units/scale with no trailing zeros
+	void flush();
+};
@@ -0,0 +1,130 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+traceEvents.cpp writes Chrome trace-event JSON (see traceEvents.h).
+Events are written in the JSON Array Format, in which the closing
+bracket is optional, so several processes can append to one file
+//============================================================*/
+
+#include "traceEvents.h"
+#include <fstream>
+#include <sstream>
+#include <mutex>
+#include <thread>
+#include <functional>
+#ifdef _WIN32
+#include <process.h>
+#define traceProcessId _getpid
+#else
+#include <unistd.h>
+#define traceProcessId getpid
+#endif
+
+using namespace std;
+
+// the trace file shared by all traceScope objects in this process
+static ofstream traceOut;
+static mutex traceMutex;
+
+// microseconds since the epoch, which gives all processes the same time base
+static long long traceMicroseconds(chrono::system_clock::time_point t)
+{
+	return chrono::duration_cast<chrono::microseconds>(t.time_since_epoch()).count();
+}
+
+// trace viewers expect a small integer thread id
+static unsigned int traceThreadId()
+{
+	return (unsigned int)(hash<thread::id>()(this_thread::get_id()) % 100000);
+}
+
+// writes a JSON string, escaping quotes and backslashes (Windows paths in command lines)
+static string traceString(const string& s)
+{
+	string out = "\"";
+	for (size_t i = 0; i < s.size(); i++)
+	{
+		if (s[i] == '"' || s[i] == '\\') { out += '\\'; }
+		out += s[i];
+	}
+	return out + "\"";
+}
+
+traceScope::traceScope(const char* name, const char* category, int layerNum, int trajectoryNum, const string& tag) :
+	eventName(name), eventCategory(category), layer(layerNum), trajectory(trajectoryNum), regionTag(tag), start(chrono::system_clock::now())
+{
+}
+
+void traceScope::addArg(const string& key, const string& value)
+{
+	extraArgs.push_back(make_pair(key, value));
+}
+
+traceScope::~traceScope()
+{
+	chrono::system_clock::time_point finish = chrono::system_clock::now();
+	lock_guard<mutex> lock(traceMutex);
+	if (!traceOut.is_open()) { return; }
+
+	ostringstream ev;
+	ev << "{\"name\":" << traceString(eventName) << ",\"cat\":" << traceString(eventCategory) << ",\"ph\":\"X\""
+		<< ",\"ts\":" << traceMicroseconds(start) << ",\"dur\":" << traceMicroseconds(finish) - traceMicroseconds(start)
+		<< ",\"pid\":" << traceProcessId() << ",\"tid\":" << traceThreadId() << ",\"args\":{";
+	string sep = "";
+	if (layer >= 0) { ev << sep << "\"layer\":" << layer; sep = ","; }
+	if (trajectory >= 0) { ev << sep << "\"trajectory\":" << trajectory; sep = ","; }
+	if (regionTag != "") { ev << sep << "\"tag\":" << traceString(regionTag); sep = ","; }
+	for (size_t i = 0; i < extraArgs.size(); i++)
+	{
+		ev << sep << traceString(extraArgs[i].first) << ":" << traceString(extraArgs[i].second);
+		sep = ",";
+	}
+	ev << "}},\n";
+	traceOut << ev.str();
+}
+
+// label this process in the viewer
+static void writeProcessName(const string& processName)
+{
+	traceOut << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << traceProcessId() << ",\"tid\":0,\"args\":{\"name\":" << traceString(processName) << "}},\n";
+}
+
+bool startTraceFile(const string& traceFile, const string& processName)
+{
+	lock_guard<mutex> lock(traceMutex);
+	if (traceOut.is_open()) { traceOut.close(); }
+	traceOut.open(traceFile, ios::out | ios::trunc);
+	if (!traceOut.is_open()) { return false; }
+	traceOut << "[\n";
+	writeProcessName(processName);
+	traceOut.flush();	// child processes append to the same file
+	return true;
+}
+
+bool openTraceFile(const string& traceFile, const string& processName)
+{
+	lock_guard<mutex> lock(traceMutex);
+	if (traceOut.is_open()) { traceOut.close(); }
+	traceOut.open(traceFile, ios::out | ios::app);
+	if (!traceOut.is_open()) { return false; }
+	writeProcessName(processName);
+	return true;
+}
+
+void closeTraceFile()
+{
+	lock_guard<mutex> lock(traceMutex);
+	if (traceOut.is_open()) { traceOut.close(); }
+}
@@ -0,0 +1,75 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+traceEvents.h defines an optional trace-event writer which records
+begin/end spans (per layer, per trajectory, per region group and per
+child process) in the Chrome trace-event JSON format, which can be
+opened in chrome://tracing or https://ui.perfetto.dev
+
+createScanpaths starts the trace file in the project folder; genLayer
+and genScan append their own events to it, so one file shows every
+process on a common time axis.  Set TRACEEVENTS to 0 to compile all
+tracing away
+//============================================================*/
+
+#pragma once
+
+// If TRACEEVENTS is set to 1, TRACE_SCOPE records a span for the enclosing scope in traceFilename (see constants.h).
+// Normally set TRACEEVENTS to 0; tracing every region group adds noticeable file output on large builds
+#define TRACEEVENTS 0
+
+#include <string>
+#include <vector>
+#include <chrono>
+
+using namespace std;
+
+// records one complete ("X") trace event spanning the lifetime of the object
+class traceScope
+{
+public:
+	// name and category must be string literals (or otherwise outlive the scope).  layerNum, trajectoryNum and tag are
+	// added as event arguments when set (layerNum/trajectoryNum >= 0, tag non-empty)
+	traceScope(const char* name, const char* category, int layerNum = -1, int trajectoryNum = -1, const string& tag = "");
+	~traceScope();
+	// add another string argument to the event, e.g. the command line of a child process
+	void addArg(const string& key, const string& value);
+private:
+	const char* eventName;
+	const char* eventCategory;
+	int layer;
+	int trajectory;
+	string regionTag;
+	vector<pair<string, string>> extraArgs;
+	chrono::system_clock::time_point start;
+};
+
+#if TRACEEVENTS
+#define TRACE_SCOPE_CONCAT2(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT2(a, b)
+// trace the rest of the enclosing scope, e.g. TRACE_SCOPE("hatch", "genScan", layerNum, trajectoryNum, regionTag);
+#define TRACE_SCOPE(...) traceScope TRACE_SCOPE_CONCAT(traceScope_, __LINE__)(__VA_ARGS__)
+#else
+#define TRACE_SCOPE(...)
+#endif
+
+// create (or truncate) the trace file and open it for this process.  Called once per run by createScanpaths
+bool startTraceFile(const string& traceFile, const string& processName);
+
+// open an existing trace file for appending events from this process (genLayer, genScan), and label the process
+bool openTraceFile(const string& traceFile, const string& processName);
+
+// flush and close the trace file.  Also done automatically at program exit
+void closeTraceFile();
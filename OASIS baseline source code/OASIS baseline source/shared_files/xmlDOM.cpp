@@ -0,0 +1,655 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+xmlDOM.cpp contains the portable implementation of the MSXML subset
+declared in xmlDOM.h, including the parser used by load() and the
+serializer used by save() and get_xml().  Windows builds use MSXML
+itself, so nothing here is compiled on Windows
+//============================================================*/
+
+#include "xmlDOM.h"
+
+#ifndef _WIN32
+
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+
+using namespace std;
+
+// characters are stored one byte per wchar_t, so files round-trip unchanged
+static string narrowString(const wstring& w)
+{
+	string s(w.size(), '?');
+	for (size_t i = 0; i < w.size(); i++)
+	{
+		if ((unsigned long)w[i] < 0x100) { s[i] = (char)w[i]; }
+	}
+	return s;
+}
+
+static wstring widenString(const string& s)
+{
+	wstring w(s.size(), L' ');
+	for (size_t i = 0; i < s.size(); i++) { w[i] = (wchar_t)(unsigned char)s[i]; }
+	return w;
+}
+
+BSTR SysAllocString(const wchar_t* sz)
+{
+	if (sz == NULL) { return NULL; }
+	size_t len = wcslen(sz);
+	BSTR out = new wchar_t[len + 1];
+	wmemcpy(out, sz, len + 1);
+	return out;
+}
+
+void SysFreeString(BSTR bstr)
+{
+	delete[] bstr;
+}
+
+void VariantInit(VARIANT* pvarg)
+{
+	pvarg->vt = VT_EMPTY;
+	pvarg->bstrVal = NULL;
+}
+
+HRESULT VariantClear(VARIANT* pvarg)
+{
+	if (pvarg->vt == VT_BSTR) { SysFreeString(pvarg->bstrVal); }
+	VariantInit(pvarg);
+	return S_OK;
+}
+
+HRESULT CoInitialize(void*)
+{
+	return S_OK;
+}
+
+void CoUninitialize()
+{
+}
+
+_bstr_t::_bstr_t(const wchar_t* s) : narrow(s ? narrowString(s) : string())
+{
+}
+
+static HRESULT returnString(const wstring& s, BSTR* out)
+{
+	if (out == NULL) { return E_INVALIDARG; }
+	*out = SysAllocString(s.c_str());
+	return (*out != NULL) ? S_OK : E_OUTOFMEMORY;
+}
+
+//***************************
+// nodes
+
+IXMLDOMNode::IXMLDOMNode(DOMNodeType nodeType) : type(nodeType), refCount(1)
+{
+}
+
+IXMLDOMNode::~IXMLDOMNode()
+{
+	for (size_t i = 0; i < children.size(); i++) { children[i]->Release(); }
+	for (size_t i = 0; i < attributes.size(); i++) { attributes[i]->Release(); }
+}
+
+unsigned long IXMLDOMNode::AddRef()
+{
+	return ++refCount;
+}
+
+unsigned long IXMLDOMNode::Release()
+{
+	unsigned long remaining = --refCount;
+	if (remaining == 0) { delete this; }
+	return remaining;
+}
+
+HRESULT IXMLDOMNode::appendChild(IXMLDOMNode* newChild, IXMLDOMNode** outNewChild)
+{
+	if (newChild == NULL) { return E_INVALIDARG; }
+	newChild->AddRef();
+	children.push_back(newChild);
+	if (outNewChild != NULL)
+	{
+		newChild->AddRef();
+		*outNewChild = newChild;
+	}
+	return S_OK;
+}
+
+HRESULT IXMLDOMNode::get_childNodes(IXMLDOMNodeList** childList)
+{
+	if (childList == NULL) { return E_INVALIDARG; }
+	*childList = new IXMLDOMNodeList(children);
+	return S_OK;
+}
+
+HRESULT IXMLDOMNode::get_baseName(BSTR* nameString)
+{
+	// the local name excludes any namespace prefix
+	size_t colon = name.find(L':');
+	return returnString((colon == wstring::npos) ? name : name.substr(colon + 1), nameString);
+}
+
+HRESULT IXMLDOMNode::get_text(BSTR* text)
+{
+	wstring out;
+	appendText(out);
+	return returnString(out, text);
+}
+
+HRESULT IXMLDOMNode::get_xml(BSTR* xmlString)
+{
+	wstring out;
+	writeXML(out);
+	return returnString(out, xmlString);
+}
+
+void IXMLDOMNode::appendText(wstring& out) const
+{
+	if (type == NODE_TEXT || type == NODE_CDATA_SECTION || type == NODE_ATTRIBUTE)
+	{
+		out += value;
+		return;
+	}
+	if (type == NODE_COMMENT || type == NODE_PROCESSING_INSTRUCTION) { return; }
+	for (size_t i = 0; i < children.size(); i++) { children[i]->appendText(out); }
+}
+
+static void writeEscaped(const wstring& s, bool inAttribute, wstring& out)
+{
+	for (size_t i = 0; i < s.size(); i++)
+	{
+		switch (s[i])
+		{
+		case L'&': out += L"&amp;"; break;
+		case L'<': out += L"&lt;"; break;
+		case L'>': out += L"&gt;"; break;
+		case L'"':
+			if (inAttribute) { out += L"&quot;"; }
+			else { out += s[i]; }
+			break;
+		default: out += s[i];
+		}
+	}
+}
+
+void IXMLDOMNode::writeXML(wstring& out) const
+{
+	switch (type)
+	{
+	case NODE_TEXT:
+		writeEscaped(value, false, out);
+		break;
+	case NODE_CDATA_SECTION:
+		out += L"<![CDATA[" + value + L"]]>";
+		break;
+	case NODE_COMMENT:
+		out += L"<!--" + value + L"-->";
+		break;
+	case NODE_PROCESSING_INSTRUCTION:
+		if (name == L"xml")
+		{
+			// MSXML writes the declaration's pseudo-attributes with double quotes
+			wstring declaration = value;
+			replace(declaration.begin(), declaration.end(), L'\'', L'"');
+			out += L"<?" + name + L" " + declaration + L"?>";
+		}
+		else { out += L"<?" + name + L" " + value + L"?>"; }
+		break;
+	case NODE_ATTRIBUTE:
+		out += name + L"=\"";
+		writeEscaped(value, true, out);
+		out += L"\"";
+		break;
+	case NODE_ELEMENT:
+		out += L"<" + name;
+		for (size_t i = 0; i < attributes.size(); i++)
+		{
+			out += L" ";
+			attributes[i]->writeXML(out);
+		}
+		if (children.size() == 0)
+		{
+			out += L"/>";
+			break;
+		}
+		out += L">";
+		for (size_t i = 0; i < children.size(); i++) { children[i]->writeXML(out); }
+		out += L"</" + name + L">";
+		break;
+	case NODE_DOCUMENT:
+		// as with MSXML, top-level nodes (declaration, comments, root element) are written without separators
+		for (size_t i = 0; i < children.size(); i++) { children[i]->writeXML(out); }
+		break;
+	default:
+		for (size_t i = 0; i < children.size(); i++) { children[i]->writeXML(out); }
+	}
+}
+
+HRESULT IXMLDOMAttribute::put_value(VARIANT attributeValue)
+{
+	if (attributeValue.vt != VT_BSTR) { return E_INVALIDARG; }
+	value = attributeValue.bstrVal ? attributeValue.bstrVal : L"";
+	return S_OK;
+}
+
+HRESULT IXMLDOMElement::setAttributeNode(IXMLDOMAttribute* DOMAttribute, IXMLDOMAttribute** attributeNode)
+{
+	if (DOMAttribute == NULL) { return E_INVALIDARG; }
+	if (attributeNode != NULL) { *attributeNode = NULL; }
+	// replace any existing attribute of the same name
+	for (size_t i = 0; i < attributes.size(); i++)
+	{
+		if (attributes[i]->name == DOMAttribute->name)
+		{
+			attributes[i]->Release();
+			attributes.erase(attributes.begin() + i);
+			break;
+		}
+	}
+	DOMAttribute->AddRef();
+	attributes.push_back(DOMAttribute);
+	return S_OK;
+}
+
+//***************************
+// node lists and parse errors
+
+IXMLDOMNodeList::IXMLDOMNodeList(const vector<IXMLDOMNode*>& nodes) : items(nodes), cursor(0), refCount(1)
+{
+	for (size_t i = 0; i < items.size(); i++) { items[i]->AddRef(); }
+}
+
+IXMLDOMNodeList::~IXMLDOMNodeList()
+{
+	for (size_t i = 0; i < items.size(); i++) { items[i]->Release(); }
+}
+
+unsigned long IXMLDOMNodeList::AddRef()
+{
+	return ++refCount;
+}
+
+unsigned long IXMLDOMNodeList::Release()
+{
+	unsigned long remaining = --refCount;
+	if (remaining == 0) { delete this; }
+	return remaining;
+}
+
+HRESULT IXMLDOMNodeList::get_item(long index, IXMLDOMNode** listItem)
+{
+	if (listItem == NULL) { return E_INVALIDARG; }
+	if (index < 0 || (size_t)index >= items.size())
+	{
+		*listItem = NULL;
+		return S_FALSE;
+	}
+	items[index]->AddRef();
+	*listItem = items[index];
+	return S_OK;
+}
+
+HRESULT IXMLDOMNodeList::get_length(long* listLength)
+{
+	if (listLength == NULL) { return E_INVALIDARG; }
+	*listLength = (long)items.size();
+	return S_OK;
+}
+
+HRESULT IXMLDOMNodeList::nextNode(IXMLDOMNode** nextItem)
+{
+	if (nextItem == NULL) { return E_INVALIDARG; }
+	if (cursor >= items.size())
+	{
+		*nextItem = NULL;
+		return S_FALSE;
+	}
+	items[cursor]->AddRef();
+	*nextItem = items[cursor++];
+	return S_OK;
+}
+
+HRESULT IXMLDOMNodeList::reset()
+{
+	cursor = 0;
+	return S_OK;
+}
+
+unsigned long IXMLDOMParseError::Release()
+{
+	unsigned long remaining = --refCount;
+	if (remaining == 0) { delete this; }
+	return remaining;
+}
+
+HRESULT IXMLDOMParseError::get_reason(BSTR* reasonString)
+{
+	return returnString(reason, reasonString);
+}
+
+//***************************
+// documents
+
+HRESULT createDOMDocument(IXMLDOMDocument** ppDoc)
+{
+	if (ppDoc == NULL) { return E_INVALIDARG; }
+	*ppDoc = new IXMLDOMDocument();
+	return S_OK;
+}
+
+HRESULT IXMLDOMDocument::createElement(BSTR tagName, IXMLDOMElement** element)
+{
+	*element = new IXMLDOMElement();
+	(*element)->name = tagName;
+	return S_OK;
+}
+
+HRESULT IXMLDOMDocument::createTextNode(BSTR data, IXMLDOMText** text)
+{
+	*text = new IXMLDOMText();
+	(*text)->value = data;
+	return S_OK;
+}
+
+HRESULT IXMLDOMDocument::createComment(BSTR data, IXMLDOMComment** comment)
+{
+	*comment = new IXMLDOMComment();
+	(*comment)->value = data;
+	return S_OK;
+}
+
+HRESULT IXMLDOMDocument::createCDATASection(BSTR data, IXMLDOMCDATASection** cdata)
+{
+	*cdata = new IXMLDOMCDATASection();
+	(*cdata)->value = data;
+	return S_OK;
+}
+
+HRESULT IXMLDOMDocument::createProcessingInstruction(BSTR target, BSTR data, IXMLDOMProcessingInstruction** pi)
+{
+	*pi = new IXMLDOMProcessingInstruction();
+	(*pi)->name = target;
+	(*pi)->value = data;
+	return S_OK;
+}
+
+HRESULT IXMLDOMDocument::createAttribute(BSTR name, IXMLDOMAttribute** attribute)
+{
+	*attribute = new IXMLDOMAttribute();
+	(*attribute)->name = name;
+	return S_OK;
+}
+
+HRESULT IXMLDOMDocument::get_documentElement(IXMLDOMElement** DOMElement)
+{
+	if (DOMElement == NULL) { return E_INVALIDARG; }
+	*DOMElement = NULL;
+	for (size_t i = 0; i < children.size(); i++)
+	{
+		if (children[i]->type == NODE_ELEMENT)
+		{
+			children[i]->AddRef();
+			*DOMElement = static_cast<IXMLDOMElement*>(children[i]);
+			return S_OK;
+		}
+	}
+	return S_FALSE;
+}
+
+HRESULT IXMLDOMDocument::get_parseError(IXMLDOMParseError** errorObj)
+{
+	if (errorObj == NULL) { return E_INVALIDARG; }
+	*errorObj = new IXMLDOMParseError(parseErrorReason);
+	return S_OK;
+}
+
+// recursive-descent parser over the whole file.  Whitespace inside elements is kept as text nodes, as with preserveWhiteSpace
+class xmlParser
+{
+public:
+	xmlParser(const wstring& text) : s(text), pos(0) {}
+	bool parseDocument(IXMLDOMDocument* doc);
+	wstring error;
+private:
+	const wstring& s;
+	size_t pos;
+	bool startsWith(const wchar_t* token) const { return s.compare(pos, wcslen(token), token) == 0; }
+	bool fail(const wstring& why) { error = why + L" at character " + to_wstring(pos); return false; }
+	void skipWhitespace() { while (pos < s.size() && iswspace(s[pos])) { pos++; } }
+	bool readUntil(const wchar_t* terminator, wstring& out);
+	bool readName(wstring& out);
+	wstring decodeEntities(const wstring& raw);
+	bool parseMarkup(IXMLDOMNode* parent);		// comment, PI or CDATA at pos
+	bool parseElement(IXMLDOMNode* parent);
+};
+
+bool xmlParser::readUntil(const wchar_t* terminator, wstring& out)
+{
+	size_t end = s.find(terminator, pos);
+	if (end == wstring::npos) { return fail(L"Unterminated markup"); }
+	out = s.substr(pos, end - pos);
+	pos = end + wcslen(terminator);
+	return true;
+}
+
+bool xmlParser::readName(wstring& out)
+{
+	size_t start = pos;
+	while (pos < s.size() && !iswspace(s[pos]) && s[pos] != L'>' && s[pos] != L'/' && s[pos] != L'=' && s[pos] != L'?') { pos++; }
+	out = s.substr(start, pos - start);
+	return (out.size() > 0) ? true : fail(L"Expected a name");
+}
+
+wstring xmlParser::decodeEntities(const wstring& raw)
+{
+	if (raw.find(L'&') == wstring::npos) { return raw; }
+	wstring out;
+	for (size_t i = 0; i < raw.size(); i++)
+	{
+		if (raw[i] != L'&') { out += raw[i]; continue; }
+		size_t semi = raw.find(L';', i);
+		if (semi == wstring::npos) { out += raw[i]; continue; }
+		wstring entity = raw.substr(i + 1, semi - i - 1);
+		if (entity == L"lt") { out += L'<'; }
+		else if (entity == L"gt") { out += L'>'; }
+		else if (entity == L"amp") { out += L'&'; }
+		else if (entity == L"quot") { out += L'"'; }
+		else if (entity == L"apos") { out += L'\''; }
+		else if (entity.size() > 1 && entity[0] == L'#')
+		{
+			bool hex = (entity[1] == L'x' || entity[1] == L'X');
+			out += (wchar_t)wcstol(entity.c_str() + (hex ? 2 : 1), NULL, hex ? 16 : 10);
+		}
+		else { out += raw.substr(i, semi - i + 1); }
+		i = semi;
+	}
+	return out;
+}
+
+bool xmlParser::parseMarkup(IXMLDOMNode* parent)
+{
+	wstring body;
+	if (startsWith(L"<!--"))
+	{
+		pos += 4;
+		if (!readUntil(L"-->", body)) { return false; }
+		IXMLDOMComment* comment = new IXMLDOMComment();
+		comment->value = body;
+		parent->children.push_back(comment);
+	}
+	else if (startsWith(L"<![CDATA["))
+	{
+		pos += 9;
+		if (!readUntil(L"]]>", body)) { return false; }
+		IXMLDOMCDATASection* cdata = new IXMLDOMCDATASection();
+		cdata->value = body;
+		parent->children.push_back(cdata);
+	}
+	else if (startsWith(L"<?"))
+	{
+		pos += 2;
+		if (!readUntil(L"?>", body)) { return false; }
+		size_t split = body.find_first_of(L" \t\r\n");
+		IXMLDOMProcessingInstruction* pi = new IXMLDOMProcessingInstruction();
+		pi->name = body.substr(0, split);
+		if (split != wstring::npos)
+		{
+			size_t dataStart = body.find_first_not_of(L" \t\r\n", split);
+			if (dataStart != wstring::npos) { pi->value = body.substr(dataStart); }
+		}
+		parent->children.push_back(pi);
+	}
+	else if (startsWith(L"<!"))
+	{
+		// DOCTYPE or other declaration; not kept
+		pos += 2;
+		if (!readUntil(L">", body)) { return false; }
+	}
+	return true;
+}
+
+bool xmlParser::parseElement(IXMLDOMNode* parent)
+{
+	pos++;	// skip '<'
+	IXMLDOMElement* element = new IXMLDOMElement();
+	parent->children.push_back(element);
+	if (!readName(element->name)) { return false; }
+
+	// attributes
+	while (true)
+	{
+		skipWhitespace();
+		if (pos >= s.size()) { return fail(L"Unexpected end of file in <" + element->name + L">"); }
+		if (startsWith(L"/>")) { pos += 2; return true; }
+		if (s[pos] == L'>') { pos++; break; }
+		IXMLDOMAttribute* attribute = new IXMLDOMAttribute();
+		element->attributes.push_back(attribute);
+		if (!readName(attribute->name)) { return false; }
+		skipWhitespace();
+		if (pos >= s.size() || s[pos] != L'=') { return fail(L"Expected '=' after attribute " + attribute->name); }
+		pos++;
+		skipWhitespace();
+		if (pos >= s.size() || (s[pos] != L'"' && s[pos] != L'\'')) { return fail(L"Expected a quoted value for attribute " + attribute->name); }
+		wchar_t quote[2] = { s[pos++], 0 };
+		wstring raw;
+		if (!readUntil(quote, raw)) { return false; }
+		attribute->value = decodeEntities(raw);
+	}
+
+	// content up to the matching end tag
+	while (pos < s.size())
+	{
+		if (s[pos] != L'<')
+		{
+			size_t next = s.find(L'<', pos);
+			if (next == wstring::npos) { next = s.size(); }
+			IXMLDOMText* text = new IXMLDOMText();
+			text->value = decodeEntities(s.substr(pos, next - pos));
+			element->children.push_back(text);
+			pos = next;
+		}
+		else if (startsWith(L"</"))
+		{
+			pos += 2;
+			wstring endName;
+			if (!readName(endName)) { return false; }
+			if (endName != element->name) { return fail(L"End tag </" + endName + L"> does not match <" + element->name + L">"); }
+			skipWhitespace();
+			if (pos >= s.size() || s[pos] != L'>') { return fail(L"Expected '>'"); }
+			pos++;
+			return true;
+		}
+		else if (startsWith(L"<!") || startsWith(L"<?"))
+		{
+			if (!parseMarkup(element)) { return false; }
+		}
+		else if (!parseElement(element)) { return false; }
+	}
+	return fail(L"Missing end tag for <" + element->name + L">");
+}
+
+bool xmlParser::parseDocument(IXMLDOMDocument* doc)
+{
+	if (startsWith(L"\xEF\xBB\xBF")) { pos += 3; }	// UTF-8 byte order mark
+	bool rootFound = false;
+	while (true)
+	{
+		skipWhitespace();	// whitespace outside the root element is not kept
+		if (pos >= s.size()) { break; }
+		if (s[pos] != L'<') { return fail(L"Text outside the root element"); }
+		if (startsWith(L"<!") || startsWith(L"<?"))
+		{
+			if (!parseMarkup(doc)) { return false; }
+		}
+		else
+		{
+			if (rootFound) { return fail(L"Only one top level element is allowed"); }
+			if (!parseElement(doc)) { return false; }
+			rootFound = true;
+		}
+	}
+	return rootFound ? true : fail(L"No root element");
+}
+
+HRESULT IXMLDOMDocument::load(VARIANT xmlSource, VARIANT_BOOL* isSuccessful)
+{
+	*isSuccessful = VARIANT_FALSE;
+	if (xmlSource.vt != VT_BSTR || xmlSource.bstrVal == NULL) { return E_INVALIDARG; }
+	// discard any previous contents
+	for (size_t i = 0; i < children.size(); i++) { children[i]->Release(); }
+	children.clear();
+
+	string filename = narrowString(xmlSource.bstrVal);
+	ifstream fin(filename.c_str(), ios::binary);
+	if (!fin)
+	{
+		parseErrorReason = L"The system cannot locate the object specified.";
+		return S_FALSE;
+	}
+	ostringstream contents;
+	contents << fin.rdbuf();
+	wstring text = widenString(contents.str());
+	xmlParser parser(text);
+	if (!parser.parseDocument(this))
+	{
+		parseErrorReason = parser.error;
+		for (size_t i = 0; i < children.size(); i++) { children[i]->Release(); }
+		children.clear();
+		return S_FALSE;
+	}
+	parseErrorReason = L"";
+	*isSuccessful = VARIANT_TRUE;
+	return S_OK;
+}
+
+HRESULT IXMLDOMDocument::save(VARIANT destination)
+{
+	if (destination.vt != VT_BSTR || destination.bstrVal == NULL) { return E_INVALIDARG; }
+	wstring out;
+	writeXML(out);
+	ofstream fout(narrowString(destination.bstrVal).c_str(), ios::binary);
+	if (!fout) { return E_FAIL; }
+	fout << narrowString(out);
+	fout.close();
+	return fout.fail() ? E_FAIL : S_OK;
+}
+
+#endif
@@ -0,0 +1,191 @@
+/*============================================================//
+Copyright (c) 2020 America Makes
+All rights reserved
+Created under ALSAM project 3024
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================*/
+
+/*============================================================//
+xmlDOM.h provides the XML Domain Object Model used to read and write
+layer and scan files.  On Windows this is MSXML 6.0 (msxml6.h).  Other
+platforms get a small portable implementation of the same interfaces,
+limited to the calls made by writeLayerXML, readLayerXML and
+writeScanXML, so the XML code itself is shared by all platforms.
+
+The portable version follows the COM conventions of MSXML: objects are
+reference counted (Release), strings are BSTRs allocated with
+SysAllocString, and methods return HRESULT codes
+//============================================================*/
+
+#pragma once
+
+#ifdef _WIN32
+
+#include <windows.h>
+#include <msxml6.h>
+#include <comdef.h>
+
+#else
+
+#include <string>
+#include <vector>
+#include <cwchar>
+
+// COM types and result codes
+typedef long HRESULT;
+typedef wchar_t* BSTR;
+typedef const wchar_t* PCWSTR;
+typedef const wchar_t* LPCWSTR;
+typedef const char* LPCSTR;
+typedef short VARIANT_BOOL;
+
+#define S_OK			((HRESULT)0)
+#define S_FALSE			((HRESULT)1)
+#define E_FAIL			((HRESULT)0x80004005L)
+#define E_INVALIDARG	((HRESULT)0x80070057L)
+#define E_OUTOFMEMORY	((HRESULT)0x8007000EL)
+#define SUCCEEDED(hr)	(((HRESULT)(hr)) >= 0)
+#define FAILED(hr)		(((HRESULT)(hr)) < 0)
+#define VARIANT_TRUE	((VARIANT_BOOL)-1)
+#define VARIANT_FALSE	((VARIANT_BOOL)0)
+
+// a VARIANT here only ever holds a string
+enum VARENUM { VT_EMPTY = 0, VT_BSTR = 8 };
+struct VARIANT
+{
+	unsigned short vt;
+	BSTR bstrVal;
+};
+#define V_VT(v)		((v)->vt)
+#define V_BSTR(v)	((v)->bstrVal)
+
+BSTR SysAllocString(const wchar_t* sz);
+void SysFreeString(BSTR bstr);
+void VariantInit(VARIANT* pvarg);
+HRESULT VariantClear(VARIANT* pvarg);
+HRESULT CoInitialize(void* pvReserved);
+void CoUninitialize();
+
+// narrow-string view of a BSTR, as provided by comdef.h.  Characters above 0xFF become '?'
+class _bstr_t
+{
+public:
+	_bstr_t(const wchar_t* s);
+	operator const char*() const { return narrow.c_str(); }
+	operator char*() { return &narrow[0]; }
+private:
+	std::string narrow;
+};
+
+enum DOMNodeType { NODE_ELEMENT = 1, NODE_ATTRIBUTE = 2, NODE_TEXT = 3, NODE_CDATA_SECTION = 4, NODE_PROCESSING_INSTRUCTION = 7, NODE_COMMENT = 8, NODE_DOCUMENT = 9, NODE_DOCUMENT_FRAGMENT = 11 };
+
+class IXMLDOMNodeList;
+
+// every node type shares this implementation; the derived interfaces only add their own methods
+class IXMLDOMNode
+{
+public:
+	explicit IXMLDOMNode(DOMNodeType nodeType);
+	virtual ~IXMLDOMNode();
+	unsigned long AddRef();
+	unsigned long Release();
+	HRESULT appendChild(IXMLDOMNode* newChild, IXMLDOMNode** outNewChild);
+	HRESULT get_childNodes(IXMLDOMNodeList** childList);
+	HRESULT get_baseName(BSTR* nameString);
+	HRESULT get_text(BSTR* text);
+	HRESULT get_xml(BSTR* xmlString);
+
+	DOMNodeType type;
+	std::wstring name;		// element, attribute or processing-instruction target name
+	std::wstring value;		// text, comment, CDATA, attribute value or processing-instruction data
+	std::vector<IXMLDOMNode*> children;		// each child holds one reference
+	std::vector<IXMLDOMNode*> attributes;	// each attribute holds one reference
+	void writeXML(std::wstring& out) const;
+	void appendText(std::wstring& out) const;
+private:
+	unsigned long refCount;
+};
+
+class IXMLDOMAttribute : public IXMLDOMNode
+{
+public:
+	IXMLDOMAttribute() : IXMLDOMNode(NODE_ATTRIBUTE) {}
+	HRESULT put_value(VARIANT attributeValue);
+};
+
+class IXMLDOMElement : public IXMLDOMNode
+{
+public:
+	IXMLDOMElement() : IXMLDOMNode(NODE_ELEMENT) {}
+	HRESULT setAttributeNode(IXMLDOMAttribute* DOMAttribute, IXMLDOMAttribute** attributeNode);
+};
+
+class IXMLDOMText : public IXMLDOMNode { public: IXMLDOMText() : IXMLDOMNode(NODE_TEXT) {} };
+class IXMLDOMCDATASection : public IXMLDOMNode { public: IXMLDOMCDATASection() : IXMLDOMNode(NODE_CDATA_SECTION) {} };
+class IXMLDOMComment : public IXMLDOMNode { public: IXMLDOMComment() : IXMLDOMNode(NODE_COMMENT) {} };
+class IXMLDOMProcessingInstruction : public IXMLDOMNode { public: IXMLDOMProcessingInstruction() : IXMLDOMNode(NODE_PROCESSING_INSTRUCTION) {} };
+class IXMLDOMDocumentFragment : public IXMLDOMNode { public: IXMLDOMDocumentFragment() : IXMLDOMNode(NODE_DOCUMENT_FRAGMENT) {} };
+
+// snapshot of a node's children, with the cursor used by nextNode
+class IXMLDOMNodeList
+{
+public:
+	explicit IXMLDOMNodeList(const std::vector<IXMLDOMNode*>& nodes);
+	~IXMLDOMNodeList();
+	unsigned long AddRef();
+	unsigned long Release();
+	HRESULT get_item(long index, IXMLDOMNode** listItem);
+	HRESULT get_length(long* listLength);
+	HRESULT nextNode(IXMLDOMNode** nextItem);
+	HRESULT reset();
+private:
+	std::vector<IXMLDOMNode*> items;
+	size_t cursor;
+	unsigned long refCount;
+};
+
+class IXMLDOMParseError
+{
+public:
+	explicit IXMLDOMParseError(const std::wstring& why) : reason(why), refCount(1) {}
+	unsigned long Release();
+	HRESULT get_reason(BSTR* reasonString);
+private:
+	std::wstring reason;
+	unsigned long refCount;
+};
+
+class IXMLDOMDocument : public IXMLDOMNode
+{
+public:
+	IXMLDOMDocument() : IXMLDOMNode(NODE_DOCUMENT) {}
+	HRESULT put_async(VARIANT_BOOL) { return S_OK; }
+	HRESULT put_validateOnParse(VARIANT_BOOL) { return S_OK; }
+	HRESULT put_resolveExternals(VARIANT_BOOL) { return S_OK; }
+	HRESULT put_preserveWhiteSpace(VARIANT_BOOL) { return S_OK; }	// whitespace is always preserved
+	HRESULT createElement(BSTR tagName, IXMLDOMElement** element);
+	HRESULT createTextNode(BSTR data, IXMLDOMText** text);
+	HRESULT createComment(BSTR data, IXMLDOMComment** comment);
+	HRESULT createCDATASection(BSTR data, IXMLDOMCDATASection** cdata);
+	HRESULT createProcessingInstruction(BSTR target, BSTR data, IXMLDOMProcessingInstruction** pi);
+	HRESULT createAttribute(BSTR name, IXMLDOMAttribute** attribute);
+	HRESULT get_documentElement(IXMLDOMElement** DOMElement);
+	HRESULT get_parseError(IXMLDOMParseError** errorObj);
+	// load replaces the document's contents with the parsed file; save writes the document to a file
+	HRESULT load(VARIANT xmlSource, VARIANT_BOOL* isSuccessful);
+	HRESULT save(VARIANT destination);
+private:
+	std::wstring parseErrorReason;
+};
+
+// creates an empty document; replaces CoCreateInstance(__uuidof(DOMDocument60), ...)
+HRESULT createDOMDocument(IXMLDOMDocument** ppDoc);
+
+#endif